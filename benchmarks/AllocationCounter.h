@@ -0,0 +1,10 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+// AABench replaces the global operator new to count heap allocations,
+// e.g. to report the allocations per physics tick.
+size_t getNumAllocations();
+
+#endif
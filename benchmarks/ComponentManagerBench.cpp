@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/make_shared.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/ref.hpp>
+
+#include "common/ComponentManager.h"
+#include "common/GameEvents.h"
+#include "common/components/CompPosition.h"
+#include "common/components/CompVariable.h"
+
+namespace {
+
+// state.range(0) entities, each with a position and two variables ("a" and "b")
+class ComponentManagerFixture : public benchmark::Fixture
+{
+public:
+    void SetUp(const benchmark::State& state)
+    {
+        compMgr.reset(new ComponentManager(events));
+        entityIds.clear();
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            std::ostringstream id;
+            id << "Entity" << i;
+            ComponentList components;
+            components.push_back(boost::make_shared<CompPosition>("", boost::ref(events)));
+            components.push_back(boost::make_shared<CompVariable>("a", boost::ref(events)));
+            components.push_back(boost::make_shared<CompVariable>("b", boost::ref(events)));
+            compMgr->addEntity(id.str(), components);
+            entityIds.push_back(id.str());
+        }
+    }
+
+    void TearDown(const benchmark::State&)
+    {
+        compMgr.reset();
+    }
+
+    GameEvents events;
+    boost::scoped_ptr<ComponentManager> compMgr;
+    std::vector<EntityId> entityIds;
+};
+
+}
+
+BENCHMARK_DEFINE_F(ComponentManagerFixture, GetComponentById)(benchmark::State& state)
+{
+    for (auto _ : state)
+        for (size_t i = 0; i < entityIds.size(); ++i)
+            benchmark::DoNotOptimize(compMgr->getComponent<CompPosition>(entityIds[i]));
+    state.SetItemsProcessed(state.iterations() * entityIds.size());
+}
+BENCHMARK_REGISTER_F(ComponentManagerFixture, GetComponentById)->Arg(16)->Arg(1024);
+
+BENCHMARK_DEFINE_F(ComponentManagerFixture, GetNamedComponentById)(benchmark::State& state)
+{
+    for (auto _ : state)
+        for (size_t i = 0; i < entityIds.size(); ++i)
+            benchmark::DoNotOptimize(compMgr->getComponent<CompVariable>(entityIds[i], "b"));
+    state.SetItemsProcessed(state.iterations() * entityIds.size());
+}
+BENCHMARK_REGISTER_F(ComponentManagerFixture, GetNamedComponentById)->Arg(16)->Arg(1024);
+
+BENCHMARK_DEFINE_F(ComponentManagerFixture, GetComponentByHandle)(benchmark::State& state)
+{
+    std::vector<EntityHandle> handles;
+    for (size_t i = 0; i < entityIds.size(); ++i)
+        handles.push_back(compMgr->getEntityHandle(entityIds[i]));
+    for (auto _ : state)
+        for (size_t i = 0; i < handles.size(); ++i)
+            benchmark::DoNotOptimize(compMgr->getComponent<CompPosition>(handles[i]));
+    state.SetItemsProcessed(state.iterations() * handles.size());
+}
+BENCHMARK_REGISTER_F(ComponentManagerFixture, GetComponentByHandle)->Arg(16)->Arg(1024);
+
+BENCHMARK_DEFINE_F(ComponentManagerFixture, GetComponents)(benchmark::State& state)
+{
+    for (auto _ : state)
+        for (size_t i = 0; i < entityIds.size(); ++i)
+            benchmark::DoNotOptimize(compMgr->getComponents<CompVariable>(entityIds[i]));
+    state.SetItemsProcessed(state.iterations() * entityIds.size());
+}
+BENCHMARK_REGISTER_F(ComponentManagerFixture, GetComponents)->Arg(16)->Arg(1024);
+
+BENCHMARK_DEFINE_F(ComponentManagerFixture, IterateComponentPool)(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        const ComponentPool& pool = compMgr->getComponentPool<CompVariable>();
+        int sum = 0;
+        for (size_t i = 0; i < pool.size(); ++i)
+            sum += static_cast<CompVariable*>(pool[i])->getValue();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * entityIds.size());
+}
+BENCHMARK_REGISTER_F(ComponentManagerFixture, IterateComponentPool)->Arg(16)->Arg(1024);
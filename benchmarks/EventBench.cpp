@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <boost/bind.hpp>
+
+#include "common/Event.h"
+
+namespace {
+
+void addToCounter(int* counter, int value)
+{
+    *counter += value;
+}
+
+}
+
+// fire an event with state.range(0) listeners
+static void Event1_Fire(benchmark::State& state)
+{
+    Event1<int> event;
+    int counter = 0;
+    std::vector<EventConnection> connections;
+    for (int i = 0; i < state.range(0); ++i)
+        connections.push_back(event.registerListener(boost::bind(&addToCounter, &counter, _1)));
+
+    for (auto _ : state)
+        event.fire(1);
+
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Event1_Fire)->Arg(1)->Arg(8)->Arg(64)->Arg(512);
+
+// register and unregister a listener (done for every new component)
+static void Event1_RegisterUnregister(benchmark::State& state)
+{
+    Event1<int> event;
+    int counter = 0;
+    for (auto _ : state)
+    {
+        EventConnection connection = event.registerListener(boost::bind(&addToCounter, &counter, _1));
+        benchmark::DoNotOptimize(connection);
+    }
+}
+BENCHMARK(Event1_RegisterUnregister);
@@ -0,0 +1,160 @@
+#include <benchmark/benchmark.h>
+#include <string>
+
+#include "AllocationCounter.h"
+
+#include "common/ComponentManager.h"
+#include "common/DataLoader.h"
+#include "common/Exception.h"
+#include "common/GameEvents.h"
+#include "common/LevelSnapshot.h"
+#include "common/Physics.h"
+#include "common/components/CompPhysics.h"
+
+// The level benchmarks need the working directory to be the top directory (like AATest).
+
+namespace {
+
+const char* const cPlayerFileName = "data/player.info";
+
+// a level loaded into a physics world, like in PlayingState
+class LoadedLevel
+{
+public:
+    LoadedLevel() : physics (events), compMgr (events) {}
+
+    bool load(const std::string& levelFileName, benchmark::State& state)
+    {
+        try
+        {
+            DataLoader::loadToWorld(cPlayerFileName, compMgr, events);
+            DataLoader::loadToWorld(levelFileName, compMgr, events);
+        }
+        catch (DataLoadException& e)
+        {
+            state.SkipWithError(e.getMsg().c_str());
+            return false;
+        }
+        return true;
+    }
+
+    GameEvents events;
+    PhysicsSystem physics;
+    ComponentManager compMgr; // destroyed before the physics system
+};
+
+}
+
+static void Level_Load(benchmark::State& state, const char* levelFileName)
+{
+    for (auto _ : state)
+    {
+        LoadedLevel level;
+        if (!level.load(levelFileName, state))
+            break;
+        benchmark::DoNotOptimize(level.compMgr.getAllEntities().size());
+    }
+}
+
+// same as Level_Load, but from the compiled level (.lvlb)
+static void Level_LoadCompiled(benchmark::State& state, const char* levelFileName)
+{
+    const std::string binaryFileName = "bench_level.lvlb";
+    try
+    {
+        DataLoader::compileWorld(levelFileName, binaryFileName);
+    }
+    catch (DataLoadException& e)
+    {
+        state.SkipWithError(e.getMsg().c_str());
+        return;
+    }
+    for (auto _ : state)
+    {
+        LoadedLevel level;
+        if (!level.load(binaryFileName, state))
+            break;
+        benchmark::DoNotOptimize(level.compMgr.getAllEntities().size());
+    }
+}
+
+// restart from the in-memory snapshot (like after a game over), compare with Level_Load
+static void Level_RestoreSnapshot(benchmark::State& state, const char* levelFileName)
+{
+    LoadedLevel loadedLevel;
+    if (!loadedLevel.load(levelFileName, state))
+        return;
+    LevelSnapshot snapshot (loadedLevel.compMgr);
+    state.counters["snapshot_bytes"] = (double)snapshot.getSize();
+
+    for (auto _ : state)
+    {
+        LoadedLevel level;
+        snapshot.restore(level.compMgr, level.events);
+        benchmark::DoNotOptimize(level.compMgr.getAllEntities().size());
+    }
+}
+
+// one fixed time step (the world keeps changing, so this measures a running level)
+// allocs_per_tick: heap allocations per update (the simulation path should not allocate)
+static void Level_PhysicsUpdate(benchmark::State& state, const char* levelFileName)
+{
+    LoadedLevel level;
+    if (!level.load(levelFileName, state))
+        return;
+    size_t numAllocationsBefore = getNumAllocations();
+    for (auto _ : state)
+        level.physics.update();
+    size_t numAllocations = getNumAllocations() - numAllocationsBefore;
+    state.counters["allocs_per_tick"] = benchmark::Counter((double)numAllocations / state.iterations());
+}
+
+// same as Level_PhysicsUpdate, but after 10 seconds, when the bodies that are at rest fell asleep
+static void Level_PhysicsUpdateSettled(benchmark::State& state, const char* levelFileName)
+{
+    LoadedLevel level;
+    if (!level.load(levelFileName, state))
+        return;
+    for (int i = 0; i < 600; ++i)
+        level.physics.update();
+
+    for (auto _ : state)
+        level.physics.update();
+}
+
+// contacts of the player (used by the player controller every update)
+static void Level_PlayerGetContacts(benchmark::State& state, const char* levelFileName)
+{
+    LoadedLevel level;
+    if (!level.load(levelFileName, state))
+        return;
+    CompPhysics* playerPhysics = level.compMgr.getComponent<CompPhysics>("Player");
+    if (playerPhysics == NULL)
+    {
+        state.SkipWithError("player has no CompPhysics");
+        return;
+    }
+    // let the player fall onto the ground
+    for (int i = 0; i < 120; ++i)
+        level.physics.update();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(playerPhysics->getContacts());
+}
+
+#define LEVEL_BENCHMARKS(name, fileName) \
+    BENCHMARK_CAPTURE(Level_Load, name, fileName)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_CAPTURE(Level_LoadCompiled, name, fileName)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_CAPTURE(Level_RestoreSnapshot, name, fileName)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_CAPTURE(Level_PhysicsUpdate, name, fileName); \
+    BENCHMARK_CAPTURE(Level_PhysicsUpdateSettled, name, fileName); \
+    BENCHMARK_CAPTURE(Level_PlayerGetContacts, name, fileName)
+
+LEVEL_BENCHMARKS(cave, "data/Levels/cave.lvl");
+LEVEL_BENCHMARKS(level1, "data/Levels/level1.lvl");
+LEVEL_BENCHMARKS(level2, "data/Levels/level2.lvl");
+LEVEL_BENCHMARKS(level3, "data/Levels/level3.lvl");
+LEVEL_BENCHMARKS(level_editor, "data/Levels/level_editor.lvl");
+LEVEL_BENCHMARKS(level_grav, "data/Levels/level_grav.lvl");
+LEVEL_BENCHMARKS(planet, "data/Levels/planet.lvl");
+LEVEL_BENCHMARKS(platforms, "data/Levels/platforms.lvl");
@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "common/SpatialHash.h"
+
+// Synthetic world: square of worldSize units with boxes of 0.5 to 4.5 units (like crates and terrain pieces).
+// Queries are the size of the view (14 x 11 units) or a small pick radius.
+
+namespace {
+
+const float cWorldSize = 2000.0f;
+
+typedef std::vector<std::pair<int, Aabb> > ItemList;
+
+float randomFloat(float max)
+{
+    return max * (std::rand() / (float)RAND_MAX);
+}
+
+ItemList makeWorld(size_t numItems)
+{
+    std::srand(42);
+    ItemList items (numItems);
+    for (size_t i = 0; i < numItems; ++i)
+    {
+        Vector2D lower (randomFloat(cWorldSize), randomFloat(cWorldSize));
+        Vector2D size (0.5f + randomFloat(4.0f), 0.5f + randomFloat(4.0f));
+        items[i] = std::make_pair((int)i, Aabb(lower, lower + size));
+    }
+    return items;
+}
+
+std::vector<Aabb> makeViews(size_t count)
+{
+    std::vector<Aabb> views (count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector2D lower (randomFloat(cWorldSize), randomFloat(cWorldSize));
+        views[i] = Aabb(lower, lower + Vector2D(14.0f, 11.0f));
+    }
+    return views;
+}
+
+}
+
+static void SpatialHash_QueryView(benchmark::State& state)
+{
+    ItemList items = makeWorld(state.range(0));
+    SpatialHash<int> hash (4.0f);
+    for (size_t i = 0; i < items.size(); ++i)
+        hash.update(items[i].first, items[i].second);
+    std::vector<Aabb> views = makeViews(64);
+
+    std::vector<int> result;
+    size_t v = 0;
+    for (auto _ : state)
+    {
+        result.clear();
+        hash.queryAabb(views[v++ % views.size()], result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(SpatialHash_QueryView)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BruteForce_QueryView(benchmark::State& state)
+{
+    ItemList items = makeWorld(state.range(0));
+    std::vector<Aabb> views = makeViews(64);
+
+    std::vector<int> result;
+    size_t v = 0;
+    for (auto _ : state)
+    {
+        result.clear();
+        const Aabb& view = views[v++ % views.size()];
+        for (size_t i = 0; i < items.size(); ++i)
+            if (items[i].second.intersects(view))
+                result.push_back(items[i].first);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BruteForce_QueryView)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void SpatialHash_QueryRadius(benchmark::State& state)
+{
+    ItemList items = makeWorld(state.range(0));
+    SpatialHash<int> hash (4.0f);
+    for (size_t i = 0; i < items.size(); ++i)
+        hash.update(items[i].first, items[i].second);
+    std::vector<Aabb> views = makeViews(64);
+
+    std::vector<int> result;
+    size_t v = 0;
+    for (auto _ : state)
+    {
+        result.clear();
+        hash.queryRadius(views[v++ % views.size()].lower, 2.0f, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(SpatialHash_QueryRadius)->Arg(10000)->Arg(100000);
+
+// 1% of the items move a bit every step (dynamic bodies), the rest sleeps
+static void SpatialHash_MoveItems(benchmark::State& state)
+{
+    ItemList items = makeWorld(state.range(0));
+    SpatialHash<int> hash (4.0f);
+    for (size_t i = 0; i < items.size(); ++i)
+        hash.update(items[i].first, items[i].second);
+    size_t numMoving = items.size() / 100;
+
+    float offset = 0.0f;
+    for (auto _ : state)
+    {
+        offset = (offset > 10.0f) ? 0.0f : offset + 0.1f;
+        for (size_t i = 0; i < numMoving; ++i)
+        {
+            const Aabb& box = items[i].second;
+            hash.update(items[i].first, Aabb(box.lower + Vector2D(offset, 0.0f), box.upper + Vector2D(offset, 0.0f)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numMoving);
+}
+BENCHMARK(SpatialHash_MoveItems)->Arg(10000)->Arg(100000);
@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <IL/il.h>
+#include <IL/ilu.h>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/info_parser.hpp>
+
+#include "common/Foreach.h"
+#include "common/TextureCache.h"
+#include "common/TextureDecoder.h"
+
+// Decoding (libpng/libjpeg, other formats DevIL), scaling and mipmap generation of all textures in data/graphics.info,
+// without OpenGL. Arg: number of decoder threads (compare /1 with the others for the speedup).
+// Needs the working directory to be the top directory (like AATest).
+
+namespace {
+
+std::vector<DecodedTexture> getGraphicsTextures()
+{
+    std::vector<DecodedTexture> textures;
+    boost::property_tree::ptree propTree;
+    read_info("data/graphics.info", propTree);
+    foreach (const boost::property_tree::ptree::value_type& value, propTree)
+    {
+        if (value.first != "texture")
+            continue;
+        LoadTextureInfo info;
+        info.loadMipmaps = value.second.get("mipMaps", true);
+        info.wrapModeX = WrapClamp;
+        info.wrapModeY = WrapClamp;
+        info.quality = QualityBest;
+        info.scale = 1.0f;
+        textures.push_back(DecodedTexture(value.second.get<std::string>("file"), value.second.get<std::string>("id"), info));
+    }
+    return textures;
+}
+
+}
+
+static void Texture_DecodeGraphics(benchmark::State& state)
+{
+    ilInit();
+    iluInit();
+    const std::vector<DecodedTexture> textureList = getGraphicsTextures();
+    for (auto _ : state)
+    {
+        std::vector<DecodedTexture> textures = textureList;
+        TextureDecoder decoder (textures, 2048, (unsigned int)state.range(0));
+        for (size_t i = 0; i < textures.size(); ++i)
+        {
+            if (!decoder.waitFor(i).success)
+            {
+                state.SkipWithError(("could not decode " + textures[i].fileName).c_str());
+                return;
+            }
+            textures[i].levels.clear(); // like TextureManager::loadTextures after the upload
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * textureList.size());
+}
+BENCHMARK(Texture_DecodeGraphics)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Same as Texture_DecodeGraphics, but the textures are baked first (like AABake), so that
+// only the hashing of the source files and copying of the RGBA data is measured.
+static void Texture_LoadBaked(benchmark::State& state)
+{
+    ilInit();
+    iluInit();
+    const std::string manifestFileName = "tmp_bench_baked_textures.info";
+    const std::string dataFileName = "tmp_bench_baked_textures.bin";
+    std::vector<DecodedTexture> textureList = getGraphicsTextures();
+    {
+        std::vector<DecodedTexture> textures = textureList;
+        foreach (DecodedTexture& texture, textures)
+            texture.info.loadMipmaps = true;
+        TextureCacheWriter writer (manifestFileName, dataFileName);
+        TextureDecoder decoder (textures, 2048);
+        for (size_t i = 0; i < textures.size(); ++i)
+        {
+            DecodedTexture& texture = decoder.waitFor(i);
+            boost::uint64_t hash = 0;
+            if (!texture.success || !TextureCache::hashFile(texture.fileName, hash))
+            {
+                state.SkipWithError(("could not decode " + texture.fileName).c_str());
+                return;
+            }
+            writer.add(texture.fileName, hash, TextureCache::KindTexture, texture.info.quality, texture.levels, texture.originalWidth, texture.originalHeight);
+            texture.levels.clear();
+        }
+        writer.finish();
+    }
+    TextureCache cache;
+    if (!cache.open(manifestFileName))
+    {
+        state.SkipWithError("could not open the baked textures");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        std::vector<DecodedTexture> textures = textureList;
+        TextureDecoder decoder (textures, 2048, (unsigned int)state.range(0), &cache);
+        for (size_t i = 0; i < textures.size(); ++i)
+        {
+            if (!decoder.waitFor(i).fromCache)
+            {
+                state.SkipWithError(("not baked: " + textures[i].fileName).c_str());
+                return;
+            }
+            textures[i].levels.clear();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * textureList.size());
+
+    cache.close(); // the data file is mapped
+    std::remove(manifestFileName.c_str());
+    std::remove(dataFileName.c_str());
+}
+BENCHMARK(Texture_LoadBaked)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
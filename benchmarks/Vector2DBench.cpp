@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "common/Vector2D.h"
+
+#include <Box2D/Box2D.h>
+
+namespace {
+
+std::vector<Vector2D> makeVectors(size_t count)
+{
+    std::vector<Vector2D> vectors (count);
+    for (size_t i = 0; i < count; ++i)
+        vectors[i].set(0.5f * i - 10.0f, 3.0f - 0.25f * i);
+    return vectors;
+}
+
+}
+
+static void Vector2D_Arithmetic(benchmark::State& state)
+{
+    std::vector<Vector2D> vectors = makeVectors(256);
+    for (auto _ : state)
+    {
+        Vector2D sum;
+        float dot = 0.0f;
+        for (size_t i = 1; i < vectors.size(); ++i)
+        {
+            sum += (vectors[i] - vectors[i-1]) * 0.5f;
+            dot += vectors[i] * vectors[i-1];
+        }
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(dot);
+    }
+    state.SetItemsProcessed(state.iterations() * (vectors.size() - 1));
+}
+BENCHMARK(Vector2D_Arithmetic);
+
+static void Vector2D_Normalize(benchmark::State& state)
+{
+    std::vector<Vector2D> vectors = makeVectors(256);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < vectors.size(); ++i)
+        {
+            Vector2D v = vectors[i];
+            v.normalize();
+            benchmark::DoNotOptimize(v);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * vectors.size());
+}
+BENCHMARK(Vector2D_Normalize);
+
+static void Vector2D_Rotate(benchmark::State& state)
+{
+    std::vector<Vector2D> vectors = makeVectors(256);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < vectors.size(); ++i)
+            benchmark::DoNotOptimize(vectors[i].rotated(0.1f * i));
+    }
+    state.SetItemsProcessed(state.iterations() * vectors.size());
+}
+BENCHMARK(Vector2D_Rotate);
+
+// conversion used for every call into Box2D
+static void Vector2D_ToB2Vec2(benchmark::State& state)
+{
+    std::vector<Vector2D> vectors = makeVectors(256);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < vectors.size(); ++i)
+            benchmark::DoNotOptimize(vectors[i].to_b2Vec2().x);
+    }
+    state.SetItemsProcessed(state.iterations() * vectors.size());
+}
+BENCHMARK(Vector2D_ToB2Vec2);
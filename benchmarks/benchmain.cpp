@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+// Like the benchmark library's main, but writes JSON results to cDefaultOutFile unless
+// --benchmark_out is given, so results can be compared between commits
+// (e.g. with compare.py from the Google benchmark tools).
+
+namespace {
+const char* const cDefaultOutFile = "--benchmark_out=bench_results.json";
+const char* const cDefaultOutFormat = "--benchmark_out_format=json";
+}
+
+int main(int argc, char **argv) {
+    std::vector<char*> args (argv, argv + argc);
+    bool hasOutFile = false;
+    for (int i = 1; i < argc; ++i)
+        if (std::string(argv[i]).find("--benchmark_out=") == 0)
+            hasOutFile = true;
+    if (!hasOutFile)
+    {
+        args.push_back(const_cast<char*>(cDefaultOutFile));
+        args.push_back(const_cast<char*>(cDefaultOutFormat));
+    }
+    int numArgs = (int)args.size();
+
+    ::benchmark::Initialize(&numArgs, &args[0]);
+    if (::benchmark::ReportUnrecognizedArguments(numArgs, &args[0]))
+        return 1;
+
+    // run all the benchmarks
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Aabb.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Achsenparalleles Rechteck (axis-aligned bounding box) in Weltkoordinaten
+
+#ifndef AABB_H
+#define AABB_H
+
+#include "common/Vector2D.h"
+
+#include <cmath>
+#include <algorithm>
+
+class Aabb
+{
+public:
+    // leere Box (enthält nichts, schneidet nichts)
+    Aabb() : lower (1.0f, 1.0f), upper (-1.0f, -1.0f) {}
+    Aabb(const Vector2D& lowerBound, const Vector2D& upperBound) : lower (lowerBound), upper (upperBound) {}
+
+    bool isEmpty() const { return lower.x > upper.x || lower.y > upper.y; }
+
+    Vector2D getCenter() const { return (lower + upper) * 0.5f; }
+    Vector2D getHalfExtents() const { return (upper - lower) * 0.5f; }
+
+    void extend(const Vector2D& point)
+    {
+        if (isEmpty())
+        {
+            lower = upper = point;
+            return;
+        }
+        lower.x = std::min(lower.x, point.x);
+        lower.y = std::min(lower.y, point.y);
+        upper.x = std::max(upper.x, point.x);
+        upper.y = std::max(upper.y, point.y);
+    }
+
+    void extend(const Aabb& box)
+    {
+        if (box.isEmpty())
+            return;
+        extend(box.lower);
+        extend(box.upper);
+    }
+
+    // auf allen Seiten um margin vergrössern
+    Aabb enlarged(float margin) const
+    {
+        if (isEmpty())
+            return *this;
+        return Aabb(lower - Vector2D(margin, margin), upper + Vector2D(margin, margin));
+    }
+
+    bool contains(const Vector2D& point) const
+    {
+        return point.x >= lower.x && point.x <= upper.x && point.y >= lower.y && point.y <= upper.y;
+    }
+
+    bool intersects(const Aabb& box) const
+    {
+        return !isEmpty() && !box.isEmpty() &&
+               lower.x <= box.upper.x && box.lower.x <= upper.x &&
+               lower.y <= box.upper.y && box.lower.y <= upper.y;
+    }
+
+    // Box um diese Box, nachdem sie um angle gedreht und um position verschoben wurde (wie BatchTransform)
+    Aabb transformed(const Vector2D& position, float angle) const
+    {
+        if (isEmpty())
+            return *this;
+        float c = std::cos(angle), s = std::sin(angle);
+        Vector2D center = getCenter();
+        Vector2D half = getHalfExtents();
+        Vector2D newCenter (position.x + c*center.x - s*center.y, position.y + s*center.x + c*center.y);
+        Vector2D newHalf (std::fabs(c)*half.x + std::fabs(s)*half.y, std::fabs(s)*half.x + std::fabs(c)*half.y);
+        return Aabb(newCenter - newHalf, newCenter + newHalf);
+    }
+
+    Vector2D lower;
+    Vector2D upper;
+};
+
+#endif
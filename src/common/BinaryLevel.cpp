@@ -0,0 +1,277 @@
+/*
+ * BinaryLevel.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "BinaryLevel.h"
+
+#include "DataLoader.h"
+#include "Foreach.h"
+
+#include <map>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include <boost/property_tree/ptree.hpp>
+
+using boost::property_tree::ptree;
+using boost::uint32_t;
+
+namespace {
+
+const char cMagic[4] = { 'A', 'A', 'L', 'B' };
+const uint32_t cVersion = 1;
+const char* const cBinaryExtension = ".lvlb";
+const size_t cMaxDepth = 64; // levels use 5
+
+struct Header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t numNodes;
+    uint32_t numStrings;
+    uint32_t stringDataSize;
+};
+
+// a node whose subtree is being checked (see BinaryLevel::checkNodes)
+struct OpenNode
+{
+    BinaryLevel::NodeIndex subtreeEnd;
+    uint32_t childrenLeft;
+};
+
+// builds the node and string tables
+class Writer
+{
+public:
+    void addNode(const std::string& key, const ptree& propTree)
+    {
+        size_t index = nodes.size();
+        nodes.push_back(BinaryLevel::Node());
+        nodes[index].key = addString(key);
+        nodes[index].value = addString(propTree.data());
+        nodes[index].numChildren = (uint32_t)propTree.size();
+        foreach (const ptree::value_type& child, propTree)
+            addNode(child.first, child.second);
+        nodes[index].subtreeSize = (uint32_t)(nodes.size() - index);
+    }
+
+    std::vector<BinaryLevel::Node> nodes;
+    std::vector<BinaryLevel::StringEntry> strings;
+    std::string stringData;
+
+private:
+    uint32_t addString(const std::string& str)
+    {
+        std::map<std::string, uint32_t>::const_iterator it = m_stringIndices.find(str);
+        if (it != m_stringIndices.end())
+            return it->second;
+        BinaryLevel::StringEntry entry;
+        entry.offset = (uint32_t)stringData.size();
+        entry.length = (uint32_t)str.size();
+        stringData.append(str);
+        stringData.push_back('\0');
+        uint32_t index = (uint32_t)strings.size();
+        strings.push_back(entry);
+        m_stringIndices.insert(std::make_pair(str, index));
+        return index;
+    }
+
+    std::map<std::string, uint32_t> m_stringIndices;
+};
+
+}
+
+BinaryLevel::BinaryLevel()
+: m_file (),
+  m_nodes (NULL),
+  m_numNodes (0),
+  m_strings (NULL),
+  m_numStrings (0),
+  m_stringData (NULL)
+{
+}
+
+void BinaryLevel::open(const std::string& fileName)
+{
+    m_nodes = NULL;
+    if (!m_file.open(fileName))
+        throw DataLoadException(fileName + ": could not open file");
+    attach(m_file.getData(), m_file.getSize(), fileName);
+}
+
+void BinaryLevel::open(const char* data, size_t size, const std::string& name)
+{
+    m_nodes = NULL;
+    m_file.close();
+    attach(data, size, name);
+}
+
+void BinaryLevel::attach(const char* data, size_t size, const std::string& fileName)
+{
+    if (size < sizeof(Header))
+        throw DataLoadException(fileName + ": file too small");
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.magic, cMagic, sizeof(cMagic)) != 0)
+        throw DataLoadException(fileName + ": not a binary level file");
+    if (header.version != cVersion)
+        throw DataLoadException(fileName + ": unsupported binary level version (recompile the level)");
+
+    // 64 bit so that corrupt counts can't overflow
+    boost::uint64_t expectedSize = sizeof(Header) + (boost::uint64_t)header.numNodes * sizeof(Node)
+                                 + (boost::uint64_t)header.numStrings * sizeof(StringEntry) + header.stringDataSize;
+    if (header.numNodes == 0 || expectedSize != size)
+        throw DataLoadException(fileName + ": invalid file size");
+
+    const Node* nodes = reinterpret_cast<const Node*>(data + sizeof(Header));
+    m_numNodes = header.numNodes;
+    m_strings = reinterpret_cast<const StringEntry*>(nodes + m_numNodes);
+    m_numStrings = header.numStrings;
+    m_stringData = reinterpret_cast<const char*>(m_strings + m_numStrings);
+
+    for (uint32_t i = 0; i < m_numStrings; ++i)
+    {
+        const StringEntry& entry = m_strings[i];
+        if ((boost::uint64_t)entry.offset + entry.length >= header.stringDataSize || m_stringData[entry.offset + entry.length] != '\0')
+            throw DataLoadException(fileName + ": invalid string table");
+    }
+    m_nodes = nodes; // needed by checkNodes
+    try
+    {
+        checkNodes(fileName);
+    }
+    catch (DataLoadException&)
+    {
+        m_nodes = NULL;
+        throw;
+    }
+}
+
+// Checks that the subtrees are nested correctly, the child counts match and the strings exist.
+// The nodes are visited in file order with an explicit stack (a crafted file can't overflow the call
+// stack), the depth is limited so that the recursive readers (toPropertyTree) are safe too.
+void BinaryLevel::checkNodes(const std::string& fileName) const
+{
+    std::vector<OpenNode> ancestors; // root first
+    for (NodeIndex node = 0; node < m_numNodes; ++node)
+    {
+        while (!ancestors.empty() && ancestors.back().subtreeEnd == node)
+        {
+            if (ancestors.back().childrenLeft != 0)
+                throw DataLoadException(fileName + ": invalid node");
+            ancestors.pop_back();
+        }
+        if (ancestors.empty() && node != getRoot()) // the root has to contain all nodes
+            throw DataLoadException(fileName + ": invalid node");
+        NodeIndex end = m_numNodes;
+        if (!ancestors.empty())
+        {
+            if (ancestors.back().childrenLeft == 0)
+                throw DataLoadException(fileName + ": invalid node");
+            --ancestors.back().childrenLeft;
+            end = ancestors.back().subtreeEnd;
+        }
+
+        const Node& n = m_nodes[node];
+        if (n.key >= m_numStrings || n.value >= m_numStrings || n.subtreeSize == 0 || n.subtreeSize > end - node)
+            throw DataLoadException(fileName + ": invalid node");
+        if (ancestors.size() >= cMaxDepth)
+            throw DataLoadException(fileName + ": nodes nested too deep");
+        OpenNode open = { node + n.subtreeSize, n.numChildren };
+        ancestors.push_back(open);
+    }
+    // all subtrees end at m_numNodes now
+    foreach (const OpenNode& open, ancestors)
+    {
+        if (open.childrenLeft != 0)
+            throw DataLoadException(fileName + ": invalid node");
+    }
+}
+
+bool BinaryLevel::keyEquals(NodeIndex node, const char* key) const
+{
+    return std::strcmp(getKey(node), key) == 0;
+}
+
+const char* BinaryLevel::findChildValue(NodeIndex node, const char* key) const
+{
+    NodeIndex child = getFirstChild(node);
+    for (uint32_t i = 0; i < getNumChildren(node); ++i, child = getNextSibling(child))
+    {
+        if (keyEquals(child, key))
+            return getValue(child);
+    }
+    return NULL;
+}
+
+void BinaryLevel::toPropertyTree(NodeIndex node, ptree& propTree) const
+{
+    NodeIndex child = getFirstChild(node);
+    for (uint32_t i = 0; i < getNumChildren(node); ++i, child = getNextSibling(child))
+    {
+        ptree& childTree = propTree.push_back(ptree::value_type(getKey(child), ptree(getValue(child))))->second;
+        toPropertyTree(child, childTree);
+    }
+}
+
+void BinaryLevel::write(const ptree& propTree, const std::string& fileName)
+{
+    std::string data;
+    serialize(propTree, data);
+
+    std::ofstream out (fileName.c_str(), std::ios::binary);
+    out.write(data.data(), data.size());
+    if (!out)
+        throw DataLoadException(fileName + ": could not write binary level");
+}
+
+void BinaryLevel::serialize(const ptree& propTree, std::string& data)
+{
+    Writer writer;
+    writer.addNode("", propTree);
+
+    Header header;
+    std::memcpy(header.magic, cMagic, sizeof(cMagic));
+    header.version = cVersion;
+    header.numNodes = (uint32_t)writer.nodes.size();
+    header.numStrings = (uint32_t)writer.strings.size();
+    header.stringDataSize = (uint32_t)writer.stringData.size();
+
+    data.clear();
+    data.reserve(sizeof(header) + writer.nodes.size() * sizeof(Node) + writer.strings.size() * sizeof(StringEntry) + writer.stringData.size());
+    data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    data.append(reinterpret_cast<const char*>(&writer.nodes[0]), writer.nodes.size() * sizeof(Node));
+    if (!writer.strings.empty())
+    {
+        data.append(reinterpret_cast<const char*>(&writer.strings[0]), writer.strings.size() * sizeof(StringEntry));
+        data.append(writer.stringData);
+    }
+}
+
+bool BinaryLevel::isBinaryFileName(const std::string& fileName)
+{
+    size_t extLength = std::strlen(cBinaryExtension);
+    return fileName.size() >= extLength && fileName.compare(fileName.size() - extLength, extLength, cBinaryExtension) == 0;
+}
+
+std::string BinaryLevel::getBinaryFileName(const std::string& textFileName)
+{
+    size_t dot = textFileName.find_last_of('.');
+    size_t slash = textFileName.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return textFileName + cBinaryExtension;
+    return textFileName.substr(0, dot) + cBinaryExtension;
+}
+
+bool BinaryLevel::isUpToDate(const std::string& binaryFileName, const std::string& textFileName)
+{
+    struct stat binaryStat, textStat;
+    if (stat(binaryFileName.c_str(), &binaryStat) != 0)
+        return false;
+    if (stat(textFileName.c_str(), &textStat) != 0)
+        return true; // only the compiled level exists
+    return binaryStat.st_mtime >= textStat.st_mtime;
+}
@@ -0,0 +1,107 @@
+/*
+ * BinaryLevel.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Kompiliertes Level-Format (.lvlb): der Baum einer INFO-Datei als Records fester Grösse.
+// Die .lvl Dateien bleiben die Quelle, die .lvlb Dateien werden daraus erzeugt.
+
+#ifndef BINARYLEVEL_H
+#define BINARYLEVEL_H
+
+#include "MappedFile.h"
+
+#include <string>
+#include <boost/cstdint.hpp>
+
+// forward declare ptree (Boost PropertyTree), see Logger.h
+namespace boost { namespace property_tree {
+    template<class Key, class Data, class KeyCompare> class basic_ptree;
+    typedef basic_ptree<std::string, std::string, std::less<std::string> > ptree;
+}}
+
+/*
+    File layout (native byte order, all fields are 32 bit):
+
+        header    "AALB", version, number of nodes, number of strings, size of string data
+        nodes     key, value (string indices), number of children, subtree size
+        strings   offset, length (into string data)
+        string data (every string is null terminated)
+
+    The nodes are stored depth first, node 0 is the root. The first child of a node
+    directly follows it and the next sibling is at node index + subtree size.
+
+    The file is memory mapped and checked once when it is opened, so the nodes
+    and strings can be used directly afterwards. Files with nodes nested deeper
+    than 64 levels are rejected.
+*/
+class BinaryLevel
+{
+public:
+    typedef boost::uint32_t NodeIndex;
+
+    BinaryLevel();
+
+    // throws DataLoadException if the file is missing or invalid
+    void open(const std::string& fileName);
+    // same for a level in memory (see serialize), data must stay valid while the level is open
+    void open(const char* data, size_t size, const std::string& name);
+    bool isOpen() const { return m_nodes != NULL; }
+
+    NodeIndex getRoot() const { return 0; }
+    boost::uint32_t getNumChildren(NodeIndex node) const { return m_nodes[node].numChildren; }
+    NodeIndex getFirstChild(NodeIndex node) const { return node + 1; }
+    NodeIndex getNextSibling(NodeIndex node) const { return node + m_nodes[node].subtreeSize; }
+
+    const char* getKey(NodeIndex node) const { return getString(m_nodes[node].key); }
+    const char* getValue(NodeIndex node) const { return getString(m_nodes[node].value); }
+    bool keyEquals(NodeIndex node, const char* key) const;
+
+    // value of the first child with the given key, NULL if there is none
+    const char* findChildValue(NodeIndex node, const char* key) const;
+
+    // appends the children of node to propTree
+    void toPropertyTree(NodeIndex node, boost::property_tree::ptree& propTree) const;
+
+    // writes a property tree (e.g. from a .lvl file) in the binary format
+    // throws DataLoadException if the file can't be written
+    static void write(const boost::property_tree::ptree& propTree, const std::string& fileName);
+    // same as write, but to memory (data is replaced)
+    static void serialize(const boost::property_tree::ptree& propTree, std::string& data);
+
+    // "level.lvlb"
+    static bool isBinaryFileName(const std::string& fileName);
+    // "level.lvl" -> "level.lvlb"
+    static std::string getBinaryFileName(const std::string& textFileName);
+    // true if binaryFileName exists and is not older than textFileName
+    static bool isUpToDate(const std::string& binaryFileName, const std::string& textFileName);
+
+    struct Node
+    {
+        boost::uint32_t key;
+        boost::uint32_t value;
+        boost::uint32_t numChildren;
+        boost::uint32_t subtreeSize; // number of nodes including this one
+    };
+
+    struct StringEntry
+    {
+        boost::uint32_t offset;
+        boost::uint32_t length;
+    };
+
+private:
+    const char* getString(boost::uint32_t index) const { return m_stringData + m_strings[index].offset; }
+    void attach(const char* data, size_t size, const std::string& fileName);
+    void checkNodes(const std::string& fileName) const;
+
+    MappedFile m_file;
+    const Node* m_nodes;
+    boost::uint32_t m_numNodes;
+    const StringEntry* m_strings;
+    boost::uint32_t m_numStrings;
+    const char* m_stringData;
+};
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * Clock.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "Clock.h"
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <time.h>
+#  include <cerrno>
+#endif
+
+boost::uint64_t getMonotonicTimeNs()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = { 0 };
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    // in zwei Teilen rechnen, damit es keinen Überlauf gibt
+    return (boost::uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000 +
+           (boost::uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+#else
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (boost::uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+#endif
+}
+
+void sleepNs(boost::uint64_t ns)
+{
+#ifdef _WIN32
+    // Sleep() hat nur Millisekunden, aufrunden
+    Sleep((DWORD)((ns + 999999) / 1000000));
+#else
+    timespec time;
+    time.tv_sec = (time_t)(ns / 1000000000);
+    time.tv_nsec = (long)(ns % 1000000000);
+    // weiterschlafen, falls ein Signal den Schlaf unterbrochen hat
+    while (nanosleep(&time, &time) != 0 && errno == EINTR)
+        ;
+#endif
+}
@@ -0,0 +1,20 @@
+/*
+ * Clock.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Zeitmessung mit hoher Auflösung (SDL_GetTicks() hat nur Millisekunden)
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <boost/cstdint.hpp>
+
+// monotone Zeit in Nanosekunden (der Nullpunkt ist beliebig, nur Differenzen sind sinnvoll)
+boost::uint64_t getMonotonicTimeNs();
+
+// den Thread mindestens so lange schlafen lassen (das Betriebssystem kann auch länger warten)
+void sleepNs(boost::uint64_t ns);
+
+#endif
@@ -15,7 +15,10 @@ Component::Component(const ComponentId& id, GameEvents& gameEvents)
 : m_gameEvents (gameEvents),
   m_compManager (NULL),
   m_entityId (),
-  m_id (id)
+  m_id (id),
+  m_entityHandle (0),
+  m_typeHandle (0),
+  m_poolIndex (0)
 {}
 
 const ComponentTypeId& Component::getTypeIdStatic()
@@ -25,3 +28,23 @@ const ComponentTypeId& Component::getTypeIdStatic()
 }
 
 const ComponentId Component::DEFAULT_ID = "";
+
+void Component::setId(const ComponentId& id)
+{
+    m_id = id;
+    // siblings could be declared with this ID
+    if (m_compManager)
+        m_compManager->bindSiblings(m_entityHandle);
+}
+
+void Component::bindSiblings()
+{
+    for (size_t i = 0; i < m_siblingBindings.size(); ++i)
+        m_siblingBindings[i]->bind(*this);
+}
+
+void Component::unbindSiblings()
+{
+    for (size_t i = 0; i < m_siblingBindings.size(); ++i)
+        m_siblingBindings[i]->unbind();
+}
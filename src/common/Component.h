@@ -12,6 +12,7 @@
 #include "IdTypes.h"
 #include <string>
 #include <vector>
+#include <boost/shared_ptr.hpp>
 
 class GameEvents;
 
@@ -32,9 +33,9 @@ public:
     static const ComponentTypeId& getTypeIdStatic();
     virtual const ComponentTypeId& getTypeId() const = 0;
     const ComponentId& getId() const { return m_id; }
-    void setId(const ComponentId& id) { m_id = id; }
+    void setId(const ComponentId& id);
 
-    const EntityId& getEntityId() { return m_entityId; }
+    const EntityId& getEntityId() const { return m_entityId; }
 
     virtual void loadFromPropertyTree(const boost::property_tree::ptree& propTree) = 0;
     virtual void writeToPropertyTree(boost::property_tree::ptree& propTree) const = 0;
@@ -53,12 +54,40 @@ public:
 protected:
     GameEvents& m_gameEvents;
 
+    // Sibling components that are needed often (e.g. every frame) should be declared in the constructor.
+    // The ComponentManager sets the pointer when the entity is added (NULL if there is no such sibling),
+    // updates it when the entity changes and resets it when the entity is removed.
+    // compId may point to a member that is loaded later; NULL means any component of that type.
+    template <typename CompType> void declareSibling(CompType*& sibling, const ComponentId* compId=NULL);
+    template <typename CompType> void declareSiblings(std::vector<CompType*>& siblings);
+
 private:
+    Component(const Component&);            // not copyable (declared siblings point to members)
+    Component& operator=(const Component&);
+
+    class SiblingBinding
+    {
+    public:
+        virtual ~SiblingBinding() {}
+        virtual void bind(Component& owner) = 0;
+        virtual void unbind() = 0;
+    };
+    template <typename CompType> class SingleSiblingBinding;
+    template <typename CompType> class MultiSiblingBinding;
+
+    std::vector< boost::shared_ptr<SiblingBinding> > m_siblingBindings;
+    void bindSiblings();
+    void unbindSiblings();
+
     ComponentManager* m_compManager; // this is used for getting the sibling components
 
     EntityId m_entityId;
     ComponentId m_id;
 
+    EntityHandle m_entityHandle;      // handle of the owning entity in m_compManager
+    ComponentTypeHandle m_typeHandle; // cached handle of getTypeId()
+    unsigned int m_poolIndex;         // position in the type pool of m_compManager
+
     friend class ComponentManager; // ComponentManager will set the entity ID and m_compManager
 };
 
@@ -71,7 +100,7 @@ CompType* Component::getSiblingComponent(const ComponentId& compId)
 {
     if (m_compManager == NULL)
         return NULL;
-    return m_compManager->getComponent<CompType>(m_entityId, compId);
+    return m_compManager->getComponent<CompType>(m_entityHandle, compId);
 }
 
 template <typename CompType>
@@ -79,7 +108,7 @@ const CompType* Component::getSiblingComponent(const ComponentId& compId) const
 {
     if (m_compManager == NULL)
         return NULL;
-    return m_compManager->getComponent<CompType>(m_entityId, compId);
+    return m_compManager->getComponent<CompType>(m_entityHandle, compId);
 }
 
 template <typename CompType>
@@ -87,7 +116,7 @@ std::vector<CompType*> Component::getSiblingComponents()
 {
     if (m_compManager == NULL)
         return std::vector<CompType*>();
-    return m_compManager->getComponents<CompType>(m_entityId);
+    return m_compManager->getComponents<CompType>(m_entityHandle);
 }
 
 template <typename CompType>
@@ -95,7 +124,44 @@ std::vector<const CompType*> Component::getSiblingComponents() const
 {
     if (m_compManager == NULL)
         return std::vector<const CompType*>();
-    return m_compManager->getComponents<CompType>(m_entityId);
+    return m_compManager->getComponents<CompType>(m_entityHandle);
+}
+
+template <typename CompType>
+class Component::SingleSiblingBinding : public Component::SiblingBinding
+{
+public:
+    SingleSiblingBinding(CompType*& sibling, const ComponentId* compId) : m_sibling (sibling), m_compId (compId) {}
+    void bind(Component& owner) { m_sibling = owner.getSiblingComponent<CompType>(m_compId ? *m_compId : DEFAULT_ID); }
+    void unbind() { m_sibling = NULL; }
+private:
+    CompType*& m_sibling;
+    const ComponentId* m_compId;
+};
+
+template <typename CompType>
+class Component::MultiSiblingBinding : public Component::SiblingBinding
+{
+public:
+    MultiSiblingBinding(std::vector<CompType*>& siblings) : m_siblings (siblings) {}
+    void bind(Component& owner) { m_siblings = owner.getSiblingComponents<CompType>(); }
+    void unbind() { m_siblings.clear(); }
+private:
+    std::vector<CompType*>& m_siblings;
+};
+
+template <typename CompType>
+void Component::declareSibling(CompType*& sibling, const ComponentId* compId)
+{
+    sibling = NULL;
+    m_siblingBindings.push_back(boost::shared_ptr<SiblingBinding>(new SingleSiblingBinding<CompType>(sibling, compId)));
+}
+
+template <typename CompType>
+void Component::declareSiblings(std::vector<CompType*>& siblings)
+{
+    siblings.clear();
+    m_siblingBindings.push_back(boost::shared_ptr<SiblingBinding>(new MultiSiblingBinding<CompType>(siblings)));
 }
 
 #endif
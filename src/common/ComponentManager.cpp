@@ -25,9 +25,9 @@ ComponentManager::ComponentManager( GameEvents& events )
 ComponentManager::~ComponentManager()
 {
     // NOTE: maybe we shouldn't create events here, since the world is being destroyed anyway...
-    EntityMap::iterator next = m_entities.begin();
+    EntityMap::iterator next = m_entityIndex.begin();
     EntityMap::iterator it = next;
-    for ( ; it != m_entities.end(); it=next )
+    for ( ; it != m_entityIndex.end(); it=next )
     {
         next = it;
         ++next;
@@ -51,6 +51,14 @@ ComponentId order[] = {
 
 const int numOrdered = sizeof(order) / sizeof (order[0]);
 
+typedef std::map<ComponentTypeId, ComponentTypeHandle> TypeRegistry;
+
+TypeRegistry& typeRegistry()
+{
+    static TypeRegistry registry;
+    return registry;
+}
+
 bool compareComps(boost::shared_ptr<Component> first, boost::shared_ptr<Component> second)
 {
     ComponentId* pos1 = std::find(order, order+numOrdered, first->getTypeId());
@@ -64,20 +72,62 @@ bool compareComps(boost::shared_ptr<Component> first, boost::shared_ptr<Componen
 
 }
 
+ComponentTypeHandle ComponentManager::getTypeHandle(const ComponentTypeId& typeId)
+{
+    TypeRegistry& registry = typeRegistry();
+    TypeRegistry::iterator it = registry.find(typeId);
+    if (it != registry.end())
+        return it->second;
+
+    ComponentTypeHandle handle = static_cast<ComponentTypeHandle>(registry.size());
+    registry.insert( std::make_pair(typeId, handle) );
+    return handle;
+}
+
 void ComponentManager::addEntity(const EntityId& id, ComponentList& components)
 {
+    removeEntity(id); // if there is an entity with the same ID before, it will get deleted
+
     components.sort(compareComps);
 
-    // put components in a map
-    ComponentMap compMap;
+    EntityHandle handle;
+    if (m_freeHandles.empty())
+    {
+        handle = static_cast<EntityHandle>(m_entities.size());
+        m_entities.push_back(EntityRecord());
+    }
+    else
+    {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+
+    EntityRecord& entity = m_entities[handle];
+    entity.used = true;
+    entity.id = id;
+    entity.components = components;
+    m_entityIndex[id] = handle;
+
+    // put components in the type pools
     foreach (boost::shared_ptr<Component> comp, components)
     {
+        ComponentTypeHandle type = getTypeHandle(comp->getTypeId());
+        if (type >= entity.compsByType.size())
+            entity.compsByType.resize(type+1);
+        if (type >= m_pools.size())
+            m_pools.resize(type+1);
+
         comp->m_entityId = id;
         comp->m_compManager = this;
-        compMap.insert( std::make_pair(comp->getTypeId(), comp) );
+        comp->m_entityHandle = handle;
+        comp->m_typeHandle = type;
+        comp->m_poolIndex = static_cast<unsigned int>(m_pools[type].size());
+
+        entity.compsByType[type].push_back(comp.get());
+        m_pools[type].push_back(comp.get());
     }
 
-    m_entities[id] = compMap; // if there is an entity with the same ID before, it will get deleted
+    bindSiblings(handle);
 
     // trigger events
     foreach (boost::shared_ptr<Component> comp, components)
@@ -89,71 +139,128 @@ void ComponentManager::addEntity(const EntityId& id, ComponentList& components)
 
 void ComponentManager::removeEntity(const EntityId& id)
 {
-    EntityMap::iterator it = m_entities.find(id);
-    if (it == m_entities.end())
+    EntityMap::iterator it = m_entityIndex.find(id);
+    if (it == m_entityIndex.end())
         return;
 
+    EntityHandle handle = it->second;
+    // copy, event handlers could add entities and thus move the records
+    ComponentList components = m_entities[handle].components;
+
     m_gameEvents.deleteEntity.fire( id );
 
-    foreach (ComponentMap::value_type& pair, it->second)
+    foreach (boost::shared_ptr<Component> comp, components)
     {
-        Component& comp = *pair.second;
-        m_gameEvents.deleteComponent.fire(comp);
+        m_gameEvents.deleteComponent.fire(*comp);
     }
 
-    m_entities.erase(it);
-}
+    // remove from the type pools (swap with the last element to keep them dense)
+    foreach (boost::shared_ptr<Component> comp, components)
+    {
+        comp->unbindSiblings();
+
+        ComponentPool& pool = m_pools[comp->m_typeHandle];
+        Component* last = pool.back();
+        pool[comp->m_poolIndex] = last;
+        last->m_poolIndex = comp->m_poolIndex;
+        pool.pop_back();
+    }
 
+    // events may have modified the index, so don't use the iterator here
+    m_entityIndex.erase(id);
+
+    EntityRecord& entity = m_entities[handle];
+    entity.used = false;
+    entity.id = EntityId();
+    entity.components.clear(); // deletes the components if nobody else holds them
+    foreach (ComponentPool& comps, entity.compsByType)
+        comps.clear();
+    m_freeHandles.push_back(handle);
+}
 
 const EntityMap& ComponentManager::getAllEntities() const
 {
-    return m_entities;
+    return m_entityIndex;
+}
+
+EntityHandle ComponentManager::getEntityHandle(const EntityId& id) const
+{
+    EntityMap::const_iterator it = m_entityIndex.find(id);
+    if (it == m_entityIndex.end())
+        return cInvalidEntityHandle;
+    return it->second;
 }
 
 bool ComponentManager::renameEntity(const EntityId& oldId, const EntityId& newId)
 {
-    if (m_entities.count(newId) > 0)
+    if (m_entityIndex.count(newId) > 0)
         return false;
-    EntityMap::iterator it = m_entities.find(oldId);
-    if (it == m_entities.end())
+    EntityMap::iterator it = m_entityIndex.find(oldId);
+    if (it == m_entityIndex.end())
         return false;
 
-    foreach (ComponentMap::value_type& v, it->second)
+    EntityHandle handle = it->second;
+    EntityRecord& entity = m_entities[handle];
+    foreach (boost::shared_ptr<Component> comp, entity.components)
     {
-        v.second->m_entityId = newId;
+        comp->m_entityId = newId;
     }
+    entity.id = newId;
 
-    m_entities[newId] = it->second;
-    m_entities.erase(it);
+    m_entityIndex.erase(it);
+    m_entityIndex[newId] = handle;
+
+    bindSiblings(handle);
 
     return true;
 }
 
-Component* ComponentManager::getComponent(const EntityId& entId, const ComponentTypeId& compType, const ComponentId& compId) const
+void ComponentManager::bindSiblings(EntityHandle entity)
+{
+    foreach (boost::shared_ptr<Component> comp, m_entities[entity].components)
+        comp->bindSiblings();
+}
+
+const ComponentPool* ComponentManager::getComponentsOfType(EntityHandle entity, ComponentTypeHandle type) const
+{
+    if (entity >= m_entities.size())
+        return NULL;
+    const EntityRecord& record = m_entities[entity];
+    if (!record.used || type >= record.compsByType.size())
+        return NULL;
+    return &record.compsByType[type];
+}
+
+Component* ComponentManager::getComponent(EntityHandle entity, ComponentTypeHandle type, const ComponentId& compId) const
 {
-    EntityMap::const_iterator eit = m_entities.find(entId);
-    if ( eit == m_entities.end() )
+    const ComponentPool* comps = getComponentsOfType(entity, type);
+    if (comps == NULL)
         return NULL;
-    std::pair<ComponentMap::const_iterator,ComponentMap::const_iterator> eqRange = eit->second.equal_range(compType);
-    for (ComponentMap::const_iterator it = eqRange.first; it != eqRange.second; ++it)
+    for (ComponentPool::const_iterator it = comps->begin(); it != comps->end(); ++it)
     {
-        if (compId == "" || compId == it->second->getId())
-            return it->second.get();
+        if (compId.empty() || compId == (*it)->getId())
+            return *it;
     }
     return NULL;
 }
 
-void ComponentManager::writeEntitiesToLogger(Logger& logger, LogLevel level)
+const ComponentPool& ComponentManager::getPool(ComponentTypeHandle type) const
+{
+    static const ComponentPool emptyPool;
+    if (type >= m_pools.size())
+        return emptyPool;
+    return m_pools[type];
+}
+
+void ComponentManager::writeEntities(std::ostream& stream) const
 {
-    logger.setLevel(level);
-    for ( EntityMap::iterator it = m_entities.begin(); it != m_entities.end(); ++it )
+    for ( EntityMap::const_iterator it = m_entityIndex.begin(); it != m_entityIndex.end(); ++it )
     {
-        ComponentMap& comps = it->second;
-        logger << "--- Entity name: " << it->first << " ---\n";
-        for ( ComponentMap::iterator it2 = comps.begin(); it2 != comps.end(); ++it2 )
+        stream << "--- Entity name: " << it->first << " ---\n";
+        foreach (boost::shared_ptr<Component> comp, m_entities[it->second].components)
         {
-            logger << " Component: " << it2->second->getTypeId() << " " << it2->second->getId() << "\n";
+            stream << " Component: " << comp->getTypeId() << " " << comp->getId() << "\n";
         }
-        logger << "\n";
+        stream << "\n";
     }
 }
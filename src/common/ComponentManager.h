@@ -7,10 +7,10 @@
 #ifndef COMPONENTMANAGER_H
 #define COMPONENTMANAGER_H
 
-#include "Logger.h"
 #include "IdTypes.h"
 
 #include <map>
+#include <ostream>
 #include <list>
 #include <vector>
 #include <string>
@@ -18,11 +18,12 @@
 
 class Component;
 class GameEvents;
-class Logger;
+
+const EntityHandle cInvalidEntityHandle = static_cast<EntityHandle>(-1);
 
 typedef std::list< boost::shared_ptr<Component> > ComponentList;
-typedef std::multimap< ComponentTypeId, boost::shared_ptr<Component> > ComponentMap;
-typedef std::map< EntityId, ComponentMap > EntityMap;
+typedef std::vector<Component*> ComponentPool;
+typedef std::map< EntityId, EntityHandle > EntityMap;
 
 class Entity
 {
@@ -39,97 +40,152 @@ public:
 
     void addEntity(const EntityId& id, ComponentList& components);
     void removeEntity(const EntityId& id);
+    // all entity names mapped to their handles
     const EntityMap& getAllEntities() const;
 
     bool renameEntity(const EntityId& oldId, const EntityId& newId);
 
+    // returns cInvalidEntityHandle if there is no such entity
+    EntityHandle getEntityHandle(const EntityId& id) const;
+
     // use <Component> as template if you don't have the static type
     template <typename CompType>       CompType* getComponent(const EntityId& entId, const ComponentId& compId="");
     template <typename CompType> const CompType* getComponent(const EntityId& entId, const ComponentId& compId="") const;
+    template <typename CompType>       CompType* getComponent(EntityHandle entity, const ComponentId& compId="");
+    template <typename CompType> const CompType* getComponent(EntityHandle entity, const ComponentId& compId="") const;
 
     // Returns a vector of all matching components in an entity
     template <typename CompType> std::vector<      CompType*> getComponents(const EntityId& id);
     template <typename CompType> std::vector<const CompType*> getComponents(const EntityId& id) const;
+    template <typename CompType> std::vector<      CompType*> getComponents(EntityHandle entity);
+    template <typename CompType> std::vector<const CompType*> getComponents(EntityHandle entity) const;
+
+    // All components of a given type (of every entity), stored contiguously. The order is not specified.
+    template <typename CompType> const ComponentPool& getComponentPool() const;
 
-    void writeEntitiesToLogger(Logger& logger, LogLevel level);
+    // Type handles are global (the same for all managers)
+    template <typename CompType> static ComponentTypeHandle getTypeHandle();
+    static ComponentTypeHandle getTypeHandle(const ComponentTypeId& typeId);
+
+    void writeEntities(std::ostream& stream) const;
 
 private:
     GameEvents& m_gameEvents;
 
-    EntityMap m_entities;
-
-    Component* getComponent(const EntityId& entId, const ComponentTypeId& compType, const ComponentId& compId) const;
+    struct EntityRecord
+    {
+        EntityRecord() : used (false) {}
+        bool used;
+        EntityId id;
+        ComponentList components; // owns the components, in initialization order
+        std::vector<ComponentPool> compsByType; // indexed by ComponentTypeHandle
+    };
+
+    EntityMap m_entityIndex;
+    std::vector<EntityRecord> m_entities; // indexed by EntityHandle
+    std::vector<EntityHandle> m_freeHandles;
+    std::vector<ComponentPool> m_pools; // indexed by ComponentTypeHandle
+
+    const ComponentPool* getComponentsOfType(EntityHandle entity, ComponentTypeHandle type) const;
+    Component* getComponent(EntityHandle entity, ComponentTypeHandle type, const ComponentId& compId) const;
+    const ComponentPool& getPool(ComponentTypeHandle type) const;
+
+    template <typename CompType> std::vector<CompType*> collectComponents(EntityHandle entity) const;
+
+    // (re)resolve the declared siblings of all components of an entity
+    void bindSiblings(EntityHandle entity);
+    friend class Component;
 };
 
 // IMPLEMENTATION
 // needs to be implemented here because of templates
 
 #include "Component.h"
+
+template <typename CompType>
+ComponentTypeHandle ComponentManager::getTypeHandle()
+{
+    static const ComponentTypeHandle handle = getTypeHandle(CompType::getTypeIdStatic());
+    return handle;
+}
+
 template <typename CompType>
 CompType* ComponentManager::getComponent(const EntityId& entId, const ComponentId& compId)
 {
-   return static_cast<CompType*>(getComponent(entId, CompType::getTypeIdStatic(), compId));
+   return static_cast<CompType*>(getComponent(getEntityHandle(entId), getTypeHandle<CompType>(), compId));
 }
 
 template <typename CompType>
 const CompType* ComponentManager::getComponent(const EntityId& entId, const ComponentId& compId) const
 {
-   return static_cast<const CompType*>(getComponent(entId, CompType::getTypeIdStatic(), compId));
+   return static_cast<const CompType*>(getComponent(getEntityHandle(entId), getTypeHandle<CompType>(), compId));
+}
+
+template <typename CompType>
+CompType* ComponentManager::getComponent(EntityHandle entity, const ComponentId& compId)
+{
+   return static_cast<CompType*>(getComponent(entity, getTypeHandle<CompType>(), compId));
+}
+
+template <typename CompType>
+const CompType* ComponentManager::getComponent(EntityHandle entity, const ComponentId& compId) const
+{
+   return static_cast<const CompType*>(getComponent(entity, getTypeHandle<CompType>(), compId));
 }
 
 template <typename CompType>
 std::vector<CompType*> ComponentManager::getComponents(const EntityId& id)
 {
-    std::vector<CompType*> ret;
+    return collectComponents<CompType>(getEntityHandle(id));
+}
 
-    EntityMap::iterator eit = m_entities.find(id);
-    if (eit == m_entities.end())
-        return ret;
+template <typename CompType>
+std::vector<const CompType*> ComponentManager::getComponents(const EntityId& id) const
+{
+    return collectComponents<const CompType>(getEntityHandle(id));
+}
 
-    ComponentMap::iterator begin;
-    ComponentMap::iterator end;
-    if (CompType::getTypeIdStatic() == Component::getTypeIdStatic())
-    {
-        begin = eit->second.begin();
-        end = eit->second.end();
-    }
-    else
-    {
-        std::pair<ComponentMap::iterator, ComponentMap::iterator> equalRange = eit->second.equal_range(CompType::getTypeIdStatic());
-        begin = equalRange.first;
-        end = equalRange.second;
-    }
+template <typename CompType>
+std::vector<CompType*> ComponentManager::getComponents(EntityHandle entity)
+{
+    return collectComponents<CompType>(entity);
+}
 
-    for (ComponentMap::iterator it = begin; it != end; ++it )
-        ret.push_back( static_cast<CompType*>(it->second.get()) );
-    return ret;
+template <typename CompType>
+std::vector<const CompType*> ComponentManager::getComponents(EntityHandle entity) const
+{
+    return collectComponents<const CompType>(entity);
 }
 
 template <typename CompType>
-std::vector<const CompType*> ComponentManager::getComponents(const EntityId& id) const
+const ComponentPool& ComponentManager::getComponentPool() const
 {
-    std::vector<const CompType*> ret;
+    return getPool(getTypeHandle<CompType>());
+}
 
-    EntityMap::const_iterator eit = m_entities.find(id);
-    if (eit == m_entities.end())
+template <typename CompType>
+std::vector<CompType*> ComponentManager::collectComponents(EntityHandle entity) const
+{
+    std::vector<CompType*> ret;
+    if (entity >= m_entities.size() || !m_entities[entity].used)
         return ret;
 
-    ComponentMap::const_iterator begin;
-    ComponentMap::const_iterator end;
-    if (CompType::getTypeIdStatic() == Component::getTypeIdStatic())
+    if (getTypeHandle<CompType>() == getTypeHandle<Component>())
     {
-        begin = eit->second.begin();
-        end = eit->second.end();
+        const ComponentList& comps = m_entities[entity].components;
+        ret.reserve(comps.size());
+        for (ComponentList::const_iterator it = comps.begin(); it != comps.end(); ++it)
+            ret.push_back( static_cast<CompType*>(it->get()) );
     }
     else
     {
-        std::pair<ComponentMap::const_iterator, ComponentMap::const_iterator> equalRange = eit->second.equal_range(CompType::getTypeIdStatic());
-        begin = equalRange.first;
-        end = equalRange.second;
+        const ComponentPool* comps = getComponentsOfType(entity, getTypeHandle<CompType>());
+        if (comps == NULL)
+            return ret;
+        ret.reserve(comps->size());
+        for (ComponentPool::const_iterator it = comps->begin(); it != comps->end(); ++it)
+            ret.push_back( static_cast<CompType*>(*it) );
     }
-
-    for (ComponentMap::const_iterator it = begin; it != end; ++it )
-        ret.push_back( static_cast<CompType*>(it->second.get()) );
     return ret;
 }
 
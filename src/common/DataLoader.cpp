@@ -21,6 +21,7 @@
 #include "common/components/CompPath.h"
 #include "common/components/CompPathMove.h"
 
+#include "common/BinaryLevel.h"
 #include "common/ComponentManager.h"
 #include "common/Logger.h"
 #include "common/GameEvents.h"
@@ -28,9 +29,12 @@
 #include "common/Physics.h"
 #include "common/Font.h"
 #include "common/Texture.h"
+#include "common/TextureDecoder.h"
 #include "common/Foreach.h"
 
 #include <sstream>
+#include <utility>
+#include <algorithm>
 #include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -59,22 +63,170 @@ namespace
     }
 }
 
-// Load Level from XML
-void DataLoader::loadToWorld(const std::string& fileName, ComponentManager& compMgr, GameEvents& events)
+namespace
 {
-    std::string errMsg;
-    try
+    // creates a component from its property tree (the same for text and binary levels)
+    boost::shared_ptr<Component> createComponent(const std::string& fileName, const EntityId& entityId, const ptree& compPropTree, GameEvents& events)
     {
         using boost::shared_ptr;
         using boost::make_shared;
 
-        log(Info) << "Loading world file \"" << fileName << "\"...\n";
+        std::string compType = get<std::string>(compPropTree, "type", fileName + ": in entity '"+entityId+"', component missing 'type' node");
+        std::string compId = compPropTree.get("id", "");
+        AA_LOG(Detail) << "    Creating component \"" << compType << "\"... ";
+
+        shared_ptr<Component> component;
+
+        if ( compType == CompShape::getTypeIdStatic() )
+        {
+            if (compPropTree.count("polygon"))
+                component = boost::shared_ptr<CompShapePolygon>(new CompShapePolygon(compId, events));
+            else
+                component = boost::shared_ptr<CompShapeCircle>(new CompShapeCircle(compId, events));
+        }
+        else if ( compType == CompPhysics::getTypeIdStatic() )
+            component = boost::shared_ptr<CompPhysics>(new CompPhysics(compId, events));
+        else if ( compType == CompPlayerController::getTypeIdStatic() )
+            component = boost::shared_ptr<CompPlayerController>(new CompPlayerController(compId, events));
+        else if ( compType == CompPosition::getTypeIdStatic() )
+            component = boost::shared_ptr<CompPosition>(new CompPosition(compId, events));
+        else if ( compType == CompVisualAnimation::getTypeIdStatic() )
+            component = boost::shared_ptr<CompVisualAnimation>(new CompVisualAnimation(compId, events));
+        else if ( compType == CompVisualTexture::getTypeIdStatic() )
+            component = boost::shared_ptr<CompVisualTexture>(new CompVisualTexture(compId, events));
+        else if ( compType == CompVisualMessage::getTypeIdStatic() )
+            component = boost::shared_ptr<CompVisualMessage>(new CompVisualMessage(compId, events));
+        else if ( compType == CompGravField::getTypeIdStatic() )
+            component = boost::shared_ptr<CompGravField>(new CompGravField(compId, events));
+        else if ( compType == CompTrigger::getTypeIdStatic() )
+            component = boost::shared_ptr<CompTrigger>(new CompTrigger(compId, events));
+        else if ( compType == CompVariable::getTypeIdStatic() )
+            component = boost::shared_ptr<CompVariable>(new CompVariable(compId, events));
+        else if ( compType == CompPath::getTypeIdStatic() )
+            component = boost::make_shared<CompPath>(compId, boost::ref(events));
+        else if ( compType == CompPathMove::getTypeIdStatic() )
+            component = boost::make_shared<CompPathMove>(compId, boost::ref(events));
+        else
+            throw DataLoadException(fileName + ": in entity '" + entityId + "' component '" + compId + "', invalid component type '" + compType + "'");
+
+        assert(component);
+
+        try
+        {
+            component->loadFromPropertyTree(compPropTree);
+        }
+        catch (boost::property_tree::ptree_bad_path& e)
+        {
+            throw DataLoadException(fileName + ": in " + entityId + "." + compId + "(" + compType + "), " + e.what());
+        }
+
+        AA_LOG(Detail) << "  [ Done ]\n";
+        return component;
+    }
+
+    // Load a compiled level (.lvlb). Only the subtree of each component is converted to a property tree,
+    // so loadFromPropertyTree is shared with the text path. The conversion is about 1/6 of the load
+    // time, most of the rest is spent in loadFromPropertyTree (the same for .lvl files).
+    bool loadBinaryEntities(const BinaryLevel& level, const std::string& fileName, std::vector<LoadedEntity>& entities, GameEvents& events, const LoadProgressCallback& progress)
+    {
+        BinaryLevel::NodeIndex root = level.getRoot();
+        BinaryLevel::NodeIndex entityNode = level.getFirstChild(root);
+        size_t numEntities = level.getNumChildren(root);
+        for (size_t i = 0; i < numEntities; ++i, entityNode = level.getNextSibling(entityNode))
+        {
+            if (progress && !progress(i, numEntities))
+                return false;
+
+            if (!level.keyEquals(entityNode, "entity"))
+                throw DataLoadException(fileName + ": at top level: parse error, expected 'entity', got '" + level.getKey(entityNode) + "'");
+
+            const char* id = level.findChildValue(entityNode, "id");
+            if (id == NULL)
+                throw DataLoadException(fileName + ": entity must have node 'id'");
+            EntityId entityId = id;
+
+            ComponentList entity;
+            AA_LOG(Detail) << "  Creating entity \"" << entityId << "\"\n";
+
+            BinaryLevel::NodeIndex compNode = level.getFirstChild(entityNode);
+            for (boost::uint32_t j = 0; j < level.getNumChildren(entityNode); ++j, compNode = level.getNextSibling(compNode))
+            {
+                if (level.keyEquals(compNode, "id"))
+                    continue;
+                if (!level.keyEquals(compNode, "component"))
+                    throw DataLoadException(fileName + ": in entity '" + entityId + "': parse error, expected 'component', got '" + level.getKey(compNode) + "'");
+
+                ptree compPropTree;
+                level.toPropertyTree(compNode, compPropTree);
+                entity.push_back(createComponent(fileName, entityId, compPropTree, events));
+            }
+
+            entities.push_back(LoadedEntity(entityId));
+            entities.back().components.swap(entity);
+        }
+        if (progress)
+            progress(numEntities, numEntities);
+        return true;
+    }
+}
+
+// Load Level from INFO file (or from the compiled level, if it is up to date)
+void DataLoader::loadToWorld(const std::string& fileName, ComponentManager& compMgr, GameEvents& events)
+{
+    std::vector<LoadedEntity> entities;
+    loadEntities(fileName, entities, events);
+    foreach (LoadedEntity& entity, entities)
+        compMgr.addEntity(entity.id, entity.components);
+}
+
+bool DataLoader::loadEntities(const std::string& fileName, std::vector<LoadedEntity>& entities, GameEvents& events, const LoadProgressCallback& progress)
+{
+    try
+    {
+        if (BinaryLevel::isBinaryFileName(fileName))
+        {
+            AA_LOG(Info) << "Loading compiled world file \"" << fileName << "\"...\n";
+            BinaryLevel level;
+            level.open(fileName);
+            bool completed = loadBinaryEntities(level, fileName, entities, events, progress);
+            AA_LOG(Info) << "[ Done ]\n\n";
+            return completed;
+        }
+
+        std::string binaryFileName = BinaryLevel::getBinaryFileName(fileName);
+        if (BinaryLevel::isUpToDate(binaryFileName, fileName))
+        {
+            BinaryLevel level;
+            try
+            {
+                level.open(binaryFileName); // checks the whole file
+            }
+            catch (DataLoadException& e)
+            {
+                // the text file is the source, so it can still be used
+                AA_LOG(Warning) << e.getMsg() << ", loading \"" << fileName << "\" instead\n";
+            }
+            if (level.isOpen())
+            {
+                AA_LOG(Info) << "Loading compiled world file \"" << binaryFileName << "\"...\n";
+                bool completed = loadBinaryEntities(level, binaryFileName, entities, events, progress);
+                AA_LOG(Info) << "[ Done ]\n\n";
+                return completed;
+            }
+        }
+
+        AA_LOG(Info) << "Loading world file \"" << fileName << "\"...\n";
 
         ptree levelPropTree;
         read_info(fileName, levelPropTree);
 
+        size_t numEntities = levelPropTree.size();
+        size_t i = 0;
         foreach(const ptree::value_type &value1, levelPropTree)
         {
+            if (progress && !progress(i++, numEntities))
+                return false;
+
             if (value1.first != "entity")
                 throw DataLoadException(fileName + ": at top level: parse error, expected 'entity', got '" + value1.first + "'");
             const ptree& entityPropTree = value1.second;
@@ -82,7 +234,7 @@ void DataLoader::loadToWorld(const std::string& fileName, ComponentManager& comp
             EntityId entityId = get<std::string>(entityPropTree, "id", fileName + ": entity must have node 'id'");
 
             ComponentList entity;
-            log(Info) << "  Creating entity \"" << entityId << "\"\n";
+            AA_LOG(Detail) << "  Creating entity \"" << entityId << "\"\n";
 
             foreach(const ptree::value_type &value2, entityPropTree)
             {
@@ -90,66 +242,17 @@ void DataLoader::loadToWorld(const std::string& fileName, ComponentManager& comp
                     continue;
                 if (value2.first != "component")
                     throw DataLoadException(fileName + ": in entity '" + entityId + "': parse error, expected 'component', got '" + value2.first + "'");
-                const ptree& compPropTree = value2.second;
-
-                std::string compType = get<std::string>(compPropTree, "type", fileName + ": in entity '"+entityId+"', component missing 'type' node");
-                std::string compId = compPropTree.get("id", "");
-                log(Info) << "    Creating component \"" << compType << "\"... ";
-
-                shared_ptr<Component> component;
-
-                if ( compType == CompShape::getTypeIdStatic() )
-                {
-                    if (compPropTree.count("polygon"))
-                        component = boost::shared_ptr<CompShapePolygon>(new CompShapePolygon(compId, events));
-                    else
-                        component = boost::shared_ptr<CompShapeCircle>(new CompShapeCircle(compId, events));
-                }
-                else if ( compType == CompPhysics::getTypeIdStatic() )
-                    component = boost::shared_ptr<CompPhysics>(new CompPhysics(compId, events));
-                else if ( compType == CompPlayerController::getTypeIdStatic() )
-                    component = boost::shared_ptr<CompPlayerController>(new CompPlayerController(compId, events));
-                else if ( compType == CompPosition::getTypeIdStatic() )
-                    component = boost::shared_ptr<CompPosition>(new CompPosition(compId, events));
-                else if ( compType == CompVisualAnimation::getTypeIdStatic() )
-                    component = boost::shared_ptr<CompVisualAnimation>(new CompVisualAnimation(compId, events));
-                else if ( compType == CompVisualTexture::getTypeIdStatic() )
-                    component = boost::shared_ptr<CompVisualTexture>(new CompVisualTexture(compId, events));
-                else if ( compType == CompVisualMessage::getTypeIdStatic() )
-                    component = boost::shared_ptr<CompVisualMessage>(new CompVisualMessage(compId, events));
-                else if ( compType == CompGravField::getTypeIdStatic() )
-                    component = boost::shared_ptr<CompGravField>(new CompGravField(compId, events));
-                else if ( compType == CompTrigger::getTypeIdStatic() )
-                    component = boost::shared_ptr<CompTrigger>(new CompTrigger(compId, events));
-                else if ( compType == CompVariable::getTypeIdStatic() )
-                    component = boost::shared_ptr<CompVariable>(new CompVariable(compId, events));
-                else if ( compType == CompPath::getTypeIdStatic() )
-                    component = boost::make_shared<CompPath>(compId, boost::ref(events));
-                else if ( compType == CompPathMove::getTypeIdStatic() )
-                    component = boost::make_shared<CompPathMove>(compId, boost::ref(events));
-                else
-                    throw DataLoadException(fileName + ": in entity '" + entityId + "' component '" + compId + "', invalid component type '" + compType + "'");
-
-                assert(component);
-
-                try
-                {
-                    component->loadFromPropertyTree(compPropTree);
-                }
-                catch (boost::property_tree::ptree_bad_path& e)
-                {
-                    throw DataLoadException(fileName + ": in " + entityId + "." + compId + "(" + compType + "), " + e.what());
-                }
-
-                entity.push_back(component);
-
-                log(Info) << "  [ Done ]\n";
+                entity.push_back(createComponent(fileName, entityId, value2.second, events));
             }
 
-            compMgr.addEntity(entityId, entity);
+            entities.push_back(LoadedEntity(entityId));
+            entities.back().components.swap(entity);
         }
+        if (progress)
+            progress(numEntities, numEntities);
 
-        log(Info) << "[ Done ]\n\n";
+        AA_LOG(Info) << "[ Done ]\n\n";
+        return true;
     }
     catch (boost::property_tree::ptree_error& e)
     {
@@ -157,9 +260,54 @@ void DataLoader::loadToWorld(const std::string& fileName, ComponentManager& comp
     }
 }
 
-ResourceIds DataLoader::loadGraphics(const std::string& fileName, TextureManager* textureManager, AnimationManager* animationManager, FontManager* fontManager, TexQuality quality)
+bool DataLoader::loadEntities(const BinaryLevel& level, const std::string& levelName, std::vector<LoadedEntity>& entities, GameEvents& events, const LoadProgressCallback& progress)
+{
+    try
+    {
+        return loadBinaryEntities(level, levelName, entities, events, progress);
+    }
+    catch (boost::property_tree::ptree_error& e)
+    {
+        throw DataLoadException(levelName + ": " + e.what());
+    }
+}
+
+void DataLoader::initComponentTypeIds()
+{
+    CompShape::getTypeIdStatic();
+    CompPhysics::getTypeIdStatic();
+    CompPlayerController::getTypeIdStatic();
+    CompPosition::getTypeIdStatic();
+    CompVisualAnimation::getTypeIdStatic();
+    CompVisualTexture::getTypeIdStatic();
+    CompVisualMessage::getTypeIdStatic();
+    CompGravField::getTypeIdStatic();
+    CompTrigger::getTypeIdStatic();
+    CompVariable::getTypeIdStatic();
+    CompPath::getTypeIdStatic();
+    CompPathMove::getTypeIdStatic();
+}
+
+// Compile a level to the binary format (the tree is copied as is, without creating components)
+void DataLoader::compileWorld(const std::string& textFileName, const std::string& binaryFileName)
+{
+    AA_LOG(Info) << "Compiling world file \"" << textFileName << "\" to \"" << binaryFileName << "\"...\n";
+    ptree levelPropTree;
+    try
+    {
+        read_info(textFileName, levelPropTree);
+    }
+    catch (boost::property_tree::ptree_error& e)
+    {
+        throw DataLoadException(e.what());
+    }
+    BinaryLevel::write(levelPropTree, binaryFileName);
+    AA_LOG(Info) << "[ Done ]\n\n";
+}
+
+ResourceIds DataLoader::loadGraphics(const std::string& fileName, TextureManager* textureManager, AnimationManager* animationManager, FontManager* fontManager, TexQuality quality, const ResourceIds* filter)
 {
-    log(Info) << "Loading graphics resource file \"" << fileName << "\"...\n";
+    AA_LOG(Info) << "Loading graphics resource file \"" << fileName << "\"...\n";
 
     ResourceIds loadedResources;
 
@@ -176,6 +324,7 @@ ResourceIds DataLoader::loadGraphics(const std::string& fileName, TextureManager
         // Texturen laden
         if (textureManager)
         {
+            std::vector<DecodedTexture> textures;
             foreach(const ptree::value_type &value, propTree)
             {
                 if (value.first != "texture")
@@ -184,6 +333,8 @@ ResourceIds DataLoader::loadGraphics(const std::string& fileName, TextureManager
 
                 std::string fileName = texPropTree.get<std::string>("file");
                 std::string id = texPropTree.get<std::string>("id");
+                if (filter && filter->textures.count(id) == 0)
+                    continue;
                 bool mipMaps = texPropTree.get("mipMaps", true);
                 bool texRepeat = texPropTree.get("texRepeat", false); // deprecated (?)
                 bool texRepeatX = texPropTree.get("texRepeatX", false);
@@ -214,9 +365,11 @@ ResourceIds DataLoader::loadGraphics(const std::string& fileName, TextureManager
                 info.scale = scale;
                 info.quality = quality;
 
-                textureManager->loadTexture(fileName, id, info);
+                textures.push_back(DecodedTexture(fileName, id, info));
                 loadedResources.textures.insert(id);
             }
+            // dekodiert die Bilder parallel
+            textureManager->loadTextures(textures);
         }
 
         // Animationen laden
@@ -230,6 +383,8 @@ ResourceIds DataLoader::loadGraphics(const std::string& fileName, TextureManager
 
                 std::string fileName = animPropTree.get<std::string>("file");
                 std::string id = animPropTree.get<std::string>("id");
+                if (filter && filter->animations.count(id) == 0)
+                    continue;
                 bool mipMaps = animPropTree.get("mipMaps", true);
                 bool texRepeat = animPropTree.get("texRepeat", false); // deprecated (?)
                 bool texRepeatX = animPropTree.get("texRepeatX", false);
@@ -274,6 +429,8 @@ ResourceIds DataLoader::loadGraphics(const std::string& fileName, TextureManager
 
                 std::string name = fontPropTree.get<std::string>("file");
                 std::string id = fontPropTree.get<std::string>("id");
+                if (filter && filter->fonts.count(id) == 0)
+                    continue;
                 float sizeF = fontPropTree.get<float>("size");
                 int sizeI = fontPropTree.get("size", 0);
                 bool fix = fontPropTree.get("fix", false);
@@ -290,14 +447,55 @@ ResourceIds DataLoader::loadGraphics(const std::string& fileName, TextureManager
     {
         throw DataLoadException(std::string("reading file '" + fileName + "': ") + e.what());
     }
-    log(Info) << "[ Done ]\n\n";
+    AA_LOG(Info) << "[ Done ]\n\n";
     return loadedResources;
 }
 
+ResourceIds DataLoader::getGraphicsIds(const std::string& fileName)
+{
+    ResourceIds ids;
+    try
+    {
+        ptree propTree;
+        read_info(fileName, propTree);
+        foreach(const ptree::value_type &value, propTree)
+        {
+            if (value.first == "texture")
+                ids.textures.insert(value.second.get<std::string>("id"));
+            else if (value.first == "animation")
+                ids.animations.insert(value.second.get<std::string>("id"));
+            else if (value.first == "font")
+                ids.fonts.insert(value.second.get<std::string>("id"));
+        }
+    }
+    catch (boost::property_tree::ptree_error& e)
+    {
+        throw DataLoadException(std::string("reading file '" + fileName + "': ") + e.what());
+    }
+    return ids;
+}
+
+ResourceIds DataLoader::getUsedGraphics(const ComponentManager& compMgr)
+{
+    ResourceIds ids;
+    foreach (const Component* comp, compMgr.getComponentPool<CompVisualTexture>())
+    {
+        const CompVisualTexture* texComp = static_cast<const CompVisualTexture*>(comp);
+        if (!texComp->getTextureId().empty())
+            ids.textures.insert(texComp->getTextureId());
+        typedef std::map<size_t, TextureId> EdgeTextureMap;
+        foreach (const EdgeTextureMap::value_type& edge, texComp->getEdgeTextures())
+            ids.textures.insert(edge.second);
+    }
+    foreach (const Component* comp, compMgr.getComponentPool<CompVisualAnimation>())
+        ids.animations.insert(static_cast<const CompVisualAnimation*>(comp)->getAnimInfoId());
+    return ids;
+}
+
 void DataLoader::unLoadGraphics( const ResourceIds& resourcesToUnload, TextureManager* textureManager, AnimationManager* animationManager, FontManager* fontManager )
 {
     if (!resourcesToUnload.isEmpty())
-        log(Info) << "Unloading resources... ";
+        AA_LOG(Info) << "Unloading resources... ";
 
     // Texturen laden
     if (textureManager)
@@ -320,38 +518,49 @@ void DataLoader::unLoadGraphics( const ResourceIds& resourcesToUnload, TextureMa
             fontManager->freeFont(id);
     }
 
-    log(Info) << "[ Done ]\n\n";
+    AA_LOG(Info) << "[ Done ]\n\n";
 }
 
 void DataLoader::saveWorld(const std::string& fileName, const ComponentManager& compMgr)
 {
-    log(Info) << "Saving world to file \"" << fileName << "\"...\n";
+    AA_LOG(Info) << "Saving world to file \"" << fileName << "\"...\n";
     
     ptree levelPropTree;
+    writeWorld(compMgr, levelPropTree);
     
-    const EntityMap& entities = compMgr.getAllEntities();
-    foreach(const EntityMap::value_type& entPair, entities)
+    if (BinaryLevel::isBinaryFileName(fileName))
+        BinaryLevel::write(levelPropTree, fileName);
+    else
+        write_info(fileName, levelPropTree, std::locale(), boost::property_tree::info_parser::info_writer_settings<char>('\t',1));
+
+    AA_LOG(Info) << "[ Done ]\n\n";
+}
+
+void DataLoader::writeWorld(const ComponentManager& compMgr, ptree& levelPropTree)
+{
+    // nach Handle sortiert, damit die Reihenfolge (z.B. beim Zeichnen) beim Laden gleich bleibt
+    std::vector< std::pair<EntityHandle, EntityId> > entities;
+    foreach(const EntityMap::value_type& entPair, compMgr.getAllEntities())
+        entities.push_back(std::make_pair(entPair.second, entPair.first));
+    std::sort(entities.begin(), entities.end());
+
+    for (size_t i = 0; i < entities.size(); ++i)
     {
         ptree entityPropTree;
-        entityPropTree.add("id", entPair.first);
+        entityPropTree.add("id", entities[i].second);
 
-        const ComponentMap& comps = entPair.second;
-        foreach(const ComponentMap::value_type& compPair, comps)
+        foreach(const Component* comp, compMgr.getComponents<Component>(entities[i].first))
         {
             ptree compPropTree;
-            compPropTree.add("type", compPair.second->getTypeId());
-            std::string compId = compPair.second->getId();
+            compPropTree.add("type", comp->getTypeId());
+            std::string compId = comp->getId();
             if (!compId.empty())
                 compPropTree.add("id", compId);
-            compPair.second->writeToPropertyTree(compPropTree);
+            comp->writeToPropertyTree(compPropTree);
 
             entityPropTree.add_child("component", compPropTree);
         }
 
         levelPropTree.add_child("entity", entityPropTree);
     }
-    
-    write_info(fileName, levelPropTree, std::locale(), boost::property_tree::info_parser::info_writer_settings<char>('\t',1));
-
-    log(Info) << "[ Done ]\n\n";
 }
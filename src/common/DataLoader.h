@@ -9,11 +9,15 @@
 #ifndef DATALOADER_H
 #define DATALOADER_H
 
+#include "ComponentManager.h"
 #include "Exception.h"
 #include "Texture.h"
 #include <set>
 #include <string>
+#include <vector>
+#include <boost/function.hpp>
 
+class BinaryLevel;
 class ComponentManager;
 class TextureManager;
 class AnimationManager;
@@ -35,13 +39,48 @@ public:
     DataLoadException(const std::string& msg);
 };
 
+// An entity that is loaded but not yet added to a ComponentManager
+class LoadedEntity
+{
+public:
+    LoadedEntity(const EntityId& id) : id (id), components () {}
+    EntityId id;
+    ComponentList components;
+};
+
+// Called before each entity with the number of loaded entities and the total in the file.
+// Returning false stops loading.
+typedef boost::function<bool (size_t numLoaded, size_t numTotal)> LoadProgressCallback;
+
 class DataLoader
 {
 public:
+    // loads "level.lvlb" instead of "level.lvl" if it exists and is up to date
     static void loadToWorld(const std::string& fileName, ComponentManager&, GameEvents& events);
-    static ResourceIds loadGraphics(const std::string& fileName, TextureManager*, AnimationManager*, FontManager*, TexQuality);
+    // Creates the entities without registering them, so that this can run in another thread
+    // (the components still register listeners to events in their constructors).
+    // Returns false if loading was stopped by the progress callback.
+    static bool loadEntities(const std::string& fileName, std::vector<LoadedEntity>& entities, GameEvents& events,
+                             const LoadProgressCallback& progress = LoadProgressCallback());
+    // the same for a compiled level that is already open (e.g. the one of a LevelSnapshot)
+    static bool loadEntities(const BinaryLevel& level, const std::string& levelName, std::vector<LoadedEntity>& entities, GameEvents& events,
+                             const LoadProgressCallback& progress = LoadProgressCallback());
+    // the component type IDs are created on first use, this must be done before loadEntities runs in another thread
+    static void initComponentTypeIds();
+    // filter: if not NULL, only the resources in it are loaded
+    static ResourceIds loadGraphics(const std::string& fileName, TextureManager*, AnimationManager*, FontManager*, TexQuality,
+                                    const ResourceIds* filter = NULL);
+    // all resources of a graphics file (without loading them)
+    static ResourceIds getGraphicsIds(const std::string& fileName);
+    // textures and animations used by the visual components (to load only those)
+    static ResourceIds getUsedGraphics(const ComponentManager&);
     static void unLoadGraphics(const ResourceIds& resourcesToUnload, TextureManager*, AnimationManager*, FontManager*);
+    // saves a compiled level if fileName ends with ".lvlb"
     static void saveWorld(const std::string& fileName, const ComponentManager&);
+    // the tree that saveWorld writes, the entities are in the order they were added
+    static void writeWorld(const ComponentManager&, boost::property_tree::ptree& levelPropTree);
+    // converts a .lvl file to the binary format (see BinaryLevel)
+    static void compileWorld(const std::string& textFileName, const std::string& binaryFileName);
 private:
 };
 
@@ -6,11 +6,16 @@
 
 #include "Event.h"
 
-EventConnection::EventConnection() : m_refCount ( new int(1) ) {}
+EventConnection::EventConnection() : m_table ( NULL ), m_slot ( 0 ) {}
 
-EventConnection::EventConnection(const EventConnection& evCon) : m_refCount (evCon.m_refCount)
+EventConnection::EventConnection(EventSlotTable* table, unsigned int slot) : m_table ( table ), m_slot ( slot )
 {
-    (*m_refCount)++;
+    acquire();
+}
+
+EventConnection::EventConnection(const EventConnection& evCon) : m_table (evCon.m_table), m_slot (evCon.m_slot)
+{
+    acquire();
 }
 
 EventConnection::~EventConnection()
@@ -18,34 +23,43 @@ EventConnection::~EventConnection()
     release();
 }
 
+void EventConnection::acquire()
+{
+    if (m_table == NULL)
+        return;
+    m_table->refCount++;
+    m_table->slotRefCounts[m_slot]++;
+}
+
 void EventConnection::release()
 {
-    if (m_refCount == NULL)
+    if (m_table == NULL)
         return;
 
-    (*m_refCount)--;
-    if (*m_refCount == 0)
-    {
-        delete m_refCount;
-        m_refCount = NULL;
-    }
+    m_table->slotRefCounts[m_slot]--;
+    if (m_table->slotRefCounts[m_slot] == 0 && m_table->eventAlive)
+        m_table->numDeadSlots++; // the event removes the listener later
+    m_table->refCount--;
+    if (m_table->refCount == 0)
+        delete m_table;
+    m_table = NULL;
 }
 
 EventConnection& EventConnection::operator = (const EventConnection& con)
 {
+    if (this == &con)
+        return *this;
     release();
-    m_refCount = con.m_refCount; // share the same smart pointer
-    (*m_refCount)++;
+    m_table = con.m_table; // share the same counter
+    m_slot = con.m_slot;
+    acquire();
     return *this;  // by convention, always return *this
 }
 
 // IsValid: returns true if this connection has objects connected on both ends
 bool EventConnection::isValid() const
 {
-    //return !m_sharedPtr.unique();
-    if (m_refCount == NULL || *m_refCount < 2)
-        return false;
-    return true;
+    return m_table != NULL && m_table->eventAlive;
 }
 
 void EventConnections::add(const EventConnection& eventCon)
@@ -53,32 +67,43 @@ void EventConnections::add(const EventConnection& eventCon)
     m_connections.push_back(eventCon);
 }
 
-EventConnection Event0::registerListener(Function func)
+EventBase::EventBase() : m_table ( new EventSlotTable ), m_fireDepth ( 0 ) {}
+
+EventBase::~EventBase()
+{
+    // the connections may live longer than the event
+    m_table->eventAlive = false;
+    m_table->refCount--;
+    if (m_table->refCount == 0)
+        delete m_table;
+}
+
+unsigned int EventBase::newSlot()
+{
+    if (!m_table->freeSlots.empty())
+    {
+        unsigned int slot = m_table->freeSlots.back();
+        m_table->freeSlots.pop_back();
+        return slot;
+    }
+    m_table->slotRefCounts.push_back(0);
+    return (unsigned int)m_table->slotRefCounts.size() - 1;
+}
+
+void EventBase::freeSlot(unsigned int slot)
 {
-    // Create a new EventConnection
-    EventConnection evCon;
-    // Put func in our list and store its position. Store also the EventConnection (to be able to know if the connection is still valid).
-    m_listenerFuncs.insert( m_listenerFuncs.end(), std::make_pair(func,evCon) );
-    // Return the connection (listener must keep this object, else it will be unregistered later on)
-    return evCon;
+    m_table->numDeadSlots--;
+    m_table->freeSlots.push_back(slot);
 }
 
 // Fire the event
 void Event0::fire()
 {
-    // For each listener function in our list
-    for (FunctionList::iterator it = m_listenerFuncs.begin(); it != m_listenerFuncs.end();)
+    FireScope scope (*this);
+    // the vector doesn't change while firing (new and dead listeners are handled afterwards)
+    for (size_t i = 0; i < m_listeners.size(); ++i)
     {
-        FunctionList::iterator cur_pos = it++; // store the current position and set (it) to
-                                               // point to the next element (cur_pos can get deleted)
-        if (!cur_pos->second.isValid()) // if the connection is no longer valid
-            m_listenerFuncs.erase(cur_pos); // the listener probably got deleted
-        else
-            (cur_pos->first)(); // call the function
+        if (isListenerAlive(m_listeners[i].slot)) // the listener could have been deleted in the meantime
+            m_listeners[i].func(); // call the function
     }
 }
-// Unregister the listener at position pos. Is used by the Connection object.
-void Event0::unregisterListener(FunctionList::iterator pos)
-{
-    m_listenerFuncs.erase(pos);
-}
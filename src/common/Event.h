@@ -8,14 +8,21 @@
 #define EVENT_H
 
 #include <list>
+#include <vector>
 #include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/unordered_map.hpp>
+
+class EventSlotTable;
 
 // Connection
 // ----------
-// Reference counted object. It is returned by the Event class.
+// Reference counted handle. It is returned by the Event class.
 // When destructed, the event knows that the listener is no longer valid and should be unregistered.
 // If copied, the event will only be unregistered if the copy is also destructed (so be careful!)
-// It is implemented with a reference counter
+// It is implemented with a reference counter per listener, stored in the event's slot table
+// (no allocation per connection).
 class EventConnection
 {
 public:
@@ -28,8 +35,14 @@ public:
     bool isValid() const;
 
 private:
-    int* m_refCount;
+    EventConnection(EventSlotTable* table, unsigned int slot);
+    void acquire();
     void release(); // release the current counter
+
+    EventSlotTable* m_table; // NULL if not connected
+    unsigned int m_slot;
+
+    friend class EventBase;
 };
 
 class EventConnections
@@ -40,6 +53,84 @@ private:
     std::list<EventConnection> m_connections;
 };
 
+// State shared by an event and its connections. It is deleted when the event and all connections are gone.
+class EventSlotTable
+{
+public:
+    EventSlotTable() : refCount (1), eventAlive (true), numDeadSlots (0) {}
+
+    int refCount;                           // the event + every EventConnection object
+    bool eventAlive;
+    std::vector<int> slotRefCounts;         // EventConnection objects per listener (0 = listener is dead)
+    std::vector<unsigned int> freeSlots;
+    unsigned int numDeadSlots;              // slots with no connection left that are not yet removed
+};
+
+// Common part of all events: manages the listener slots
+class EventBase
+{
+protected:
+    EventBase();
+    ~EventBase();
+
+    unsigned int newSlot();
+    void freeSlot(unsigned int slot); // the listener of this slot was removed
+    EventConnection makeConnection(unsigned int slot) { return EventConnection(m_table, slot); }
+    bool isListenerAlive(unsigned int slot) const { return m_table->slotRefCounts[slot] > 0; }
+    bool hasDeadListeners() const { return m_table->numDeadSlots > 0; }
+
+    EventSlotTable* m_table;
+    int m_fireDepth; // > 0 while firing (events can be fired recursively)
+
+private:
+    EventBase(const EventBase&);
+    EventBase& operator = (const EventBase&);
+};
+
+// Listeners stored contiguously in registration order.
+// Dead listeners are skipped while firing and removed after the outermost fire() returns.
+// Listeners registered during fire() are added after it returns (so they don't get the current event).
+template <typename Func>
+class EventListenerList : public EventBase
+{
+public:
+    typedef Func Function;
+
+    // Register a new listener
+    // Return value is an EventConnection.
+    // When the EventConnection object is deleted, the listener is automatically unregistered.
+    // This means that the return value must be kept as long as the function should be registered
+    EventConnection registerListener(Function func);
+
+protected:
+    struct Listener
+    {
+        Function func;
+        unsigned int slot;
+    };
+    typedef std::vector<Listener> ListenerVector;
+
+    // Keeps the listener vector unchanged while firing
+    class FireScope
+    {
+    public:
+        FireScope(EventListenerList& event) : m_event (event) { ++m_event.m_fireDepth; }
+        ~FireScope() { if (--m_event.m_fireDepth == 0) m_event.endFire(); }
+    private:
+        FireScope(const FireScope&);
+        FireScope& operator = (const FireScope&);
+        EventListenerList& m_event;
+    };
+
+    ListenerVector m_listeners;
+
+private:
+    void endFire();
+    void removeDeadListeners();
+
+    ListenerVector m_pendingListeners; // registered while firing
+};
+
 // template <typename ArgType1, typename ArgType2, ..., typename ArgTypeN>
 // EventN
 // -----
@@ -49,63 +140,69 @@ private:
 // Note: This should use variadic templates, but they are not yet in the C++ standard... :-(
 //       So I duplicate this class for every number of arguments
 
-class Event0 {
+class Event0 : public EventListenerList< boost::function<void ()> > {
 public:
-    typedef boost::function<void ()> Function;
-    typedef std::list< std::pair< Function, EventConnection > > FunctionList;
-
-    // Register a new listener
-    // Return value is an EventConnection.
-    // When the EventConnection object is deleted, the listener is automatically unregistered.
-    // This means that the return value must be kept as long as the function should be registered
-    EventConnection registerListener(Function func);
-
     // Fire the event
     void fire();
-private:
-    FunctionList m_listenerFuncs; // list of all registered listener call back functions
-
-    // Unregister the listener at position pos. Is used by the Connection object.
-    void unregisterListener(FunctionList::iterator pos);
 };
 
 // same thing for 1 argument
 template <typename ArgType>
-class Event1 {
+class Event1 : public EventListenerList< boost::function<void (ArgType)> > {
 public:
-    typedef boost::function<void (ArgType)> Function;
-    typedef std::list< std::pair< Function, EventConnection > > FunctionList;
-    EventConnection registerListener(Function func);
     void fire(ArgType arg);
-private:
-    FunctionList m_listenerFuncs;
-    void unregisterListener(typename FunctionList::iterator pos);
 };
 
 // same thing for 2 arguments
 template <typename ArgType1, typename ArgType2>
-class Event2 {
+class Event2 : public EventListenerList< boost::function<void (ArgType1,ArgType2)> > {
 public:
-    typedef boost::function<void (ArgType1,ArgType2)> Function;
-    typedef std::list< std::pair< Function, EventConnection > > FunctionList;
-    EventConnection registerListener(Function func);
     void fire(ArgType1 arg1,ArgType2 arg2);
-private:
-    FunctionList m_listenerFuncs;
-    void unregisterListener(typename FunctionList::iterator pos);
 };
 
 // same thing for 3 arguments
 template <typename ArgType1, typename ArgType2, typename ArgType3>
-class Event3 {
+class Event3 : public EventListenerList< boost::function<void (ArgType1,ArgType2,ArgType3)> > {
 public:
-    typedef boost::function<void (ArgType1,ArgType2,ArgType3)> Function;
-    typedef std::list< std::pair< Function, EventConnection > > FunctionList;
-    EventConnection registerListener(Function func);
     void fire(ArgType1 arg1,ArgType2 arg2,ArgType3 arg3);
+};
+
+// Keyed event
+// -----------
+// One event (channel) per key, e.g. per entity. Listeners subscribe to a single key and
+// firing a key only calls the listeners of that key (one hash lookup, no filtering in the listeners).
+// The key needs a hash_value function (see boost::hash).
+template <typename Key, typename EventType>
+class KeyedEvent
+{
+public:
+    typedef typename EventType::Function Function;
+
+    KeyedEvent() : m_channels () {}
+
+    EventConnection registerListener(const Key& key, Function func)
+    {
+        boost::shared_ptr<EventType>& channel = m_channels[key];
+        if (!channel)
+            channel = boost::make_shared<EventType>();
+        return channel->registerListener(func);
+    }
+
+    // Channel of the key, NULL if nobody has subscribed to it.
+    // Usage: if (EventType* channel = event.find(key)) channel->fire(...);
+    // (channels are never deleted, so the pointer stays valid while new keys are added)
+    EventType* find(const Key& key)
+    {
+        typename ChannelMap::iterator it = m_channels.find(key);
+        return it == m_channels.end() ? NULL : it->second.get();
+    }
+
 private:
-    FunctionList m_listenerFuncs;
-    void unregisterListener(typename FunctionList::iterator pos);
+    typedef boost::unordered_map< Key, boost::shared_ptr<EventType> > ChannelMap;
+    ChannelMap m_channels;
+
+    KeyedEvent(const KeyedEvent&);
+    KeyedEvent& operator = (const KeyedEvent&);
 };
 
 // we need to include the cpp because the template methods need to be implemented in the header...
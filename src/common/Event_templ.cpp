@@ -4,94 +4,113 @@
  * Copyright (c) 2014 Christian Zommerfelds
  */
 
+#include <algorithm>
 #include <boost/bind.hpp>
 
-// for 1 argument
-#define EVENT1 Event1<ArgType>
-
-template <typename ArgType>
-EventConnection EVENT1::registerListener(Function func)
+template <typename Func>
+EventConnection EventListenerList<Func>::registerListener(Function func)
 {
-    EventConnection evCon;
-    m_listenerFuncs.insert( m_listenerFuncs.end(), std::make_pair(func,evCon) );
+    // Put func in our vector and give it a slot (the slot knows if the connection is still valid).
+    Listener listener;
+    listener.func = func;
+    listener.slot = newSlot();
+    EventConnection evCon = makeConnection(listener.slot);
+
+    if (m_fireDepth > 0)
+        m_pendingListeners.push_back(listener); // don't change m_listeners while iterating over it
+    else
+    {
+        // from time to time remove listeners that were disconnected without the event being fired
+        if (m_table->numDeadSlots > m_listeners.size() / 2)
+            removeDeadListeners();
+        m_listeners.push_back(listener);
+    }
+    // Return the connection (listener must keep this object, else it will be unregistered later on)
     return evCon;
 }
 
-template <typename ArgType>
-void EVENT1::fire(ArgType arg)
+template <typename Func>
+void EventListenerList<Func>::endFire()
 {
-    for (typename FunctionList::iterator it = m_listenerFuncs.begin(); it != m_listenerFuncs.end();)
+    if (hasDeadListeners())
+        removeDeadListeners();
+    if (!m_pendingListeners.empty())
     {
-        typename FunctionList::iterator cur_pos = it++;
-        if (!cur_pos->second.isValid())
-            m_listenerFuncs.erase(cur_pos);
-        else
-            (cur_pos->first)(arg); // call the function
+        for (size_t i = 0; i < m_pendingListeners.size(); ++i)
+        {
+            if (isListenerAlive(m_pendingListeners[i].slot))
+            {
+                m_listeners.push_back(Listener());
+                m_listeners.back().func.swap(m_pendingListeners[i].func);
+                m_listeners.back().slot = m_pendingListeners[i].slot;
+            }
+            else
+                freeSlot(m_pendingListeners[i].slot);
+        }
+        m_pendingListeners.clear();
     }
 }
 
-template <typename ArgType>
-void EVENT1::unregisterListener(typename FunctionList::iterator pos)
+// Removes the dead listeners and keeps the order of the others
+template <typename Func>
+void EventListenerList<Func>::removeDeadListeners()
 {
-    m_listenerFuncs.erase(pos);
+    size_t numAlive = 0;
+    for (size_t i = 0; i < m_listeners.size(); ++i)
+    {
+        if (isListenerAlive(m_listeners[i].slot))
+        {
+            if (i != numAlive)
+            {
+                m_listeners[numAlive].func.swap(m_listeners[i].func); // swap doesn't allocate
+                std::swap(m_listeners[numAlive].slot, m_listeners[i].slot);
+            }
+            ++numAlive;
+        }
+    }
+    for (size_t i = numAlive; i < m_listeners.size(); ++i)
+        freeSlot(m_listeners[i].slot);
+    m_listeners.resize(numAlive);
 }
 
-// same thing for 2 arguments
-#define EVENT2 Event2<ArgType1, ArgType2>
+// for 1 argument
+#define EVENT1 Event1<ArgType>
 
-template <typename ArgType1, typename ArgType2>
-EventConnection EVENT2::registerListener(Function func)
+template <typename ArgType>
+void EVENT1::fire(ArgType arg)
 {
-    EventConnection evCon;
-    m_listenerFuncs.insert( m_listenerFuncs.end(), std::make_pair(func,evCon) );
-    return evCon;
+    typename EVENT1::FireScope scope (*this);
+    for (size_t i = 0; i < this->m_listeners.size(); ++i)
+    {
+        if (this->isListenerAlive(this->m_listeners[i].slot))
+            this->m_listeners[i].func(arg); // call the function
+    }
 }
 
+// same thing for 2 arguments
+#define EVENT2 Event2<ArgType1, ArgType2>
+
 template <typename ArgType1, typename ArgType2>
 void EVENT2::fire(ArgType1 arg1,ArgType2 arg2)
 {
-    for (typename FunctionList::iterator it = m_listenerFuncs.begin(); it != m_listenerFuncs.end();)
+    typename EVENT2::FireScope scope (*this);
+    for (size_t i = 0; i < this->m_listeners.size(); ++i)
     {
-        typename FunctionList::iterator cur_pos = it++;
-        if (!cur_pos->second.isValid())
-            m_listenerFuncs.erase(cur_pos);
-        else
-            (cur_pos->first)(arg1,arg2); // call the function
+        if (this->isListenerAlive(this->m_listeners[i].slot))
+            this->m_listeners[i].func(arg1,arg2); // call the function
     }
 }
 
-template <typename ArgType1, typename ArgType2>
-void EVENT2::unregisterListener(typename FunctionList::iterator pos)
-{
-    m_listenerFuncs.erase(pos);
-}
-
-// same thing for 2 arguments
+// same thing for 3 arguments
 #define EVENT3 Event3<ArgType1, ArgType2, ArgType3>
 
-template <typename ArgType1, typename ArgType2, typename ArgType3>
-EventConnection EVENT3::registerListener(Function func)
-{
-    EventConnection evCon;
-    m_listenerFuncs.insert( m_listenerFuncs.end(), std::make_pair(func,evCon) );
-    return evCon;
-}
-
 template <typename ArgType1, typename ArgType2, typename ArgType3>
 void EVENT3::fire(ArgType1 arg1,ArgType2 arg2,ArgType3 arg3)
 {
-    for (typename FunctionList::iterator it = m_listenerFuncs.begin(); it != m_listenerFuncs.end();)
+    typename EVENT3::FireScope scope (*this);
+    for (size_t i = 0; i < this->m_listeners.size(); ++i)
     {
-        typename FunctionList::iterator cur_pos = it++;
-        if (!cur_pos->second.isValid())
-            m_listenerFuncs.erase(cur_pos);
-        else
-            (cur_pos->first)(arg1,arg2,arg3); // call the function
+        if (this->isListenerAlive(this->m_listeners[i].slot))
+            this->m_listeners[i].func(arg1,arg2,arg3); // call the function
     }
 }
-
-template <typename ArgType1, typename ArgType2, typename ArgType3>
-void EVENT3::unregisterListener(typename FunctionList::iterator pos)
-{
-    m_listenerFuncs.erase(pos);
-}
@@ -9,6 +9,7 @@
 #include "Logger.h"
 #include "Renderer.h"
 #include "Foreach.h"
+#include "Profiler.h"
 
 #include <utility>
 #include <FTGL/ftgl.h>
@@ -48,7 +49,7 @@ void FontManager::loadFont(const std::string& fileName, float sizeF, unsigned in
 
     /*if ( m_fonts.count( id )==1 )
     {
-        log(Warning) << "Loading font: ID '" << id << "' exists already, new font was not loaded\n";
+        AA_LOG(Warning) << "Loading font: ID '" << id << "' exists already, new font was not loaded\n";
         return;
     }*/ // reloadFonts uses this method
 
@@ -58,7 +59,7 @@ void FontManager::loadFont(const std::string& fileName, float sizeF, unsigned in
     // If something went wrong, return
     if(ftglFont->Error())
     {
-        log(Error) << "Error loading font <" << fileName << ">\n";
+        AA_LOG(Error) << "Error loading font <" << fileName << ">\n";
         return;
     }
 
@@ -81,6 +82,7 @@ void FontManager::freeFont(const FontId& id)
 
 void FontManager::drawString(const std::string &str, const FontId &fontId, float x, float y, Align horizAlign, Align vertAlign, float red, float green, float blue, float alpha )
 {
+    PROFILE_ZONE("FontManager::drawString");
     FontMap::iterator font_it = m_fonts.find( fontId );
     assert ( font_it != m_fonts.end() );
 
@@ -134,7 +136,7 @@ void FontManager::getDimensions(const std::string &text, const FontId &fontId, f
     FontMap::const_iterator font_it = m_fonts.find( fontId );
     if ( font_it == m_fonts.end() )
     {
-        log(Warning) << "FontManager::getDimension: font '" << fontId << "'\n";
+        AA_LOG(Warning) << "FontManager::getDimension: font '" << fontId << "'\n";
         return;
     }
 
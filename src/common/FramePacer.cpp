@@ -0,0 +1,75 @@
+/*
+ * FramePacer.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "FramePacer.h"
+
+#include "common/Clock.h"
+#include "common/Profiler.h"
+
+namespace {
+
+const unsigned int cDefaultMaxFps = 120;
+const unsigned int cDefaultIdleFps = 10;
+// Sleep() wacht etwa so viel zu spät auf (die Zeitgeber von Windows und Linux haben ungefähr 1ms Auflösung)
+const boost::uint64_t cDefaultSpinTimeNs = 1500000;
+
+}
+
+FramePacer::FramePacer()
+: m_maxFps (cDefaultMaxFps),
+  m_idleFps (cDefaultIdleFps),
+  m_spinTimeNs (cDefaultSpinTimeNs),
+  m_frameStart (getMonotonicTimeNs()),
+  m_deadline (m_frameStart),
+  m_stats ()
+{
+}
+
+void FramePacer::endFrame(bool idle)
+{
+    PROFILE_ZONE("FramePacer::endFrame");
+    boost::uint64_t now = getMonotonicTimeNs();
+    m_stats.workNs += now - m_frameStart;
+    ++m_stats.numFrames;
+
+    unsigned int fps = idle && m_idleFps != 0 ? m_idleFps : m_maxFps;
+    if (fps == 0)
+    {
+        // keine Grenze, aber den Rest der Zeitscheibe abgeben, damit andere Threads nicht warten müssen
+        sleepNs(0);
+        boost::uint64_t afterYield = getMonotonicTimeNs();
+        m_stats.sleepNs += afterYield - now;
+        m_frameStart = m_deadline = afterYield;
+        return;
+    }
+
+    boost::uint64_t period = 1000000000 / fps;
+    m_deadline += period;
+    if (m_deadline < now)
+        m_deadline = now; // zu spät, nicht aufholen
+
+    while (now + m_spinTimeNs < m_deadline)
+    {
+        sleepNs(m_deadline - m_spinTimeNs - now);
+        boost::uint64_t afterSleep = getMonotonicTimeNs();
+        m_stats.sleepNs += afterSleep - now;
+        now = afterSleep;
+    }
+
+    boost::uint64_t spinStart = now;
+    while (now < m_deadline)
+        now = getMonotonicTimeNs();
+    m_stats.spinNs += now - spinStart;
+
+    m_frameStart = now;
+}
+
+FramePacer::Stats FramePacer::takeStats()
+{
+    Stats stats = m_stats;
+    m_stats = Stats();
+    return stats;
+}
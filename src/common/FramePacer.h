@@ -0,0 +1,61 @@
+/*
+ * FramePacer.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Begrenzt die Bildrate der Hauptschleife, ohne einen Prozessorkern voll auszulasten
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <boost/cstdint.hpp>
+
+// FramePacer
+// ----------
+// Call endFrame() once at the end of every main loop iteration. It waits until the next frame
+// should start: first by sleeping (the OS may wake us up late), then for the last spinTime by
+// busy waiting so that the frame starts on time. The deadlines are kept on a fixed grid so the
+// average rate matches the cap even if single sleeps overshoot. If a frame took too long, the
+// next one starts immediately (no catching up).
+// In idle mode (window without focus or minimized) the loop runs at the much lower idle rate.
+class FramePacer
+{
+public:
+    // how the time was spent since the last takeStats()
+    class Stats
+    {
+    public:
+        Stats() : numFrames (0), workNs (0), sleepNs (0), spinNs (0) {}
+        unsigned int numFrames;
+        boost::uint64_t workNs;  // time between the end of the wait and the next endFrame()
+        boost::uint64_t sleepNs; // time given back to the OS
+        boost::uint64_t spinNs;  // time busy waiting for the deadline
+
+        boost::uint64_t getTotalNs() const { return workNs + sleepNs + spinNs; }
+    };
+
+    FramePacer();
+
+    void setMaxFps(unsigned int maxFps) { m_maxFps = maxFps; }   // 0: no limit (only yields, but still idles)
+    void setIdleFps(unsigned int idleFps) { m_idleFps = idleFps; } // 0: don't idle
+    void setSpinTimeNs(boost::uint64_t spinTimeNs) { m_spinTimeNs = spinTimeNs; }
+    unsigned int getMaxFps() const { return m_maxFps; }
+    unsigned int getIdleFps() const { return m_idleFps; }
+
+    void endFrame(bool idle);
+
+    Stats takeStats();
+
+private:
+    unsigned int m_maxFps;
+    unsigned int m_idleFps;
+    boost::uint64_t m_spinTimeNs;
+
+    boost::uint64_t m_frameStart; // end of the last wait
+    boost::uint64_t m_deadline;   // start of the last frame on the grid
+
+    Stats m_stats;
+};
+
+#endif
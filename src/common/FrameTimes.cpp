@@ -0,0 +1,95 @@
+/*
+ * FrameTimes.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "FrameTimes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+const size_t cFrameTimeSamples = 600;
+
+FrameTimeHistogram::FrameTimeHistogram(size_t numSamples)
+: m_maxSamples (std::max(numSamples, (size_t)1)),
+  m_samples (),
+  m_next (0)
+{
+    m_samples.reserve(m_maxSamples);
+}
+
+void FrameTimeHistogram::add(boost::uint64_t ns)
+{
+    if (m_samples.size() < m_maxSamples)
+    {
+        m_samples.push_back(ns);
+        return;
+    }
+    m_samples[m_next] = ns;
+    m_next = (m_next + 1) % m_maxSamples;
+}
+
+void FrameTimeHistogram::clear()
+{
+    m_samples.clear();
+    m_next = 0;
+}
+
+boost::uint64_t FrameTimeHistogram::getPercentile(float percent) const
+{
+    if (m_samples.empty())
+        return 0;
+    size_t rank = (size_t)std::ceil(percent / 100.0f * m_samples.size());
+    rank = std::min(std::max(rank, (size_t)1), m_samples.size());
+    std::vector<boost::uint64_t> sorted (m_samples);
+    std::nth_element(sorted.begin(), sorted.begin() + (rank - 1), sorted.end());
+    return sorted[rank - 1];
+}
+
+boost::uint64_t FrameTimeHistogram::getMax() const
+{
+    if (m_samples.empty())
+        return 0;
+    return *std::max_element(m_samples.begin(), m_samples.end());
+}
+
+namespace {
+
+void writeRow(std::ostream& out, const char* name, const FrameTimeHistogram& histogram)
+{
+    out << std::setw(8) << name
+        << std::setw(10) << histogram.getPercentile(50.0f) / 1e6
+        << std::setw(10) << histogram.getPercentile(95.0f) / 1e6
+        << std::setw(10) << histogram.getPercentile(99.0f) / 1e6
+        << std::setw(10) << histogram.getMax() / 1e6 << "\n";
+}
+
+}
+
+void FrameTimes::write(std::ostream& out) const
+{
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "Frame times of the last " << frame.getNumSamples() << " frames (ms)\n";
+    out << std::setw(8) << "" << std::setw(10) << "p50" << std::setw(10) << "p95"
+        << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    writeRow(out, "frame", frame);
+    writeRow(out, "update", update);
+    writeRow(out, "draw", draw);
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool FrameTimes::writeToFile(const std::string& fileName) const
+{
+    std::ofstream out (fileName.c_str());
+    if (!out)
+        return false;
+    write(out);
+    return true;
+}
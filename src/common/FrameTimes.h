@@ -0,0 +1,57 @@
+/*
+ * FrameTimes.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Verteilung der Frame-Zeiten der letzten Sekunden (um Ruckler zu finden, nicht nur die mittleren FPS)
+
+#ifndef FRAMETIMES_H
+#define FRAMETIMES_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+// Number of frames kept for the statistics (about 10 seconds at 60 FPS)
+extern const size_t cFrameTimeSamples;
+
+// FrameTimeHistogram
+// ------------------
+// Keeps the last numSamples durations in a ring buffer, older ones are overwritten.
+// The percentiles are only computed when asked for (e.g. when dumping), adding is O(1).
+class FrameTimeHistogram
+{
+public:
+    explicit FrameTimeHistogram(size_t numSamples = cFrameTimeSamples);
+
+    void add(boost::uint64_t ns);
+    void clear();
+
+    size_t getNumSamples() const { return m_samples.size(); }
+    // smallest duration so that percent % of the samples are not longer (nearest rank), 0 if empty
+    boost::uint64_t getPercentile(float percent) const;
+    boost::uint64_t getMax() const;
+
+private:
+    size_t m_maxSamples;
+    std::vector<boost::uint64_t> m_samples;
+    size_t m_next; // where the next sample goes once the buffer is full
+};
+
+// whole frame and how much of it was spent updating and drawing
+class FrameTimes
+{
+public:
+    FrameTimes() : frame (), update (), draw () {}
+
+    FrameTimeHistogram frame;
+    FrameTimeHistogram update; // all updates of a frame together
+    FrameTimeHistogram draw;   // including the buffer swap
+
+    void write(std::ostream& out) const; // table with p50/p95/p99/max in milliseconds
+    bool writeToFile(const std::string& fileName) const;
+};
+
+#endif
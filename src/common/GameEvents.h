@@ -12,11 +12,24 @@
 #include "common/Event.h"
 #include "IdTypes.h"
 #include <string>
+#include <utility>
 #include <boost/function.hpp>
 
 class Component;
 class CompShape;
 
+// key of variableUpdate
+typedef std::pair<EntityId, ComponentId> VariableKey;
+
+// unordered pair of entities (key of entityContact), use makeEntityPair
+typedef std::pair<EntityId, EntityId> EntityPair;
+inline EntityPair makeEntityPair(const EntityId& a, const EntityId& b)
+{
+    return b < a ? EntityPair(b, a) : EntityPair(a, b);
+}
+
+typedef Event2<CompShape&, CompShape&> ContactEvent;
+
 class GameEvents {
 public:
     // A new entity is being created
@@ -37,6 +50,10 @@ public:
     // Is called for each component when an entity is deleted
     Event1<Component&> deleteComponent;
 
+    // The data of a component was changed from outside of the game (e.g. by the editor with loadFromPropertyTree)
+    // Systems that keep something computed from the component (geometry, bounding boxes) update it
+    Event1<Component&> componentChanged;
+
     // The player finished the current level
     // Args: has the player won?, level end message
     Event2<bool, const std::string&> levelEnd;
@@ -47,7 +64,11 @@ public:
 
     // Two shapes have touched each other
     // Note: multiple events can be created per touch
-    Event2<CompShape&, CompShape&> newContact;
+    ContactEvent newContact;
+
+    // Same as newContact, but only for the listeners of these two entities
+    // Key: makeEntityPair(entity of shape 1, entity of shape 2)
+    KeyedEvent<EntityPair, ContactEvent> entityContact;
 
     // When a new message will be displayed
     // Args: message, amount of time (-1 for standard)
@@ -55,8 +76,9 @@ public:
 
     // A CompVariable has been updated
     // Note that the value did possibly not change
-    // Args: entity ID, component ID (variable name), updated value
-    Event3<const EntityId&, const ComponentId&, int> variableUpdate;
+    // Key: entity ID, component ID (variable name)
+    // Arg: updated value
+    KeyedEvent<VariableKey, Event1<int> > variableUpdate;
 
     // Request to make a variable modification
     // Args: entity ID, component ID (variable name), function to modify value
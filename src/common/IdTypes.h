@@ -7,14 +7,21 @@
 #ifndef IDTYPES_H
 #define IDTYPES_H
 
+#include "Symbol.h"
 #include <string>
 
 typedef std::string ConditionId;
 typedef std::string EffectId;
 
-typedef std::string ComponentTypeId;
+// interned, so comparing IDs is cheap
+typedef Symbol ComponentTypeId;
 
-typedef std::string EntityId;
-typedef std::string ComponentId;
+typedef Symbol EntityId;
+typedef Symbol ComponentId;
+
+// Integer handles used by the ComponentManager for fast lookups (no string compares).
+// Entity handles are only valid while the entity exists and may be reused afterwards.
+typedef unsigned int EntityHandle;
+typedef unsigned int ComponentTypeHandle;
 
 #endif /* IDTYPES_H */
@@ -0,0 +1,139 @@
+/*
+ * LevelLoader.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "LevelLoader.h"
+
+#include "Clock.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+#include <exception>
+#include <boost/bind.hpp>
+#include <SDL.h>
+
+namespace {
+
+// Anteil von DataLoader::loadEntities am Fortschritt, der Rest ist commit()
+const float cLoadProgressShare = 0.8f;
+
+}
+
+LevelLoader::LevelLoader(const std::vector<std::string>& fileNames, GameEvents& events)
+: m_fileNames (fileNames),
+  m_events (events),
+  m_entities (),
+  m_errorMsg (),
+  m_loadProgress (0.0f),
+  m_loaded (false),
+  m_cancel (false),
+  m_numCommitted (0),
+  m_mutex (SDL_CreateMutex()),
+  m_thread (NULL)
+{
+    DataLoader::initComponentTypeIds();
+    m_thread = SDL_CreateThread(&LevelLoader::threadFunction, this);
+    if (m_thread == NULL)
+    {
+        AA_LOG(Warning) << "Could not create level loading thread, loading synchronously\n";
+        load();
+    }
+}
+
+LevelLoader::~LevelLoader()
+{
+    SDL_mutexP(m_mutex);
+    m_cancel = true;
+    SDL_mutexV(m_mutex);
+    if (m_thread)
+        SDL_WaitThread(m_thread, NULL);
+    SDL_DestroyMutex(m_mutex);
+}
+
+int LevelLoader::threadFunction(void* loader)
+{
+    LogThreadScope logScope;
+    static_cast<LevelLoader*>(loader)->load();
+    return 0;
+}
+
+void LevelLoader::load()
+{
+    PROFILE_ZONE("LevelLoader::load");
+    std::string errorMsg;
+    try
+    {
+        for (size_t i = 0; i < m_fileNames.size(); ++i)
+        {
+            if (!DataLoader::loadEntities(m_fileNames[i], m_entities, m_events, boost::bind(&LevelLoader::onProgress, this, i, _1, _2)))
+                break; // abgebrochen
+        }
+    }
+    catch (DataLoadException& e)
+    {
+        errorMsg = e.getMsg();
+    }
+    catch (std::exception& e)
+    {
+        errorMsg = e.what();
+    }
+
+    SDL_mutexP(m_mutex);
+    m_errorMsg = errorMsg;
+    m_loadProgress = 1.0f;
+    m_loaded = true;
+    SDL_mutexV(m_mutex);
+}
+
+bool LevelLoader::onProgress(size_t fileIndex, size_t numLoaded, size_t numTotal)
+{
+    float fileProgress = numTotal ? (float)numLoaded / numTotal : 1.0f;
+
+    SDL_mutexP(m_mutex);
+    m_loadProgress = (fileIndex + fileProgress) / m_fileNames.size();
+    bool cancel = m_cancel;
+    SDL_mutexV(m_mutex);
+    return !cancel;
+}
+
+bool LevelLoader::isLoaded() const
+{
+    SDL_mutexP(m_mutex);
+    bool loaded = m_loaded;
+    SDL_mutexV(m_mutex);
+    return loaded;
+}
+
+bool LevelLoader::commit(ComponentManager& compMgr, boost::uint64_t maxTimeNs)
+{
+    if (!isLoaded() || hasFailed())
+        return false;
+
+    PROFILE_ZONE("LevelLoader::commit");
+    boost::uint64_t startNs = getMonotonicTimeNs();
+    while (m_numCommitted < m_entities.size())
+    {
+        LoadedEntity& entity = m_entities[m_numCommitted++];
+        compMgr.addEntity(entity.id, entity.components);
+        entity.components.clear(); // gehören jetzt dem ComponentManager
+
+        if (getMonotonicTimeNs() - startNs >= maxTimeNs)
+            break;
+    }
+    return m_numCommitted == m_entities.size();
+}
+
+float LevelLoader::getProgress() const
+{
+    SDL_mutexP(m_mutex);
+    float loadProgress = m_loadProgress;
+    bool loaded = m_loaded;
+    SDL_mutexV(m_mutex);
+
+    float commitProgress = 0.0f;
+    if (loaded)
+        commitProgress = m_entities.empty() ? 1.0f : (float)m_numCommitted / m_entities.size();
+    return cLoadProgressShare * loadProgress + (1.0f - cLoadProgressShare) * commitProgress;
+}
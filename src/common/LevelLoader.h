@@ -0,0 +1,73 @@
+/*
+ * LevelLoader.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Lädt Level in einem eigenen Thread, damit das Spiel währenddessen einen Ladebalken zeigen kann.
+
+#ifndef LEVELLOADER_H
+#define LEVELLOADER_H
+
+#include "DataLoader.h"
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+struct SDL_Thread;
+struct SDL_mutex;
+
+/*
+    Der Thread liest die Dateien und erzeugt die Komponenten (DataLoader::loadEntities), registriert
+    sie aber nicht. Das macht commit() im Hauptthread, in Stücken von höchstens maxTimeNs pro Aufruf,
+    damit die Systeme (Physik, Renderer...) nur von einem Thread verwendet werden.
+
+    Die Komponenten werden mit events erzeugt und registrieren dabei Listener (variableUpdate und
+    entityContact). Diese Events dürfen im Hauptthread nicht verwendet werden, bis isLoaded() true ist.
+*/
+class LevelLoader
+{
+public:
+    // startet den Thread, die Dateien werden der Reihe nach geladen
+    LevelLoader(const std::vector<std::string>& fileNames, GameEvents& events);
+    ~LevelLoader(); // bricht ab und wartet auf den Thread
+
+    // true, wenn der Thread fertig ist (auch bei einem Fehler)
+    bool isLoaded() const;
+    // nur gültig wenn isLoaded()
+    bool hasFailed() const { return !m_errorMsg.empty(); }
+    const std::string& getErrorMsg() const { return m_errorMsg; }
+
+    // Registriert geladene Entities, bis maxTimeNs vergangen ist (mindestens eine).
+    // Gibt true zurück, wenn alle Entities registriert sind.
+    bool commit(ComponentManager& compMgr, boost::uint64_t maxTimeNs);
+
+    // Fortschritt von 0 bis 1 (laden und registrieren)
+    float getProgress() const;
+
+private:
+    LevelLoader(const LevelLoader&);
+    LevelLoader& operator = (const LevelLoader&);
+
+    static int threadFunction(void* loader);
+    void load();
+    bool onProgress(size_t fileIndex, size_t numLoaded, size_t numTotal);
+
+    std::vector<std::string> m_fileNames;
+    GameEvents& m_events;
+
+    // vom Thread geschrieben (geschützt durch m_mutex bis m_loaded gesetzt ist)
+    std::vector<LoadedEntity> m_entities;
+    std::string m_errorMsg;
+    float m_loadProgress;
+    bool m_loaded;
+    bool m_cancel;
+
+    size_t m_numCommitted; // nur Hauptthread
+
+    SDL_mutex* m_mutex;
+    SDL_Thread* m_thread;
+};
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * LevelSnapshot.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "LevelSnapshot.h"
+
+#include "ComponentManager.h"
+#include "DataLoader.h"
+#include "Foreach.h"
+#include "Profiler.h"
+
+#include <vector>
+#include <boost/property_tree/ptree.hpp>
+
+namespace {
+
+// für Fehlermeldungen
+const char* const cSnapshotName = "level snapshot";
+
+}
+
+LevelSnapshot::LevelSnapshot(const ComponentManager& compMgr)
+: m_data (),
+  m_level ()
+{
+    PROFILE_ZONE("LevelSnapshot::LevelSnapshot");
+    boost::property_tree::ptree levelPropTree;
+    DataLoader::writeWorld(compMgr, levelPropTree);
+    BinaryLevel::serialize(levelPropTree, m_data);
+    m_level.open(m_data.data(), m_data.size(), cSnapshotName);
+}
+
+void LevelSnapshot::restore(ComponentManager& compMgr, GameEvents& events) const
+{
+    PROFILE_ZONE("LevelSnapshot::restore");
+    std::vector<LoadedEntity> entities;
+    entities.reserve(getNumEntities());
+    DataLoader::loadEntities(m_level, cSnapshotName, entities, events);
+    foreach (LoadedEntity& entity, entities)
+        compMgr.addEntity(entity.id, entity.components);
+}
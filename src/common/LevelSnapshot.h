@@ -0,0 +1,43 @@
+/*
+ * LevelSnapshot.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Kopie einer geladenen Welt im Speicher, um ein Level ohne Dateien neu zu starten.
+
+#ifndef LEVELSNAPSHOT_H
+#define LEVELSNAPSHOT_H
+
+#include "BinaryLevel.h"
+
+#include <string>
+
+class ComponentManager;
+class GameEvents;
+
+/*
+    Speichert die Daten aller Komponenten (wie DataLoader::saveWorld) im Format von BinaryLevel,
+    aber in einem Buffer. restore() erzeugt daraus neue Komponenten, ohne eine Datei zu lesen
+    oder eine INFO-Datei zu parsen.
+*/
+class LevelSnapshot
+{
+public:
+    explicit LevelSnapshot(const ComponentManager& compMgr);
+
+    // adds the entities to compMgr (which should be empty)
+    void restore(ComponentManager& compMgr, GameEvents& events) const;
+
+    size_t getNumEntities() const { return m_level.getNumChildren(m_level.getRoot()); }
+    size_t getSize() const { return m_data.size(); } // bytes
+
+private:
+    LevelSnapshot(const LevelSnapshot&);
+    LevelSnapshot& operator = (const LevelSnapshot&);
+
+    std::string m_data;
+    BinaryLevel m_level; // reads from m_data
+};
+
+#endif
@@ -9,9 +9,20 @@
 #include "common/Foreach.h"
 
 #include <ctime>
+#include <list>
 #include <iostream>
 #include <boost/make_shared.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <SDL.h>
+
+#ifdef _MSC_VER
+#  include <windows.h>
+#  define LOGGER_THREAD_LOCAL __declspec(thread)
+#else
+#  define LOGGER_THREAD_LOCAL __thread
+#endif
+
+using LoggerDetail::ThreadState;
 
 namespace {
 LogLevel strToLogLevel(std::string str)
@@ -30,13 +41,233 @@ std::string getCurrentTimeStr()
     time_t t = time(NULL);
     return ctime(&t);
 }
+
+// one or more complete lines
+class LogRecord
+{
+public:
+    LogRecord() : next (NULL), level (Off), text () {}
+    LogRecord* volatile next;
+    LogLevel level;
+    std::string text;
+};
+
+#ifdef _MSC_VER
+inline LogRecord* atomicExchange(LogRecord* volatile* target, LogRecord* value)
+{
+    return static_cast<LogRecord*>(InterlockedExchangePointer(reinterpret_cast<void* volatile*>(target), value));
+}
+// volatile has acquire/release semantics with MSVC
+inline LogRecord* atomicLoad(LogRecord* volatile const* source) { return *source; }
+inline void atomicStore(LogRecord* volatile* target, LogRecord* value) { *target = value; }
+#else
+inline LogRecord* atomicExchange(LogRecord* volatile* target, LogRecord* value)
+{
+    return __atomic_exchange_n(target, value, __ATOMIC_ACQ_REL);
+}
+inline LogRecord* atomicLoad(LogRecord* volatile const* source) { return __atomic_load_n(source, __ATOMIC_ACQUIRE); }
+inline void atomicStore(LogRecord* volatile* target, LogRecord* value) { __atomic_store_n(target, value, __ATOMIC_RELEASE); }
+#endif
+
+// LogQueue
+// --------
+// Intrusive queue with many producers and one consumer (after Dmitry Vyukov).
+// push() never blocks or waits for an other thread, it is one atomic exchange.
+// pop() must only be called by one thread at a time (callers hold the handler mutex).
+class LogQueue
+{
+public:
+    LogQueue() : m_head (&m_stub), m_tail (&m_stub), m_stub () {}
+
+    void push(LogRecord* record)
+    {
+        record->next = NULL;
+        LogRecord* previous = atomicExchange(&m_head, record);
+        atomicStore(&previous->next, record);
+    }
+
+    // NULL if the queue is empty or the next record is still being pushed
+    LogRecord* pop()
+    {
+        LogRecord* tail = m_tail;
+        LogRecord* next = atomicLoad(&tail->next);
+        if (tail == &m_stub)
+        {
+            if (next == NULL)
+                return NULL;
+            m_tail = next;
+            tail = next;
+            next = atomicLoad(&next->next);
+        }
+        if (next)
+        {
+            m_tail = next;
+            return tail;
+        }
+        if (tail != atomicLoad(&m_head))
+            return NULL; // a push is in progress
+        // tail is the last record, put the stub behind it to be able to take it out
+        push(&m_stub);
+        next = atomicLoad(&tail->next);
+        if (next)
+        {
+            m_tail = next;
+            return tail;
+        }
+        return NULL;
+    }
+
+private:
+    LogRecord* volatile m_head; // last pushed record
+    LogRecord* m_tail;          // next record to pop
+    LogRecord m_stub;
+};
+
+class LoggerState
+{
+public:
+    LoggerState();
+    ~LoggerState();
+
+    SDL_mutex* handlerMutex; // protects the handlers, only one thread at a time takes records out of the queue
+    std::list<boost::shared_ptr<LogHandler> > handlers;
+    LogQueue queue;
+    SDL_Thread* writerThread;
+    SDL_sem* recordsAvailable; // posted after every push, the writer thread sleeps on it while the queue is empty
+    bool stopWriter;
+};
+
+LoggerState& loggerState()
+{
+    static LoggerState state;
+    return state;
+}
+
+// wird beim Laden des Programms aufgerufen, damit der Zustand nicht gleichzeitig von zwei Threads erstellt wird
+LoggerState& gInitLoggerState = loggerState();
+
+// set by LogThreadScope or created at the first AA_LOG() in a thread
+LOGGER_THREAD_LOCAL ThreadState* tThreadState = NULL;
+
+// write the records in the queue to the handlers, call with the handler mutex locked
+size_t writeRecords(LoggerState& state)
+{
+    size_t numRecords = 0;
+    while (LogRecord* record = state.queue.pop())
+    {
+        foreach(boost::shared_ptr<LogHandler> handler, state.handlers)
+            handler->writeFilter(record->level, record->text);
+        delete record;
+        ++numRecords;
+    }
+    if (numRecords != 0)
+    {
+        foreach(boost::shared_ptr<LogHandler> handler, state.handlers)
+            handler->flush();
+    }
+    return numRecords;
+}
+
+int writerThreadFunction(void* data)
+{
+    LoggerState& state = *static_cast<LoggerState*>(data);
+    for (;;)
+    {
+        // a post can be left over from records that were already written, then the loop just runs once more
+        SDL_SemWait(state.recordsAvailable);
+        SDL_mutexP(state.handlerMutex);
+        bool stop = state.stopWriter; // read first, so that everything logged before stopping gets written
+        writeRecords(state);
+        SDL_mutexV(state.handlerMutex);
+        if (stop)
+            break;
+    }
+    return 0;
+}
+
+// call with the handler mutex locked
+void updateMaxHandlerLevel(LoggerState& state)
+{
+    int maxLevel = -1;
+    foreach(boost::shared_ptr<LogHandler> handler, state.handlers)
+        maxLevel = std::max(maxLevel, (int)handler->getLevel());
+    LoggerDetail::gMaxHandlerLevel = maxLevel;
+}
+
+LoggerState::LoggerState()
+: handlerMutex (SDL_CreateMutex()),
+  handlers (),
+  queue (),
+  writerThread (NULL),
+  recordsAvailable (SDL_CreateSemaphore(0)),
+  stopWriter (false)
+{
+}
+
+LoggerState::~LoggerState()
+{
+    if (writerThread)
+    {
+        SDL_mutexP(handlerMutex);
+        stopWriter = true;
+        SDL_mutexV(handlerMutex);
+        SDL_SemPost(recordsAvailable);
+        SDL_WaitThread(writerThread, NULL);
+        writerThread = NULL;
+    }
+    writeRecords(*this);
+    SDL_DestroySemaphore(recordsAvailable);
+    LoggerDetail::gMaxHandlerLevel = -1;
+    handlers.clear();
+}
+
 } // end namespace
 
-Logger& log(LogLevel level)
+namespace LoggerDetail {
+
+volatile int gMaxHandlerLevel = -1;
+
+ThreadState* beginRecord(LogLevel level)
+{
+    if (tThreadState == NULL)
+        tThreadState = new ThreadState; // without LogThreadScope it lives till the end of the program
+    if (level < tThreadState->level)
+        tThreadState->level = level;
+    return tThreadState;
+}
+
+void endRecord(ThreadState& threadState)
 {
-    static Logger log;
-    log.setLevel(level);
-    return log;
+    std::string text = threadState.stream.str();
+    size_t end = text.rfind('\n');
+    if (end == std::string::npos)
+        return; // wait for the rest of the line
+
+    LogRecord* record = new LogRecord;
+    LogLevel level = threadState.level;
+    record->level = level;
+    if (end + 1 == text.size())
+    {
+        record->text.swap(text);
+        threadState.stream.str(std::string());
+        threadState.level = Off;
+    }
+    else
+    {
+        // keep the incomplete line (with its level)
+        record->text = text.substr(0, end + 1);
+        threadState.stream.str(text.substr(end + 1));
+        threadState.stream.seekp(0, std::ios_base::end);
+    }
+
+    LoggerState& state = loggerState();
+    state.queue.push(record); // the writer thread may delete the record from now on
+    if (level == Fatal || state.writerThread == NULL)
+        flushLog();
+    else
+        SDL_SemPost(state.recordsAvailable);
+}
+
 }
 
 void setUpLoggerFromPropTree(boost::property_tree::ptree& ptree)
@@ -59,55 +290,70 @@ void setUpLoggerFromPropTree(boost::property_tree::ptree& ptree)
     if (consoleLevel != Off)
     {
         boost::shared_ptr<ConsoleHandler> console = boost::make_shared<ConsoleHandler>();
-        log(consoleLevel).addHandler(console);
+        addLogHandler(console, consoleLevel);
     }
     if (fileLevel != Off)
     {
         boost::shared_ptr<FileHandler> file = boost::make_shared<FileHandler>(fileName);
-        log(fileLevel).addHandler(file);
+        addLogHandler(file, fileLevel);
     }
 }
 
-Logger::Logger(bool buffered)
-: std::ostream (&m_stringBuf),
-  m_stringBuf (*this)
+void addLogHandler(boost::shared_ptr<LogHandler> handler, LogLevel level)
 {
-    if (!buffered)
-        setf(std::ios::unitbuf); // set to unbuffered
+    LoggerState& state = loggerState();
+    SDL_mutexP(state.handlerMutex);
+    handler->setLevel(level);
+    state.handlers.push_back(handler);
+    updateMaxHandlerLevel(state);
+    if (state.writerThread == NULL)
+    {
+        // if the thread (or its semaphore) can't be created, every line is written right away
+        if (state.recordsAvailable)
+            state.writerThread = SDL_CreateThread(&writerThreadFunction, &state);
+    }
+    SDL_mutexV(state.handlerMutex);
 }
 
-void Logger::addHandler(boost::shared_ptr<LogHandler> handler)
+void removeLogHandler(boost::shared_ptr<LogHandler> handler)
 {
-    handler->setLevel(m_logLevel);
-    m_handlers.push_back(handler);
+    LoggerState& state = loggerState();
+    SDL_mutexP(state.handlerMutex);
+    writeRecords(state); // the lines logged so far should still go to this handler
+    state.handlers.remove(handler);
+    updateMaxHandlerLevel(state);
+    SDL_mutexV(state.handlerMutex);
 }
 
-void Logger::setLevel(LogLevel level)
+void flushLog()
 {
-    m_logLevel = level;
+    LoggerState& state = loggerState();
+    SDL_mutexP(state.handlerMutex);
+    writeRecords(state);
+    SDL_mutexV(state.handlerMutex);
 }
 
-void Logger::writeHeader(const std::string& str)
+void LogStream::writeHeader(const std::string& str)
 {
     *this << "*** " << str << " ***" << "\nStart: " << getCurrentTimeStr() << "-------------------------------\n\n";
 }
 
-Logger::LoggerStringBuf::LoggerStringBuf(const Logger& logger)
-: m_logger (logger)
-{}
+LogThreadScope::LogThreadScope()
+: m_state (new ThreadState),
+  m_previousState (tThreadState)
+{
+    tThreadState = m_state;
+}
 
-// synchronize output
-int Logger::LoggerStringBuf::sync()
+LogThreadScope::~LogThreadScope()
 {
-    if (!str().empty())
+    if (!m_state->stream.str().empty())
     {
-        foreach(boost::shared_ptr<LogHandler> handler, m_logger.m_handlers)
-        {
-            handler->writeFilter(m_logger.m_logLevel, str());
-        }
-        str("");
+        m_state->stream << "\n"; // incomplete last line
+        LoggerDetail::endRecord(*m_state);
     }
-    return 0;
+    tThreadState = m_previousState;
+    delete m_state;
 }
 
 LogHandler::LogHandler()
@@ -132,6 +378,10 @@ OstreamHandler::OstreamHandler(std::ostream& ostream)
 void OstreamHandler::write(const std::string& str)
 {
     m_ostream << str;
+}
+
+void OstreamHandler::flush()
+{
     m_ostream.flush();
 }
 
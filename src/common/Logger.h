@@ -9,7 +9,6 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
-#include <list>
 #include <string>
 #include <fstream>
 #include <ostream>
@@ -22,11 +21,23 @@ namespace boost { namespace property_tree {
     typedef basic_ptree<std::string, std::string, std::less<std::string> > ptree;
 }}
 
-class Logger;
-
 enum LogLevel { Fatal, Error, Warning, Info, Detail, Debug, Off };
 
-Logger& log(LogLevel level);
+// Höchste Stufe, die überhaupt kompiliert wird. Mit z.B. -DAA_LOG_MAX_LEVEL=Info
+// fallen alle AA_LOG(Detail) und AA_LOG(Debug) Ausgaben schon beim Kompilieren weg.
+#ifndef AA_LOG_MAX_LEVEL
+#  define AA_LOG_MAX_LEVEL Debug
+#endif
+
+class LogStream;
+class LogHandler;
+
+// Usage: AA_LOG(Info) << "Loaded " << n << " textures\n";
+// Only whole lines are written. Text without a newline at the end is kept until the rest of
+// the line is logged in the same thread.
+// If the level is disabled the rest of the statement (including the arguments) is not evaluated,
+// so don't put side effects into a log statement. The if/else form is safe in an unbraced if.
+#define AA_LOG(level) if (!::LoggerDetail::isEnabled(level)) ; else ::LogStream(level)
 
 /*
  * Prop tree structure:
@@ -38,33 +49,103 @@ Logger& log(LogLevel level);
  */
 void setUpLoggerFromPropTree(boost::property_tree::ptree&);
 
-class LogHandler;
+// Handlers get all lines with a level up to (and including) level.
+// The handlers are written by the writer thread, they must not be used by anything else.
+void addLogHandler(boost::shared_ptr<LogHandler> handler, LogLevel level);
+void removeLogHandler(boost::shared_ptr<LogHandler> handler);
+
+// write all lines logged so far to the handlers before returning (AA_LOG(Fatal) does this too)
+void flushLog();
+
+namespace LoggerDetail {
+
+// per thread: the line that is being formatted
+class ThreadState
+{
+public:
+    ThreadState() : stream (), level (Off) {}
+    std::ostringstream stream;
+    LogLevel level; // most important level of the text in stream
+};
+
+// highest level of all handlers (-1 if there are none), nothing above is formatted
+extern volatile int gMaxHandlerLevel;
+
+ThreadState* beginRecord(LogLevel level);
+void endRecord(ThreadState& state);
+
+inline bool isEnabled(LogLevel level)
+{
+    return level <= AA_LOG_MAX_LEVEL && (int)level <= gMaxHandlerLevel;
+}
+
+}
 
 /*
-    Diese Klasse kann Texte in einer Log-Datei speichern.
+    Wird von AA_LOG() erzeugt und nimmt den Text einer Anweisung auf.
+    AA_LOG() only creates it if the level is enabled (for levels above AA_LOG_MAX_LEVEL the
+    compiler removes the whole statement).
+    The text goes into a lock-free queue when the statement ends, a background thread writes
+    it to the handlers. It is safe to log from any thread.
 */
-
-class Logger : public std::ostream
+class LogStream
 {
 public:
-    Logger(bool buffered=false);
-    void addHandler(boost::shared_ptr<LogHandler> handler);
-    void setLevel(LogLevel level);
+    explicit LogStream(LogLevel level)
+    : m_state (LoggerDetail::isEnabled(level) ? LoggerDetail::beginRecord(level) : NULL)
+    {}
+    // a copy takes over the statement
+    LogStream(const LogStream& other) : m_state (other.m_state) { other.m_state = NULL; }
+    ~LogStream()
+    {
+        if (m_state)
+            LoggerDetail::endRecord(*m_state);
+    }
+
+    template <typename T>
+    LogStream& operator << (const T& value)
+    {
+        if (m_state)
+            m_state->stream << value;
+        return *this;
+    }
+    // manipulators like std::endl and std::hex
+    LogStream& operator << (std::ostream& (*manipulator)(std::ostream&))
+    {
+        if (m_state)
+            m_state->stream << manipulator;
+        return *this;
+    }
+    LogStream& operator << (std::ios_base& (*manipulator)(std::ios_base&))
+    {
+        if (m_state)
+            m_state->stream << manipulator;
+        return *this;
+    }
+
     void writeHeader(const std::string& str); // writes a formatted header containing str and the current time
 
 private:
+    LogStream& operator=(const LogStream&);
+
+    mutable LoggerDetail::ThreadState* m_state; // NULL if the level is disabled
+};
+
+/*
+    Every thread that logs gets its own line buffer. A worker thread should create a LogThreadScope
+    so that the buffer is freed and an incomplete last line is written when the thread is done.
+*/
+class LogThreadScope
+{
+public:
+    LogThreadScope();
+    ~LogThreadScope();
+private:
+    LogThreadScope(const LogThreadScope&);
+    LogThreadScope& operator=(const LogThreadScope&);
 
-    std::list<boost::shared_ptr<LogHandler> > m_handlers;
-
-    class LoggerStringBuf : public std::stringbuf {
-    public:
-        LoggerStringBuf(const Logger& logger);
-        int sync();
-    private:
-        const Logger& m_logger;
-    };
-    LoggerStringBuf m_stringBuf;
-    LogLevel m_logLevel;
+    LoggerDetail::ThreadState* m_state;
+    LoggerDetail::ThreadState* m_previousState;
 };
 
 class LogHandler {
@@ -72,7 +153,9 @@ public:
     LogHandler();
     virtual ~LogHandler() {}
     void setLevel(LogLevel);
+    LogLevel getLevel() const { return m_filterLevel; }
     void writeFilter(LogLevel, const std::string&);
+    virtual void flush() {} // called after a batch of lines was written
 protected:
     virtual void write(const std::string&) = 0;
 private:
@@ -83,6 +166,7 @@ class OstreamHandler : public LogHandler {
 public:
     OstreamHandler(std::ostream& ostream);
     void write(const std::string&);
+    void flush();
 private:
     std::ostream& m_ostream;
 };
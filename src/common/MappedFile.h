@@ -0,0 +1,44 @@
+/*
+ * MappedFile.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Datei in den Speicher einblenden (mmap), z.B. für kompilierte Levels
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // returns false if the file could not be mapped (an already open file is closed first)
+    bool open(const std::string& fileName);
+    void close();
+
+    bool isOpen() const { return m_data != NULL; }
+    const char* getData() const { return m_data; }
+    size_t getSize() const { return m_size; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator = (const MappedFile&);
+
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#else
+    int m_file;
+#endif
+    const char* m_data;
+    size_t m_size;
+};
+
+#endif
@@ -17,9 +17,9 @@
 #include "common/Vector2D.h"
 #include "common/Foreach.h"
 #include "common/Logger.h"
+#include "common/Profiler.h"
 
 #include <boost/bind.hpp>
-#include <boost/make_shared.hpp>
 #include <Box2D/Box2D.h>
 #include <algorithm>
 
@@ -39,9 +39,25 @@ public:
       CompShape* shape1 = static_cast<CompShape*>(contact->GetFixtureA()->GetUserData());
       CompShape* shape2 = static_cast<CompShape*>(contact->GetFixtureB()->GetUserData());
       contacts.push_back(std::make_pair(shape1, shape2));
+      touchingChanged(contact);
+  }
+
+  void EndContact(b2Contact* contact)
+  {
+      touchingChanged(contact);
   }
 
   std::list<std::pair<CompShape*, CompShape*> > contacts;
+  // bodies that began or stopped touching (the PhysicsSystem checks if one of them is a gravitation field)
+  std::vector<std::pair<CompPhysics*, CompPhysics*> > touchChanges;
+
+private:
+  void touchingChanged(b2Contact* contact)
+  {
+      CompPhysics* phys1 = static_cast<CompPhysics*>(contact->GetFixtureA()->GetBody()->GetUserData());
+      CompPhysics* phys2 = static_cast<CompPhysics*>(contact->GetFixtureB()->GetBody()->GetUserData());
+      touchChanges.push_back(std::make_pair(phys1, phys2));
+  }
 };
 
 ContactListener contactListener;
@@ -50,7 +66,8 @@ ContactListener contactListener;
 PhysicsSystem::PhysicsSystem(GameEvents& gameEvents)
 : m_eventConnection1 (), m_eventConnection2 (), m_gameEvents ( gameEvents ),
   m_world (b2Vec2(0.0f, 0.0f)),
-  m_rootGravField ("rootGravField", m_gameEvents)
+  m_rootGravField ("rootGravField", m_gameEvents),
+  m_worldIndex (m_gameEvents)
 {
     m_rootGravField.setGravType(CompGravField::Directional);
     m_rootGravField.setGravDir(Vector2D(0.0f, -25.0f));
@@ -62,24 +79,25 @@ PhysicsSystem::PhysicsSystem(GameEvents& gameEvents)
 }
 
 // helper function
-boost::shared_ptr<b2BodyDef> convertToB2BodyDef(const BodyDef& bodyDef)
+b2BodyDef convertToB2BodyDef(const BodyDef& bodyDef)
 {
-    boost::shared_ptr<b2BodyDef> pB2BodyDef = boost::make_shared<b2BodyDef>();
-    pB2BodyDef->angle = bodyDef.angle;
-    pB2BodyDef->angularDamping = bodyDef.angularDamping;
-    pB2BodyDef->angularVelocity = bodyDef.angularVelocity;
-    pB2BodyDef->bullet = bodyDef.bullet;
-    pB2BodyDef->fixedRotation = bodyDef.fixedRotation;
-    pB2BodyDef->linearDamping = bodyDef.linearDamping;
-    pB2BodyDef->linearVelocity = *bodyDef.linearVelocity.to_b2Vec2();
-    pB2BodyDef->position = *bodyDef.position.to_b2Vec2();
-    pB2BodyDef->type = b2_staticBody;
-    return pB2BodyDef;
+    b2BodyDef def;
+    def.angle = bodyDef.angle;
+    def.angularDamping = bodyDef.angularDamping;
+    def.angularVelocity = bodyDef.angularVelocity;
+    def.bullet = bodyDef.bullet;
+    def.fixedRotation = bodyDef.fixedRotation;
+    def.linearDamping = bodyDef.linearDamping;
+    def.linearVelocity = bodyDef.linearVelocity.to_b2Vec2();
+    def.position = bodyDef.position.to_b2Vec2();
+    def.type = b2_staticBody;
+    return def;
 }
 
 // PhysicsSubSystem aktualisieren (ganze Physik wird aktulisiert -> Positionen, Geschwindigkeiten...)
 void PhysicsSystem::update()
 {
+    PROFILE_ZONE("PhysicsSystem::update");
     foreach(CompPhysics* compPhys, m_physicsComps)
     {
         compPhys->m_previousCenterOfMass = compPhys->getCenterOfMass();
@@ -91,60 +109,29 @@ void PhysicsSystem::update()
     m_world.Step(cPhysicsTimeStep, PHYS_ITERATIONS, PHYS_ITERATIONS);
     //----------------------------//
 
+    updateGravFieldContacts();
 
     foreach(CompPhysics* compPhys, m_physicsComps)
     {
         b2Body* pBody = compPhys->m_body;
 
-        CompPosition* compPos = compPhys->getSiblingComponent<CompPosition>();
+        CompPosition* compPos = compPhys->m_compPosition;
         if (compPos)
         {
-            compPos->m_position = compPhys->getPosition();
-            compPos->m_orientation = compPhys->getAngle();
-        }
-
-        int highestPriority = 0;
-        CompGravField* gravWithHighestPriority = &m_rootGravField;
-        b2ContactEdge* contact = pBody->GetContactList();
-        for (;contact;contact=contact->next)
-        {
-            b2Body* body = contact->other;
-            CompPhysics* compContact = static_cast<CompPhysics*>(body->GetUserData());
-            assert (compContact != NULL);
-            CompGravField* grav = compContact->getSiblingComponent<CompGravField>();
-            // check if this contact is a grav field or not
-            if (grav == NULL)
-                continue;
-            Vector2D gravPoint = compPhys->m_localGravitationPoint.rotated(pBody->GetAngle());
-
-            for (b2Fixture* fixture = compContact->m_body->GetFixtureList();
-                 fixture != NULL;
-                 fixture = fixture->GetNext())
-            {
-                if ( fixture->TestPoint( pBody->GetPosition() + *gravPoint.to_b2Vec2() ) )
-                {
-                    int pri = grav->getPriority();
-                    if ( pri > highestPriority )
-                    {
-                        highestPriority = pri;
-                        gravWithHighestPriority = grav;
-                    }
-                }
-            }
-        }
-
-        if ( compPhys->m_nUpdatesSinceGravFieldChange >= cUpdatesTillGravFieldChangeIsPossible )
-        {
-            if ( compPhys->m_gravField != gravWithHighestPriority )
+            Vector2D position = compPhys->getPosition();
+            float orientation = compPhys->getAngle();
+            // nur bewegte Körper im WorldIndex verschieben (vor den Kontakt-Events, die Listener können den Index abfragen)
+            if (position != compPos->m_position || orientation != compPos->m_orientation)
             {
-                compPhys->m_gravField = gravWithHighestPriority;
-                compPhys->m_nUpdatesSinceGravFieldChange = 0;
+                compPos->m_position = position;
+                compPos->m_orientation = orientation;
+                m_worldIndex.updatePosition(*compPos);
             }
         }
 
-        Vector2D gravForce = compPhys->m_gravField->getAcceleration(pBody->GetWorldCenter());
-        gravForce *= pBody->GetMass();
-        pBody->ApplyForce(*gravForce.to_b2Vec2(), pBody->GetWorldCenter(), true);
+        // static and kinematic bodies are not affected by forces, sleeping bodies are at rest
+        if (pBody->GetType() == b2_dynamicBody && pBody->IsAwake())
+            applyGravitation(*compPhys);
 
         compPhys->m_nUpdatesSinceGravFieldChange++;
     }
@@ -155,24 +142,24 @@ void PhysicsSystem::update()
         next = it; next++;
         CompPathMove* compPathMove = *it;
 
-        CompPath* compPath    = compPathMove->getSiblingComponent<CompPath>(compPathMove->getPathId());
-        CompPosition* compPos = compPathMove->getSiblingComponent<CompPosition>();
-        CompPhysics* compPhys = compPathMove->getSiblingComponent<CompPhysics>();
+        CompPath* compPath    = compPathMove->m_compPath;
+        CompPosition* compPos = compPathMove->m_compPosition;
+        CompPhysics* compPhys = compPathMove->m_compPhysics;
         if (compPath == NULL)
         {
-            log(Warning) << "Entity '" << compPathMove->getEntityId() << "': CompPathMove needs CompPath component"
+            AA_LOG(Warning) << "Entity '" << compPathMove->getEntityId() << "': CompPathMove needs CompPath component"
                          << (compPathMove->getPathId() == "" ? "" : " with ID '" + compPathMove->getPathId() + "'")
                          << "\n";
             continue;
         }
         else if (compPos == NULL)
         {
-            log(Warning) << "Entity '" << compPathMove->getEntityId() << "': CompPathMove needs CompPosition component\n";
+            AA_LOG(Warning) << "Entity '" << compPathMove->getEntityId() << "': CompPathMove needs CompPosition component\n";
             continue;
         }
         else if (compPhys == NULL)
         {
-            log(Warning) << "Entity '" << compPathMove->getEntityId() << "': CompPathMove needs CompPhysics component\n";
+            AA_LOG(Warning) << "Entity '" << compPathMove->getEntityId() << "': CompPathMove needs CompPhysics component\n";
             continue;
         }
 
@@ -187,7 +174,102 @@ void PhysicsSystem::update()
     foreach(contact, contactListener.contacts)
     {
         m_gameEvents.newContact.fire(*contact.first, *contact.second);
+        if (ContactEvent* entityContact = m_gameEvents.entityContact.find(makeEntityPair(contact.first->getEntityId(), contact.second->getEntityId())))
+            entityContact->fire(*contact.first, *contact.second);
+    }
+}
+
+// mark the bodies that began or stopped touching a gravitation field
+void PhysicsSystem::updateGravFieldContacts()
+{
+    typedef std::pair<CompPhysics*, CompPhysics*> PhysPair;
+    foreach (const PhysPair& touch, contactListener.touchChanges)
+    {
+        if (touch.second->m_ownGravField)
+            touch.first->m_gravFieldContactsChanged = true;
+        if (touch.first->m_ownGravField)
+            touch.second->m_gravFieldContactsChanged = true;
+    }
+    contactListener.touchChanges.clear();
+}
+
+// Gravitationsfeld mit der höchsten Priorität am Gravitationspunkt des Körpers suchen (sonst m_rootGravField)
+const CompGravField* PhysicsSystem::findGravField(CompPhysics& compPhys)
+{
+    b2Body* pBody = compPhys.m_body;
+    if (compPhys.m_gravFieldContactsChanged)
+    {
+        compPhys.m_gravFieldContacts.clear();
+        compPhys.m_gravFieldContactsMove = false;
+        compPhys.m_foundGravField = NULL;
+        for (b2ContactEdge* contact = pBody->GetContactList(); contact; contact = contact->next)
+        {
+            const CompPhysics* compContact = static_cast<const CompPhysics*>(contact->other->GetUserData());
+            assert (compContact != NULL);
+            // check if this contact is a grav field or not
+            if (compContact->m_ownGravField == NULL || !contact->contact->IsTouching())
+                continue;
+            // a body can touch several fixtures of the same field
+            if (std::find(compPhys.m_gravFieldContacts.begin(), compPhys.m_gravFieldContacts.end(), compContact) == compPhys.m_gravFieldContacts.end())
+            {
+                compPhys.m_gravFieldContacts.push_back(compContact);
+                if (compContact->m_body->GetType() != b2_staticBody)
+                    compPhys.m_gravFieldContactsMove = true;
+            }
+        }
+        compPhys.m_gravFieldContactsChanged = false;
+    }
+
+    int highestPriority = 0;
+    const CompGravField* gravWithHighestPriority = &m_rootGravField;
+    if (compPhys.m_gravFieldContacts.empty())
+        return gravWithHighestPriority;
+
+    b2Vec2 gravPoint = pBody->GetPosition() + compPhys.m_localGravitationPoint.rotated(pBody->GetAngle()).to_b2Vec2();
+    // the body can move into or out of a field it keeps touching, so only a point that stayed put keeps its field
+    if (compPhys.m_foundGravField && !compPhys.m_gravFieldContactsMove && compPhys.m_foundGravFieldPoint == Vector2D(gravPoint))
+        return compPhys.m_foundGravField;
+
+    foreach (const CompPhysics* compContact, compPhys.m_gravFieldContacts)
+    {
+        const CompGravField* grav = compContact->m_ownGravField;
+        if (grav == NULL || grav->getPriority() <= highestPriority)
+            continue;
+        for (b2Fixture* fixture = compContact->m_body->GetFixtureList();
+             fixture != NULL;
+             fixture = fixture->GetNext())
+        {
+            if ( fixture->TestPoint( gravPoint ) )
+            {
+                highestPriority = grav->getPriority();
+                gravWithHighestPriority = grav;
+                break;
+            }
+        }
     }
+    compPhys.m_foundGravField = gravWithHighestPriority;
+    compPhys.m_foundGravFieldPoint = Vector2D(gravPoint);
+    return gravWithHighestPriority;
+}
+
+void PhysicsSystem::applyGravitation(CompPhysics& compPhys)
+{
+    // kurz nach einem Wechsel darf das Feld noch nicht wieder ändern, dann muss es auch nicht gesucht werden
+    if ( compPhys.m_nUpdatesSinceGravFieldChange >= cUpdatesTillGravFieldChangeIsPossible )
+    {
+        const CompGravField* gravWithHighestPriority = findGravField(compPhys);
+        if ( compPhys.m_gravField != gravWithHighestPriority )
+        {
+            compPhys.m_gravField = gravWithHighestPriority;
+            compPhys.m_nUpdatesSinceGravFieldChange = 0;
+        }
+    }
+
+    b2Body* pBody = compPhys.m_body;
+    Vector2D gravForce = compPhys.m_gravField->getAcceleration(pBody->GetWorldCenter());
+    gravForce *= pBody->GetMass();
+    // don't wake up the body, so that it can fall asleep when it is at rest
+    pBody->ApplyForce(gravForce.to_b2Vec2(), pBody->GetWorldCenter(), false);
 }
 
 bool PhysicsSystem::updatePathMove(CompPathMove& compPathMove, CompPhysics& compPhys, const CompPosition& compPos, const CompPath& compPath)
@@ -222,7 +304,7 @@ bool PhysicsSystem::updatePathMove(CompPathMove& compPathMove, CompPhysics& comp
             if (compPathMove.m_updateCount <= compPathMove.m_numUpdatesToAccelerate) // we are speeding up
             {
                 compPhys.m_body->SetLinearVelocity(
-                        *(Vector2D(compPhys.m_body->GetLinearVelocity()) + compPathMove.m_detalLinearVelocity).to_b2Vec2()
+                        (Vector2D(compPhys.m_body->GetLinearVelocity()) + compPathMove.m_detalLinearVelocity).to_b2Vec2()
                     );
                 compPhys.m_body->SetAngularVelocity(
                         compPhys.m_body->GetAngularVelocity() + compPathMove.m_detalAngularVelocity
@@ -231,7 +313,7 @@ bool PhysicsSystem::updatePathMove(CompPathMove& compPathMove, CompPhysics& comp
             else if (compPathMove.m_updateCount >= compPathMove.m_numUpdatesToNextPoint - compPathMove.m_numUpdatesToAccelerate) // we are slowing down
             {
                 compPhys.m_body->SetLinearVelocity(
-                        *(Vector2D(compPhys.m_body->GetLinearVelocity()) - compPathMove.m_detalLinearVelocity).to_b2Vec2()
+                        (Vector2D(compPhys.m_body->GetLinearVelocity()) - compPathMove.m_detalLinearVelocity).to_b2Vec2()
                     );
                 compPhys.m_body->SetAngularVelocity(
                         compPhys.m_body->GetAngularVelocity() - compPathMove.m_detalAngularVelocity
@@ -326,7 +408,7 @@ void PhysicsSystem::setNewTarget(CompPathMove& compPathMove, CompPhysics& compPh
         break;
     }
 
-    compPhys.m_body->SetLinearVelocity(*(posDiff.getUnitVector()*linearVelocity).to_b2Vec2());
+    compPhys.m_body->SetLinearVelocity((posDiff.getUnitVector()*linearVelocity).to_b2Vec2());
     compPhys.m_body->SetAngularVelocity(angularVelocity);
 
     compPathMove.m_numUpdatesToNextPoint = timeToFinish/cPhysicsTimeStep;
@@ -334,6 +416,7 @@ void PhysicsSystem::setNewTarget(CompPathMove& compPathMove, CompPhysics& compPh
 
 void PhysicsSystem::calculateSmoothPositions(float accumulator)
 {
+    PROFILE_ZONE("PhysicsSystem::calculateSmoothPositions");
     float ratio = accumulator/cPhysicsTimeStep;
     foreach(CompPhysics* compPhys, m_physicsComps)
     {
@@ -377,7 +460,7 @@ void PhysicsSystem::onUnregisterComp(Component& component)
 void PhysicsSystem::onRegisterCompPhys(CompPhysics& compPhys)
 {
     // get position from CompPosition, if it exists, else 0,0/0
-    CompPosition* compPos = compPhys.getSiblingComponent<CompPosition>();
+    CompPosition* compPos = compPhys.m_compPosition;
     if (compPos)
     {
         compPhys.m_bodyDef.position = compPos->m_position;
@@ -385,32 +468,45 @@ void PhysicsSystem::onRegisterCompPhys(CompPhysics& compPhys)
         compPos->m_compPhysics = &compPhys;
     }
 
-    compPhys.m_body = m_world.CreateBody( convertToB2BodyDef(compPhys.m_bodyDef).get() );
+    b2BodyDef bodyDef = convertToB2BodyDef(compPhys.m_bodyDef);
+    compPhys.m_body = m_world.CreateBody( &bodyDef );
     compPhys.m_body->SetUserData( &compPhys );
 
     compPhys.m_gravField = &m_rootGravField;
 
     foreach (boost::shared_ptr<ShapeDef> shapeInfo, compPhys.m_shapeInfos)
     {
-        boost::shared_ptr<b2FixtureDef> fixtureDef = boost::make_shared<b2FixtureDef>();
+        b2FixtureDef fixtureDef;
 
         CompShape* pCompShape = compPhys.getSiblingComponent<CompShape>(shapeInfo->compId);
         if (!pCompShape)
         {
-            log(Warning) << "Shape component '" << shapeInfo->compId << "' not found. Ignoring shape.\n";
+            AA_LOG(Warning) << "Shape component '" << shapeInfo->compId << "' not found. Ignoring shape.\n";
             continue;
         }
 
-        boost::shared_ptr<b2Shape> pB2Shape = pCompShape->toB2Shape(); // this object has to live till Box2D has made a copy of it in createFixture
-        fixtureDef->shape = pB2Shape.get();
-        fixtureDef->density = shapeInfo->density;
+        // these objects have to live till Box2D has made a copy of the shape in createFixture
+        b2PolygonShape polygonShape;
+        b2CircleShape circleShape;
+        switch (pCompShape->getType())
+        {
+        case CompShape::Polygon:
+            static_cast<CompShapePolygon*>(pCompShape)->toB2Shape(polygonShape);
+            fixtureDef.shape = &polygonShape;
+            break;
+        case CompShape::Circle:
+            static_cast<CompShapeCircle*>(pCompShape)->toB2Shape(circleShape);
+            fixtureDef.shape = &circleShape;
+            break;
+        }
+        fixtureDef.density = shapeInfo->density;
         if (shapeInfo->density != 0.0f)
             compPhys.m_body->SetType(b2_dynamicBody);
-        fixtureDef->friction = shapeInfo->friction;
-        fixtureDef->restitution = shapeInfo->restitution;
-        fixtureDef->isSensor = shapeInfo->isSensor;
-        fixtureDef->filter.maskBits = 1;
-        b2Fixture* pFixture = compPhys.m_body->CreateFixture( fixtureDef.get() );
+        fixtureDef.friction = shapeInfo->friction;
+        fixtureDef.restitution = shapeInfo->restitution;
+        fixtureDef.isSensor = shapeInfo->isSensor;
+        fixtureDef.filter.maskBits = 1;
+        b2Fixture* pFixture = compPhys.m_body->CreateFixture( &fixtureDef );
         pFixture->SetUserData( pCompShape );
         compPhys.m_fixtureMap.insert( std::make_pair(pCompShape->getId(), pFixture) );
     }
@@ -430,9 +526,11 @@ void PhysicsSystem::onUnregisterCompPhys(CompPhysics& compPhys)
     {
         m_world.DestroyBody( compPhys.m_body );
         compPhys.m_body = NULL;
+        // DestroyBody ends the contacts, they must not refer to this component later
+        updateGravFieldContacts();
     }
 
-    CompPosition* compPos = compPhys.getSiblingComponent<CompPosition>();
+    CompPosition* compPos = compPhys.m_compPosition;
     if (compPos)
         compPos->m_compPhysics = NULL;
 
@@ -442,11 +540,16 @@ void PhysicsSystem::onUnregisterCompPhys(CompPhysics& compPhys)
 void PhysicsSystem::onRegisterCompGrav(CompGravField& compGrav)
 {
     m_gravFields.push_back( &compGrav );
+    // the body of the field may already touch others
+    foreach (CompPhysics* compPhys, m_physicsComps)
+        compPhys->m_gravFieldContactsChanged = true;
 }
 
 void PhysicsSystem::onUnregisterCompGrav(CompGravField& compGrav)
 {
     m_gravFields.erase(std::find(m_gravFields.begin(), m_gravFields.end(), &compGrav));
+    foreach (CompPhysics* compPhys, m_physicsComps)
+        compPhys->m_gravFieldContactsChanged = true;
 }
 
 
@@ -454,9 +557,9 @@ void PhysicsSystem::onRegisterCompPathMove(CompPathMove& compPathMove)
 {
     m_pathMoves.push_back(&compPathMove);
 
-    CompPhysics*  compPhys = compPathMove.getSiblingComponent<CompPhysics>();
-    CompPosition* compPos  = compPathMove.getSiblingComponent<CompPosition>();
-    CompPath*     compPath = compPathMove.getSiblingComponent<CompPath>();
+    CompPhysics*  compPhys = compPathMove.m_compPhysics;
+    CompPosition* compPos  = compPathMove.m_compPosition;
+    CompPath*     compPath = compPathMove.m_compPath;
     assert(compPhys != NULL); assert(compPos  != NULL); assert(compPath != NULL);
 
     compPhys->m_body->SetType(b2_kinematicBody);
@@ -468,40 +571,11 @@ void PhysicsSystem::onUnregisterCompPathMove(CompPathMove& compPathMove)
     m_pathMoves.erase(std::find(m_pathMoves.begin(), m_pathMoves.end(), &compPathMove));
 }
 
-namespace {
-class QueryCallback: public b2QueryCallback
-{
-public:
-    CompShape* query(const b2World& world, const b2Vec2& point)
-    {
-        comp = NULL;
-        testPoint = point;
-        b2AABB aabb = { point, point };
-        world.QueryAABB(this, aabb);
-        return comp;
-    }
-
-    bool ReportFixture(b2Fixture* fixture)
-    {
-        if (fixture->TestPoint(testPoint))
-        {
-            comp = static_cast<CompShape*>(fixture->GetUserData());
-            return false;
-        }
-        else
-            return true; // continue the query?
-    }
-private:
-    CompShape* comp;
-    b2Vec2 testPoint;
-};
-
-QueryCallback queryCallback;
-}
-
 boost::optional<std::pair<EntityId, std::vector<const Component*> > > PhysicsSystem::selectEntity(const Vector2D& pos)
 {
-    CompShape* comp = queryCallback.query(m_world, *pos.to_b2Vec2());
+    std::vector<CompShape*> shapes;
+    m_worldIndex.queryPoint(pos, shapes);
+    CompShape* comp = shapes.empty() ? NULL : shapes.front();
     if (comp == NULL)
         return boost::optional<std::pair<EntityId, std::vector<const Component*> > >();
     else
@@ -10,6 +10,7 @@
 #define PHYSICS_H
 
 #include "common/Event.h"
+#include "common/WorldIndex.h"
 #include "common/components/CompGravField.h"
 #include <vector>
 #include <list>
@@ -34,6 +35,8 @@ public:
 
     void update();
     boost::optional<std::pair<EntityId, std::vector<const Component*> > > selectEntity(const Vector2D& pos);
+    // alle Formen der Welt nach Position (wird in update() nachgeführt)
+    const WorldIndex& getWorldIndex() const { return m_worldIndex; }
 
     void calculateSmoothPositions(float accumulator);
 
@@ -58,9 +61,14 @@ private:
     void setNewTarget(CompPathMove& compPathMove, CompPhysics& compPhys, const CompPosition& compPos, const CompPath& compPath, size_t point);
     bool updatePathMove(CompPathMove&, CompPhysics&, const CompPosition&, const CompPath&); // return true if the CompPathMove finished the move
 
+    void updateGravFieldContacts(); // mark the bodies whose gravitation field contacts changed since the last call
+    const CompGravField* findGravField(CompPhysics& compPhys);
+    void applyGravitation(CompPhysics& compPhys);
+
     b2World m_world;
 
     CompGravField m_rootGravField; // TODO: put this component in the manager?
+    WorldIndex m_worldIndex;
 };
 
 #endif
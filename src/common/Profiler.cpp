@@ -0,0 +1,159 @@
+/*
+ * Profiler.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "Profiler.h"
+
+#ifdef AA_PROFILE
+
+#include "Logger.h"
+#include "Foreach.h"
+
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <SDL.h>
+
+#ifdef _MSC_VER
+#  define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+#  define PROFILER_THREAD_LOCAL __thread
+#endif
+
+namespace {
+
+// Anzahl Zonen pro Thread (bei 60 FPS und ~50 Zonen pro Frame etwa 20 Sekunden)
+const size_t cRingBufferSize = 65536;
+
+class ZoneRecord
+{
+public:
+    const char* name;
+    boost::uint64_t startNs;
+    boost::uint64_t endNs;
+};
+
+// Wird nur vom eigenen Thread beschrieben
+class ThreadBuffer
+{
+public:
+    ThreadBuffer(unsigned int threadIndex) : zones (cRingBufferSize), next (0), wrapped (false), threadIndex (threadIndex) {}
+    std::vector<ZoneRecord> zones;
+    size_t next;
+    bool wrapped;
+    unsigned int threadIndex;
+};
+
+PROFILER_THREAD_LOCAL ThreadBuffer* tThreadBuffer = NULL;
+
+// alle Puffer (werden nie gelöscht, damit sie nach dem Ende eines Threads noch gespeichert werden können)
+std::vector<ThreadBuffer*>& getThreadBuffers()
+{
+    static std::vector<ThreadBuffer*> buffers;
+    return buffers;
+}
+
+SDL_mutex* getBuffersMutex()
+{
+    static SDL_mutex* mutex = SDL_CreateMutex();
+    return mutex;
+}
+
+// wird beim Laden des Programms aufgerufen, damit der Mutex nicht gleichzeitig von zwei Threads erstellt wird
+SDL_mutex* gInitMutex = getBuffersMutex();
+
+ThreadBuffer& getThreadBuffer()
+{
+    if (tThreadBuffer == NULL)
+    {
+        SDL_mutexP(getBuffersMutex());
+        tThreadBuffer = new ThreadBuffer((unsigned int)getThreadBuffers().size());
+        getThreadBuffers().push_back(tThreadBuffer);
+        SDL_mutexV(getBuffersMutex());
+    }
+    return *tThreadBuffer;
+}
+
+void writeZone(std::ofstream& out, const ZoneRecord& zone, unsigned int threadIndex, boost::uint64_t timeOriginNs, bool& first)
+{
+    if (!first)
+        out << ",\n";
+    first = false;
+    out << "{\"name\":\"";
+    for (const char* c = zone.name; *c != '\0'; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            out << '\\';
+        out << *c;
+    }
+    // Chrome erwartet Mikrosekunden
+    out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadIndex
+        << ",\"ts\":" << (zone.startNs - timeOriginNs) / 1000.0
+        << ",\"dur\":" << (zone.endNs - zone.startNs) / 1000.0 << "}";
+}
+
+}
+
+void Profiler::addZone(const char* name, boost::uint64_t startNs, boost::uint64_t endNs)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    ZoneRecord& zone = buffer.zones[buffer.next];
+    zone.name = name;
+    zone.startNs = startNs;
+    zone.endNs = endNs;
+    if (++buffer.next == buffer.zones.size())
+    {
+        buffer.next = 0;
+        buffer.wrapped = true;
+    }
+}
+
+// Die Puffer anderer Threads werden ohne Synchronisation gelesen, einzelne Zonen können also
+// unvollständig sein, falls diese Threads gleichzeitig messen.
+bool Profiler::writeChromeTrace(const std::string& fileName)
+{
+    std::ofstream out (fileName.c_str());
+    if (!out)
+    {
+        AA_LOG(Error) << "Could not write profiler trace to '" << fileName << "'\n";
+        return false;
+    }
+
+    SDL_mutexP(getBuffersMutex());
+    std::vector<ThreadBuffer*> buffers = getThreadBuffers();
+    SDL_mutexV(getBuffersMutex());
+
+    // Zeiten relativ zur ältesten Zone, damit die Zahlen klein bleiben
+    boost::uint64_t timeOriginNs = (boost::uint64_t)-1;
+    foreach (const ThreadBuffer* buffer, buffers)
+    {
+        size_t count = buffer->wrapped ? buffer->zones.size() : buffer->next;
+        for (size_t i = 0; i < count; ++i)
+            timeOriginNs = std::min(timeOriginNs, buffer->zones[i].startNs);
+    }
+
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    size_t numZones = 0;
+    foreach (const ThreadBuffer* buffer, buffers)
+    {
+        // älteste Einträge zuerst
+        if (buffer->wrapped)
+        {
+            for (size_t i = buffer->next; i < buffer->zones.size(); ++i)
+                writeZone(out, buffer->zones[i], buffer->threadIndex, timeOriginNs, first);
+            numZones += buffer->zones.size() - buffer->next;
+        }
+        for (size_t i = 0; i < buffer->next; ++i)
+            writeZone(out, buffer->zones[i], buffer->threadIndex, timeOriginNs, first);
+        numZones += buffer->next;
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    AA_LOG(Info) << "Wrote " << numZones << " profiler zones to '" << fileName << "'\n";
+    return true;
+}
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Profiler.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// CPU-Zeitmessung von Codeabschnitten ("Zonen"), z.B. PROFILE_ZONE("PhysicsSystem::update").
+// Jeder Thread schreibt in einen eigenen Ringpuffer, der als Chrome Trace (chrome://tracing)
+// gespeichert werden kann. Ohne AA_PROFILE werden die Makros zu nichts kompiliert.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef AA_PROFILE
+
+#include "common/Clock.h"
+
+#include <string>
+#include <boost/cstdint.hpp>
+
+#define PROFILE_CONCAT_IMPL(a, b) a ## b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+// misst die Zeit bis zum Ende des aktuellen Blocks (name muss ein String-Literal sein)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__) (name)
+// alle gespeicherten Zonen als Chrome Trace JSON speichern
+#define PROFILE_WRITE_TRACE(fileName) Profiler::writeChromeTrace(fileName)
+
+class Profiler
+{
+public:
+    // eine Zone im Puffer des aktuellen Threads speichern (alte Einträge werden überschrieben)
+    static void addZone(const char* name, boost::uint64_t startNs, boost::uint64_t endNs);
+    static bool writeChromeTrace(const std::string& fileName);
+};
+
+class ProfileZone
+{
+public:
+    ProfileZone(const char* name) : m_name (name), m_startNs (getMonotonicTimeNs()) {}
+    ~ProfileZone() { Profiler::addZone(m_name, m_startNs, getMonotonicTimeNs()); }
+private:
+    const char* m_name;
+    boost::uint64_t m_startNs;
+};
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_WRITE_TRACE(fileName) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,184 @@
+/*
+ * RenderBatch.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "RenderBatch.h"
+
+#include "common/Foreach.h"
+
+#include <cmath>
+#include <limits>
+#include <SDL_opengl.h>
+
+RenderBatch::RenderBatch()
+: m_batches (), m_lastKey (), m_lastBatch (NULL)
+{}
+
+void RenderBatch::clear()
+{
+    foreach (BatchMap::value_type& batch, m_batches)
+        batch.second.clear();
+}
+
+std::vector<BatchVertex>& RenderBatch::getBatch(const TextureId& tex, int layer)
+{
+    if (m_lastBatch == NULL || m_lastKey.first != layer || m_lastKey.second != tex)
+    {
+        m_lastKey = BatchKey(layer, tex);
+        m_lastBatch = &m_batches[m_lastKey];
+    }
+    return *m_lastBatch;
+}
+
+void RenderBatch::pushVertex(std::vector<BatchVertex>& batch, float x, float y, float u, float v, unsigned char alpha)
+{
+    BatchVertex vertex;
+    vertex.x = x;
+    vertex.y = y;
+    vertex.u = u;
+    vertex.v = v;
+    vertex.r = vertex.g = vertex.b = 255;
+    vertex.a = alpha;
+    batch.push_back(vertex);
+}
+
+void RenderBatch::addPolygon(const TextureId& tex, const Vector2D* vertices, const Vector2D* texCoords, size_t count,
+                             const BatchTransform& transform, int layer, float alpha)
+{
+    if (count < 3)
+        return;
+    std::vector<BatchVertex>& batch = getBatch(tex, layer);
+    unsigned char a = static_cast<unsigned char>(alpha * 255.0f);
+
+    // triangle fan: (0, i, i+1)
+    for (size_t i = 1; i + 1 < count; ++i)
+    {
+        const size_t triangle[3] = { 0, i, i+1 };
+        for (int k = 0; k < 3; ++k)
+        {
+            const Vector2D& vertex = vertices[triangle[k]];
+            float x, y;
+            transform.apply(vertex.x, vertex.y, &x, &y);
+            if (texCoords)
+                pushVertex(batch, x, y, texCoords[triangle[k]].x, texCoords[triangle[k]].y, a);
+            else
+                pushVertex(batch, x, y, vertex.x, -vertex.y, a);
+        }
+    }
+}
+
+void RenderBatch::addQuad(const TextureId& tex, const float texCoord[8], const float vertexCoord[8],
+                          const BatchTransform& transform, int layer, float alpha)
+{
+    std::vector<BatchVertex>& batch = getBatch(tex, layer);
+    unsigned char a = static_cast<unsigned char>(alpha * 255.0f);
+
+    // two triangles: (0,1,2) and (0,2,3)
+    const int order[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int k = 0; k < 6; ++k)
+    {
+        int n = order[k];
+        float x, y;
+        transform.apply(vertexCoord[2*n], vertexCoord[2*n+1], &x, &y);
+        pushVertex(batch, x, y, texCoord[2*n], texCoord[2*n+1], a);
+    }
+}
+
+void RenderBatch::addCircle(const TextureId& tex, const Vector2D& center, float radius, unsigned int slices,
+                            const BatchTransform& transform, int layer, float alpha)
+{
+    if (slices < 3 || radius <= 0.0f)
+        return;
+    std::vector<BatchVertex>& batch = getBatch(tex, layer);
+    unsigned char a = static_cast<unsigned char>(alpha * 255.0f);
+
+    // same texture coordinates as gluDisk, but Y flipped (gluDisk draws textures upside down)
+    const float angleStep = cPi * 2 / slices;
+    float cx, cy;
+    transform.apply(center.x, center.y, &cx, &cy);
+    for (unsigned int i = 0; i < slices; ++i)
+    {
+        float dx1 = std::cos(angleStep * i), dy1 = std::sin(angleStep * i);
+        float dx2 = std::cos(angleStep * (i+1)), dy2 = std::sin(angleStep * (i+1));
+        float x, y;
+
+        pushVertex(batch, cx, cy, 0.5f, -0.5f, a);
+        transform.apply(center.x + dx1*radius, center.y + dy1*radius, &x, &y);
+        pushVertex(batch, x, y, 0.5f + dx1*0.5f, -(0.5f + dy1*0.5f), a);
+        transform.apply(center.x + dx2*radius, center.y + dy2*radius, &x, &y);
+        pushVertex(batch, x, y, 0.5f + dx2*0.5f, -(0.5f + dy2*0.5f), a);
+    }
+}
+
+void RenderBatch::draw(TextureManager& texManager) const
+{
+    drawLayers(texManager, std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+}
+
+void RenderBatch::draw(TextureManager& texManager, int layer) const
+{
+    drawLayers(texManager, layer, layer);
+}
+
+void RenderBatch::drawLayers(TextureManager& texManager, int minLayer, int maxLayer) const
+{
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    foreach (const BatchMap::value_type& batch, m_batches)
+    {
+        const std::vector<BatchVertex>& vertices = batch.second;
+        int layer = batch.first.first;
+        if (vertices.empty() || layer < minLayer || layer > maxLayer)
+            continue;
+
+        const TextureId& tex = batch.first.second;
+        if (tex.empty())
+        {
+            texManager.clear();
+            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+        else
+        {
+            texManager.setTexture(tex);
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+            glTexCoordPointer(2, GL_FLOAT, sizeof(BatchVertex), &vertices[0].u);
+        }
+        glVertexPointer(2, GL_FLOAT, sizeof(BatchVertex), &vertices[0].x);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(BatchVertex), &vertices[0].r);
+
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+    }
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glColor4ub(255, 255, 255, 255);
+}
+
+size_t RenderBatch::getNumBatches() const
+{
+    size_t num = 0;
+    foreach (const BatchMap::value_type& batch, m_batches)
+        if (!batch.second.empty())
+            ++num;
+    return num;
+}
+
+size_t RenderBatch::getNumVertices() const
+{
+    size_t num = 0;
+    foreach (const BatchMap::value_type& batch, m_batches)
+        num += batch.second.size();
+    return num;
+}
+
+const std::vector<BatchVertex>* RenderBatch::getVertices(const TextureId& tex, int layer) const
+{
+    BatchMap::const_iterator it = m_batches.find(BatchKey(layer, tex));
+    if (it == m_batches.end() || it->second.empty())
+        return NULL;
+    return &it->second;
+}
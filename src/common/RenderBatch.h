@@ -0,0 +1,96 @@
+/*
+ * RenderBatch.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Sammelt Dreiecke nach Textur sortiert, damit sie mit wenigen Draw-Calls gezeichnet werden können
+
+#ifndef RENDERBATCH_H
+#define RENDERBATCH_H
+
+#include "common/Texture.h"
+#include "common/Vector2D.h"
+
+#include <map>
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+class BatchVertex
+{
+public:
+    float x, y;              // world coordinates (already transformed)
+    float u, v;              // texture coordinates (the texture scale is applied by the TextureManager when drawing)
+    unsigned char r, g, b, a;
+};
+
+// Rotation and translation applied to local coordinates (like glTranslatef + glRotatef)
+class BatchTransform
+{
+public:
+    BatchTransform(const Vector2D& position = Vector2D(), float angle = 0.0f)
+    : m_position (position), m_cos (std::cos(angle)), m_sin (std::sin(angle)) {}
+
+    void apply(float lx, float ly, float* wx, float* wy) const
+    {
+        *wx = m_position.x + m_cos*lx - m_sin*ly;
+        *wy = m_position.y + m_sin*lx + m_cos*ly;
+    }
+private:
+    Vector2D m_position;
+    float m_cos, m_sin;
+};
+
+/*
+    Geometry is added in local coordinates and stored transformed on the CPU,
+    grouped by layer and texture. draw() then binds each texture once and submits
+    all its triangles with a single glDrawArrays call (client side vertex arrays).
+    Layers are drawn in increasing order, so e.g. edges can be put over the fills.
+    Building the batch doesn't need OpenGL, only draw() does.
+*/
+class RenderBatch
+{
+public:
+    RenderBatch();
+
+    // remove all geometry (keeps the allocated memory for the next frame)
+    void clear();
+
+    // convex polygon (triangulated as a fan); texCoords may be NULL, then the local (x,-y) coordinates are used
+    void addPolygon(const TextureId& tex, const Vector2D* vertices, const Vector2D* texCoords, size_t count,
+                    const BatchTransform& transform, int layer = 0, float alpha = 1.0f);
+    // quad in the same format as RenderSystem::drawTexturedQuad
+    void addQuad(const TextureId& tex, const float texCoord[8], const float vertexCoord[8],
+                 const BatchTransform& transform, int layer = 0, float alpha = 1.0f);
+    // circle approximated by "slices" triangles, textured like gluDisk (with flipped Y)
+    void addCircle(const TextureId& tex, const Vector2D& center, float radius, unsigned int slices,
+                   const BatchTransform& transform, int layer = 0, float alpha = 1.0f);
+
+    // draw everything (one draw call per layer and texture); an empty TextureId means untextured
+    void draw(TextureManager& texManager) const;
+    // draw only one layer (to draw several batches layer by layer)
+    void draw(TextureManager& texManager, int layer) const;
+
+    // number of non-empty (layer, texture) groups, i.e. the number of draw calls
+    size_t getNumBatches() const;
+    size_t getNumVertices() const;
+    // triangles of one group (NULL if there are none)
+    const std::vector<BatchVertex>* getVertices(const TextureId& tex, int layer = 0) const;
+
+private:
+    typedef std::pair<int, TextureId> BatchKey;
+    typedef std::map<BatchKey, std::vector<BatchVertex> > BatchMap;
+    BatchMap m_batches;
+
+    // cache for the last used group (consecutive adds often use the same texture)
+    BatchKey m_lastKey;
+    std::vector<BatchVertex>* m_lastBatch;
+
+    std::vector<BatchVertex>& getBatch(const TextureId& tex, int layer);
+    void drawLayers(TextureManager& texManager, int minLayer, int maxLayer) const;
+    static void pushVertex(std::vector<BatchVertex>& batch, float x, float y, float u, float v, unsigned char alpha);
+};
+
+#endif
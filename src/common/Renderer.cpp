@@ -9,19 +9,23 @@
 
 #include "DataLoader.h"
 #include "Vector2D.h"
+#include "RenderBatch.h"
 
 #include "common/components/CompVisualTexture.h"
 #include "common/components/CompShape.h"
 #include "common/components/CompPosition.h"
+#include "common/components/CompPhysics.h"
 #include "common/components/CompVisualAnimation.h"
 #include "common/components/CompVisualMessage.h"
 
 #include "common/Logger.h"
 #include "common/GameEvents.h"
 #include "common/Foreach.h"
+#include "common/Profiler.h"
 
 #include <cmath>
 #include <sstream>
+#include <algorithm>
 #include <fstream>
 #ifdef SDL_SWAP_BUF
 #include <SDL.h>
@@ -34,12 +38,29 @@ namespace {
 const std::string cGraphisFileName = "data/graphics.info";
 const unsigned int cCircleSlices = 20; // number of slices for drawing a circle
 const int cDefaultMessageTime = 300;
+
+// layers of the texture batches
+const int cFillLayer = 0;
+const int cEdgeLayer = 1; // edges are drawn over the fills
+
+// grid size for the static geometry (in world units, the view is about 14 units wide)
+const float cStaticCellSize = 16.0f;
+
+std::pair<int, int> getStaticCellKey(const Vector2D& point)
+{
+    return std::make_pair((int)std::floor(point.x / cStaticCellSize), (int)std::floor(point.y / cStaticCellSize));
+}
 }
 
 RenderSystem::RenderSystem( GameEvents& gameEvents )
 : m_isInit (false), m_eventCons(), m_gameEvents ( gameEvents ),
   m_textureManager (), m_animationManager ( m_textureManager ),
-  m_fontManager (*this), m_currentMatrix (World), m_viewPortWidth (0), m_viewPortHeight (0)
+  m_fontManager (*this), m_staticGeometryDirty (true),
+  m_viewPosition (), m_viewScale (1.0f), m_viewAngle (0.0f), m_viewWidth (0.0f), m_viewHeight (0.0f),
+  m_viewSet (false), m_viewBox (), m_numVisibleTextureComps (0), m_numVisibleAnimComps (0),
+  m_currentMatrix (World), m_viewPortWidth (0), m_viewPortHeight (0),
+  m_loadedResources (), m_textureRefs (), m_animationRefs (), m_levelResources (), m_catalog (),
+  m_quality (QualityBest)
 {
     float* M;
 
@@ -59,6 +80,7 @@ RenderSystem::RenderSystem( GameEvents& gameEvents )
 
     m_eventCons.add(m_gameEvents.newComponent.registerListener( boost::bind(&RenderSystem::onRegisterComponent, this, _1) ));
     m_eventCons.add(m_gameEvents.deleteComponent.registerListener( boost::bind(&RenderSystem::onUnregisterComponent, this, _1) ));
+    m_eventCons.add(m_gameEvents.componentChanged.registerListener( boost::bind(&RenderSystem::onChangeComponent, this, _1) ));
     m_eventCons.add(m_gameEvents.dispMessage.registerListener( boost::bind(&RenderSystem::onDispMessage, this, _1, _2) ));
 }
 
@@ -78,7 +100,7 @@ void RenderSystem::init(int width, int height)
     if ((errCode = glGetError()) != GL_NO_ERROR)
     {
         errString = gluErrorString(errCode);
-        log(Error) << "RenderSubSystem::init> OpenGL Error: " << errString << "\n";
+        AA_LOG(Error) << "RenderSubSystem::init> OpenGL Error: " << errString << "\n";
     }
 
     m_isInit = true;
@@ -89,6 +111,13 @@ void RenderSystem::deInit()
     DataLoader::unLoadGraphics(m_loadedResources, &m_textureManager, &m_animationManager, &m_fontManager);
     m_loadedResources = ResourceIds();
 
+    // alle Ressourcen der Levels freigeben, auch noch referenzierte
+    DataLoader::unLoadGraphics(m_levelResources, &m_textureManager, &m_animationManager, &m_fontManager);
+    m_levelResources = ResourceIds();
+    m_textureRefs.clear();
+    m_animationRefs.clear();
+    m_catalog = ResourceIds();
+
     if (m_isInit)
     {
         setMatrix(World);
@@ -96,13 +125,122 @@ void RenderSystem::deInit()
     }
 }
 
-bool RenderSystem::loadData(TexQuality quality)
+bool RenderSystem::loadData(TexQuality quality, ResourceSet resourceSet)
 {
     assert (m_loadedResources.isEmpty()); // only call load once
-    m_loadedResources = DataLoader::loadGraphics(cGraphisFileName, &m_textureManager, &m_animationManager, &m_fontManager, quality);
+    m_quality = quality;
+    if (resourceSet == AllResources)
+    {
+        m_loadedResources = DataLoader::loadGraphics(cGraphisFileName, &m_textureManager, &m_animationManager, &m_fontManager, quality);
+        return true;
+    }
+
+    m_catalog = DataLoader::getGraphicsIds(cGraphisFileName);
+    ResourceIds global;
+    global.fonts = m_catalog.fonts;
+    foreach (const std::string& id, m_catalog.textures)
+    {
+        if (!id.empty() && id[0] == '_')
+            global.textures.insert(id);
+    }
+    m_loadedResources = DataLoader::loadGraphics(cGraphisFileName, &m_textureManager, &m_animationManager, &m_fontManager, quality, &global);
     return true;
 }
 
+void RenderSystem::acquireResources(const ResourceIds& ids)
+{
+    PROFILE_ZONE("RenderSystem::acquireResources");
+
+    // Referenzen zuerst zählen, damit Ressourcen, die auch das letzte Level gebraucht hat, geladen bleiben
+    ResourceIds toLoad;
+    foreach (const std::string& id, ids.textures)
+    {
+        if (m_loadedResources.textures.count(id))
+            continue; // immer geladen
+        if (m_catalog.textures.count(id) == 0)
+        {
+            AA_LOG(Warning) << "Texture '" << id << "' is not in " << cGraphisFileName << "\n";
+            continue;
+        }
+        int& refs = m_textureRefs[id];
+        if (refs++ == 0 && m_levelResources.textures.count(id) == 0)
+            toLoad.textures.insert(id);
+    }
+    foreach (const std::string& id, ids.animations)
+    {
+        if (m_loadedResources.animations.count(id))
+            continue;
+        if (m_catalog.animations.count(id) == 0)
+        {
+            AA_LOG(Warning) << "Animation '" << id << "' is not in " << cGraphisFileName << "\n";
+            continue;
+        }
+        int& refs = m_animationRefs[id];
+        if (refs++ == 0 && m_levelResources.animations.count(id) == 0)
+            toLoad.animations.insert(id);
+    }
+
+    // dann die nicht mehr gebrauchten freigeben und erst danach die fehlenden laden,
+    // damit nie die Ressourcen von zwei Levels gleichzeitig geladen sind
+    freeUnusedResources();
+
+    if (!toLoad.isEmpty())
+    {
+        AA_LOG(Info) << "Loading " << toLoad.textures.size() << " textures and " << toLoad.animations.size() << " animations for the level\n";
+        ResourceIds loaded = DataLoader::loadGraphics(cGraphisFileName, &m_textureManager, &m_animationManager, NULL, m_quality, &toLoad);
+        m_levelResources.textures.insert(loaded.textures.begin(), loaded.textures.end());
+        m_levelResources.animations.insert(loaded.animations.begin(), loaded.animations.end());
+    }
+}
+
+void RenderSystem::releaseResources(const ResourceIds& ids)
+{
+    foreach (const std::string& id, ids.textures)
+    {
+        RefCountMap::iterator it = m_textureRefs.find(id);
+        if (it != m_textureRefs.end() && it->second > 0)
+            --it->second;
+    }
+    foreach (const std::string& id, ids.animations)
+    {
+        RefCountMap::iterator it = m_animationRefs.find(id);
+        if (it != m_animationRefs.end() && it->second > 0)
+            --it->second;
+    }
+}
+
+void RenderSystem::freeUnusedResources()
+{
+    ResourceIds unused;
+    for (RefCountMap::iterator it = m_textureRefs.begin(); it != m_textureRefs.end(); )
+    {
+        if (it->second == 0)
+        {
+            if (m_levelResources.textures.erase(it->first))
+                unused.textures.insert(it->first);
+            m_textureRefs.erase(it++);
+        }
+        else
+            ++it;
+    }
+    for (RefCountMap::iterator it = m_animationRefs.begin(); it != m_animationRefs.end(); )
+    {
+        if (it->second == 0)
+        {
+            if (m_levelResources.animations.erase(it->first))
+                unused.animations.insert(it->first);
+            m_animationRefs.erase(it++);
+        }
+        else
+            ++it;
+    }
+    if (!unused.isEmpty())
+    {
+        AA_LOG(Info) << "Freeing " << unused.textures.size() << " textures and " << unused.animations.size() << " animations\n";
+        DataLoader::unLoadGraphics(unused, &m_textureManager, &m_animationManager, NULL);
+    }
+}
+
 // OpenGL initialisieren
 void RenderSystem::initOpenGL(int width, int height)
 {
@@ -165,6 +303,7 @@ void RenderSystem::clearScreen()
 
 void RenderSystem::flipBuffer()
 {
+    PROFILE_ZONE("RenderSystem::flipBuffer");
     glFlush();
 
     GLenum errCode;
@@ -173,7 +312,7 @@ void RenderSystem::flipBuffer()
     if ((errCode = glGetError()) != GL_NO_ERROR)
     {
         errString = gluErrorString(errCode);
-        log(Error) << "!=========! OpenGL Error " << errCode << ": " << errString << " !=========! \n";
+        AA_LOG(Error) << "!=========! OpenGL Error " << errCode << ": " << errString << " !=========! \n";
     }
 
     /* the following code takes screenshots of all frames and stores them to video/
@@ -478,6 +617,14 @@ void RenderSystem::drawShape(const CompShape& shape, const CompVisualTexture* te
 }
 
 void RenderSystem::drawEdge(const Vector2D& vertexA, const Vector2D& vertexB, const std::string& tex, float offset, float preCalcEdgeLenght)
+{
+    float texCoord[8];
+    float vertexCoord[8];
+    calcEdgeQuad(vertexA, vertexB, offset, preCalcEdgeLenght, texCoord, vertexCoord);
+    drawTexturedQuad( texCoord, vertexCoord, tex, false, 1.0f );
+}
+
+void RenderSystem::calcEdgeQuad(const Vector2D& vertexA, const Vector2D& vertexB, float offset, float preCalcEdgeLenght, float texCoord[8], float vertexCoord[8])
 {
     Vector2D edgeNorm = vertexB - vertexA;
     float edgeLenght = preCalcEdgeLenght;
@@ -490,15 +637,73 @@ void RenderSystem::drawEdge(const Vector2D& vertexA, const Vector2D& vertexB, co
     Vector2D vertex3 = vertex2 + edgeNorm;
     Vector2D vertex4 = vertex1 + edgeNorm;
 
-    float texCoord[8] = { 0.0f+offset, 0.0f,
-                          0.0f+offset, 1.0f,
-                          edgeLenght+offset, 1.0f,
-                          edgeLenght+offset, 0.0f };
-    float vertexCoord[8] = { vertex2.x, vertex2.y,
-                             vertex3.x, vertex3.y,
-                             vertex4.x, vertex4.y,
-                             vertex1.x, vertex1.y, };
-    drawTexturedQuad( texCoord, vertexCoord, tex, false, 1.0f );
+    texCoord[0] = 0.0f+offset;       texCoord[1] = 0.0f;
+    texCoord[2] = 0.0f+offset;       texCoord[3] = 1.0f;
+    texCoord[4] = edgeLenght+offset; texCoord[5] = 1.0f;
+    texCoord[6] = edgeLenght+offset; texCoord[7] = 0.0f;
+
+    vertexCoord[0] = vertex2.x; vertexCoord[1] = vertex2.y;
+    vertexCoord[2] = vertex3.x; vertexCoord[3] = vertex3.y;
+    vertexCoord[4] = vertex4.x; vertexCoord[5] = vertex4.y;
+    vertexCoord[6] = vertex1.x; vertexCoord[7] = vertex1.y;
+}
+
+void RenderSystem::batchShape(const CompShape& shape, const CompVisualTexture& tex, const BatchTransform& transform, RenderBatch& batch)
+{
+    float texCoord[8];
+    float vertexCoord[8];
+
+    switch (shape.getType())
+    {
+    case CompShape::Polygon:
+    {
+        const CompShapePolygon& poly = static_cast<const CompShapePolygon&>(shape);
+        size_t vertexCount = poly.getVertexCount();
+        if (vertexCount == 0)
+            break;
+        bool useTexMap = (vertexCount == tex.getTexMap().size());
+        batch.addPolygon(tex.getTextureId(), poly.getVertex(0), useTexMap ? &tex.getTexMap()[0] : NULL,
+                           vertexCount, transform, cFillLayer);
+
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            TextureId edgeTex = tex.getEdgeTexture(i);
+            if (edgeTex.empty())
+                continue;
+
+            size_t vetex2Index = (i == vertexCount - 1) ? (0) : (i + 1);
+            calcEdgeQuad(*poly.getVertex(i), *poly.getVertex(vetex2Index), 0.0f, -1.0f, texCoord, vertexCoord);
+            batch.addQuad(edgeTex, texCoord, vertexCoord, transform, cEdgeLayer);
+        }
+        break;
+    }
+    case CompShape::Circle:
+    {
+        const CompShapeCircle& circle = static_cast<const CompShapeCircle&>(shape);
+        batch.addCircle(tex.getTextureId(), circle.getCenter(), circle.getRadius(), cCircleSlices, transform, cFillLayer);
+
+        TextureId edgeTex = tex.getEdgeTexture(0);
+        if (!edgeTex.empty())
+        {
+            float angle = cPi * 2 / cCircleSlices;
+            float edgeLenght = tan(angle / 2) * 2.0f * circle.getRadius();
+            float textureCut = fmod(edgeLenght, 1.0f);
+
+            for (size_t i = 0; i < cCircleSlices; ++i)
+            {
+                Vector2D cross(circle.getRadius(), 0.0f);
+
+                calcEdgeQuad(circle.getCenter() + cross.rotated(angle * i), circle.getCenter() + cross.rotated(angle * (i + 1)),
+                             textureCut * i, edgeLenght, texCoord, vertexCoord);
+                batch.addQuad(edgeTex, texCoord, vertexCoord, transform, cEdgeLayer);
+            }
+        }
+        break;
+    }
+    default:
+        assert(false);
+        break;
+    }
 }
 
 // Zeichnet einen Vector2D (Pfeil) in einer bestimmten Postion
@@ -626,106 +831,147 @@ void RenderSystem::drawString( const std::string &str, const FontId &fontId, flo
     setMatrix(stored_matrix);
 }
 
-void RenderSystem::drawVisualTextureComps()
+void RenderSystem::batchTextureComp(const CompVisualTexture& texComp, RenderBatch& batch)
 {
+    CompPosition* compPos = texComp.m_compPosition;
+    const std::vector<CompShape*>& compShapes = texComp.m_compShapes;
+    if ( compPos )
+    {
+        BatchTransform transform(compPos->getDrawingPosition(), compPos->getDrawingOrientation());
+
+        const ComponentId& shapeId = texComp.getShapeId();
+        bool allShapes = (shapeId == CompVisualTexture::ALL_SHAPES);
+        for (size_t i = 0; i < compShapes.size(); ++i)
+        {
+            if (!allShapes && shapeId != compShapes[i]->getId())
+                continue;
+            batchShape(*compShapes[i], texComp, transform, batch);
+            if (!allShapes)
+                break;
+        }
+    }
+    else
+        AA_LOG(Info) << "Error: Trying to draw CompTexture that has no CompPosition in entity '" << texComp.getEntityId() << "'\n";
+}
+
+void RenderSystem::rebuildStaticGeometry()
+{
+    PROFILE_ZONE("RenderSystem::rebuildStaticGeometry");
+    m_staticCells.clear();
+    m_dynamicTextureComps.clear();
     foreach(CompVisualTexture* texComp, m_textureComps)
     {
-        CompPosition* compPos = texComp->getSiblingComponent<CompPosition>();
-        std::vector<CompShape*> compShapes = texComp->getSiblingComponents<CompShape>();
-        if ( compPos )
+        if (texComp->m_compPhysics == NULL || texComp->m_compPhysics->isStatic())
         {
-            glPushMatrix();
+            texComp->invalidateBoundingBox(); // the shapes may have changed
+            const Aabb& box = texComp->updateBoundingBox();
+            Vector2D center = box.getCenter();
+            StaticCell& cell = m_staticCells[getStaticCellKey(center)];
+            cell.bounds.extend(box);
+            batchTextureComp(*texComp, cell.batch);
+            ++cell.numComps;
+        }
+        else
+            m_dynamicTextureComps.push_back(texComp);
+    }
+    m_staticGeometryDirty = false;
+}
 
-            float angle = compPos->getDrawingOrientation();
-            Vector2D position = compPos->getDrawingPosition();
+void RenderSystem::updateStaticGeometry()
+{
+    if (m_staticGeometryDirty)
+        rebuildStaticGeometry();
+}
+
+const RenderBatch* RenderSystem::getStaticGeometry(const Vector2D& point) const
+{
+    StaticCellMap::const_iterator it = m_staticCells.find(getStaticCellKey(point));
+    if (it == m_staticCells.end())
+        return NULL;
+    return &it->second.batch;
+}
 
-            glTranslatef(position.x, position.y, 0.0f);
-            glRotatef(radToDeg(angle), 0.0, 0.0, 1.0f);
+void RenderSystem::drawVisualTextureComps()
+{
+    PROFILE_ZONE("RenderSystem::drawVisualTextureComps");
+    updateStaticGeometry();
 
-            const std::string& shapeId = texComp->getShapeId();
-            bool allShapes = (shapeId == CompVisualTexture::ALL_SHAPES);
-            for (size_t i = 0; i < compShapes.size(); ++i)
-            {
-                if (!allShapes && shapeId != compShapes[i]->getId())
-                    continue;
-                drawShape(*compShapes[i], *texComp);
-                if (!allShapes)
-                    break;
-            }
-            glPopMatrix();
+    m_numVisibleTextureComps = 0;
+    m_visibleStaticCells.clear();
+    foreach (const StaticCellMap::value_type& cell, m_staticCells)
+    {
+        if (isVisible(cell.second.bounds))
+        {
+            m_visibleStaticCells.push_back(&cell.second);
+            m_numVisibleTextureComps += cell.second.numComps;
         }
-        else
-            log(Info) << "Error: Trying to draw CompTexture that has no CompPosition in entity '" << texComp->getEntityId() << "'\n";
     }
+    // layer by layer, so that the edges of a cell are not covered by the fills of a neighbour cell
+    foreach (const StaticCell* cell, m_visibleStaticCells)
+        cell->batch.draw(m_textureManager, cFillLayer);
+    foreach (const StaticCell* cell, m_visibleStaticCells)
+        cell->batch.draw(m_textureManager, cEdgeLayer);
+
+    m_batch.clear();
+    foreach(CompVisualTexture* texComp, m_dynamicTextureComps)
+    {
+        if (!isVisible(texComp->updateBoundingBox()))
+            continue;
+        batchTextureComp(*texComp, m_batch);
+        ++m_numVisibleTextureComps;
+    }
+    m_batch.draw(m_textureManager);
 }
 
 void RenderSystem::drawVisualAnimationComps()
 {
+    PROFILE_ZONE("RenderSystem::drawVisualAnimationComps");
+    m_batch.clear();
+    m_numVisibleAnimComps = 0;
     foreach(CompVisualAnimation* pAnimComp, m_animComps)
     {
-        CompPosition* compPos = pAnimComp->getSiblingComponent<CompPosition>();
+        CompPosition* compPos = pAnimComp->m_compPosition;
         if (compPos)
         {
-            TextureId id = pAnimComp->getCurrentTexture();
-            if (id != "") // maybe the animation has not been set up yet (update())
-                m_textureManager.setTexture(id);
-
-            glPushMatrix();
+            const AnimFrame* frame = pAnimComp->getCurrentFrame();
+            if (frame == NULL) // maybe the animation has not been set up yet (update())
+                continue;
+            if (!isVisible(pAnimComp->updateBoundingBox()))
+                continue;
+            ++m_numVisibleAnimComps;
 
-            float angle = compPos->getDrawingOrientation();
-            Vector2D position = compPos->getDrawingPosition();
+            BatchTransform transform(compPos->getDrawingPosition(), compPos->getDrawingOrientation());
 
             bool isFlipped = pAnimComp->getFlip();
             Vector2D center = pAnimComp->center();
             if ( isFlipped )
                 center.x = -center.x;
 
-            glTranslatef(position.x, position.y, 0.0f);
-            glRotatef(radToDeg(angle), 0.0, 0.0, 1.0f);
-            glTranslatef(-center.x, -center.y, 0.0f);
-
-            {
-                // FLIP ONCE
-                float hw, hh;
-                pAnimComp->getDimensions( &hw, &hh );
-
-                glBegin ( GL_QUADS );
-                // Oben links
-                if ( isFlipped )
-                    glTexCoord2f(1.0f, 0.0f);
-                else
-                    glTexCoord2f(0.0f, 0.0f);
-                glVertex2f(-hw, hh);
-
-                // Unten links
-                if ( isFlipped )
-                    glTexCoord2f(1.0f, 1.0f);
-                else
-                    glTexCoord2f(0.0f, 1.0f);
-                glVertex2f(-hw, -hh);
-
-                // Unten rechts
-                if ( isFlipped )
-                    glTexCoord2f(0.0f, 1.0f);
-                else
-                    glTexCoord2f(1.0f, 1.0f);
-                glVertex2f(hw, -hh);
-
-                // Oben rechts
-                if ( isFlipped )
-                    glTexCoord2f(0.0f, 0.0f);
-                else
-                    glTexCoord2f(1.0f, 0.0f);
-                glVertex2f(hw, hh);
-                glEnd();
-            }
-            glPopMatrix();
+            float hw, hh;
+            pAnimComp->getDimensions( &hw, &hh );
+
+            // oben links, unten links, unten rechts, oben rechts
+            float vertexCoord[8] = { -hw - center.x,  hh - center.y,
+                                     -hw - center.x, -hh - center.y,
+                                      hw - center.x, -hh - center.y,
+                                      hw - center.x,  hh - center.y };
+            // the frame is a part of the animation's atlas texture
+            const TexRect& rect = frame->rect;
+            float left = isFlipped ? rect.right : rect.left; // FLIP ONCE
+            float right = isFlipped ? rect.left : rect.right;
+            float texCoord[8] = { left,  rect.top,
+                                  left,  rect.bottom,
+                                  right, rect.bottom,
+                                  right, rect.top };
+            m_batch.addQuad(frame->texture, texCoord, vertexCoord, transform);
         }
     }
+    m_batch.draw(m_textureManager);
 }
 
 void RenderSystem::drawVisualMessageComps()
 {
+    PROFILE_ZONE("RenderSystem::drawVisualMessageComps");
     float x = 0.1f, y = 0.2f;
     int line = 0;
     float lineHeight = 0.07f;
@@ -752,7 +998,12 @@ void RenderSystem::drawFPS(int fps) // XXX
 void RenderSystem::onRegisterComponent(Component& component)
 {
     if (component.getTypeId() == CompVisualTexture::getTypeIdStatic())
+    {
         m_textureComps.insert(&static_cast<CompVisualTexture&>(component));
+        m_staticGeometryDirty = true;
+    }
+    else if (component.getTypeId() == CompPhysics::getTypeIdStatic())
+        m_staticGeometryDirty = true; // the body type decides if its textures are static
     else if (component.getTypeId() == CompVisualAnimation::getTypeIdStatic())
         m_animComps.insert(&static_cast<CompVisualAnimation&>(component));
     else if (component.getTypeId() == CompVisualMessage::getTypeIdStatic())
@@ -762,13 +1013,29 @@ void RenderSystem::onRegisterComponent(Component& component)
 void RenderSystem::onUnregisterComponent(Component& component)
 {
     if (component.getTypeId() == CompVisualTexture::getTypeIdStatic())
+    {
         m_textureComps.erase(&static_cast<CompVisualTexture&>(component));
+        // remove it right away, it must not be drawn anymore
+        m_dynamicTextureComps.erase(std::remove(m_dynamicTextureComps.begin(), m_dynamicTextureComps.end(), &component), m_dynamicTextureComps.end());
+        m_staticGeometryDirty = true;
+    }
+    else if (component.getTypeId() == CompPhysics::getTypeIdStatic())
+        m_staticGeometryDirty = true;
     else if (component.getTypeId() == CompVisualAnimation::getTypeIdStatic())
         m_animComps.erase(&static_cast<CompVisualAnimation&>(component));
     else if (component.getTypeId() == CompVisualMessage::getTypeIdStatic())
         m_msgComps.erase(&static_cast<CompVisualMessage&>(component));
 }
 
+void RenderSystem::onChangeComponent(Component& component)
+{
+    // the cached boxes of dynamic textures are only updated when the body moves, not when a shape changes
+    foreach(CompVisualTexture* texComp, component.getSiblingComponents<CompVisualTexture>())
+        texComp->invalidateBoundingBox();
+    // positions, shapes, textures and body types are all baked into the static geometry
+    invalidateStaticGeometry();
+}
+
 void RenderSystem::displayTextScreen( const std::string& text )
 {
     setMatrix(GUI);
@@ -838,6 +1105,45 @@ void RenderSystem::setView(const Vector2D& pos, float scale, float angle)
     glRotatef(radToDeg(angle), 0.0, 0.0, -1.0f);
     glScalef(scale, scale, 1); // x und y zoomen
     glTranslatef(pos.x * -1, pos.y * -1, 0.0f);
+
+    m_viewPosition = pos;
+    m_viewScale = scale;
+    m_viewAngle = angle;
+    m_viewSet = true;
+    updateViewBox();
+}
+
+void RenderSystem::updateViewBox()
+{
+    if (m_viewScale <= 0.0f)
+    {
+        m_viewBox = Aabb();
+        return;
+    }
+    // halbe Grösse des sichtbaren Bereichs in Weltkoordinaten, gedreht wie die Kamera
+    Vector2D half (m_viewWidth / 2 / m_viewScale, m_viewHeight / 2 / m_viewScale);
+    m_viewBox = Aabb(-half, half).transformed(m_viewPosition, m_viewAngle);
+}
+
+bool RenderSystem::isVisible(const Aabb& box) const
+{
+    if (!m_viewSet)
+        return true;
+    if (!m_viewBox.intersects(box))
+        return false;
+
+    // die Box auch auf die Achsen der (gedrehten) Kamera projizieren (Separating Axis Test)
+    float c = std::cos(m_viewAngle), s = std::sin(m_viewAngle);
+    Vector2D center = box.getCenter() - m_viewPosition;
+    Vector2D half = box.getHalfExtents();
+    float viewHalfWidth = m_viewWidth / 2 / m_viewScale;
+    float viewHalfHeight = m_viewHeight / 2 / m_viewScale;
+    // Kamera-x-Achse (c, s), Kamera-y-Achse (-s, c)
+    if (std::fabs(c*center.x + s*center.y) > viewHalfWidth + std::fabs(c)*half.x + std::fabs(s)*half.y)
+        return false;
+    if (std::fabs(-s*center.x + c*center.y) > viewHalfHeight + std::fabs(s)*half.x + std::fabs(c)*half.y)
+        return false;
+    return true;
 }
 
 void RenderSystem::setViewSize( float width, float height )
@@ -849,10 +1155,15 @@ void RenderSystem::setViewSize( float width, float height )
     // orthogonalen 2D-Rendermodus
     gluOrtho2D( -width/2, width/2, -height/2, height/2 ); // (z ist nicht wichtig)
     glMatrixMode ( GL_MODELVIEW );
+
+    m_viewWidth = width;
+    m_viewHeight = height;
+    updateViewBox();
 }
 
 void RenderSystem::update()
 {
+    PROFILE_ZONE("RenderSystem::update");
     foreach(CompVisualAnimation* animComp, m_animComps)
     {
         if ( animComp->m_animInfo==NULL )
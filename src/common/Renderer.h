@@ -9,11 +9,14 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include "common/Aabb.h"
 #include "common/Event.h"
 #include "common/Font.h"
 #include "common/Texture.h"
 #include "common/DataLoader.h"
+#include "common/RenderBatch.h"
 
+#include <map>
 #include <set>
 #include <list>
 #include <string>
@@ -46,7 +49,19 @@ public:
 
     void init(int width, int height);
     void deInit();
-    bool loadData(TexQuality quality);
+
+    enum ResourceSet
+    {
+        AllResources,   // alle Ressourcen aus graphics.info (z.B. für den Editor)
+        GlobalResources // nur Schriften und Texturen mit "_" am Anfang, den Rest lädt acquireResources()
+    };
+    bool loadData(TexQuality quality, ResourceSet resourceSet = AllResources);
+
+    // Lädt die Ressourcen eines Levels (mit Referenzzählung). Nicht mehr gebrauchte Ressourcen werden
+    // erst beim nächsten acquireResources() freigegeben, damit bei einem Neustart oder beim Wechsel zum
+    // nächsten Level nur die fehlenden Ressourcen geladen werden müssen.
+    void acquireResources(const ResourceIds& ids);
+    void releaseResources(const ResourceIds& ids);
 
     void resize(int width, int height);
 
@@ -70,6 +85,26 @@ public:
     void drawVisualAnimationComps();
     void drawVisualMessageComps();
 
+    // the cached static geometry is rebuilt on the next draw (done automatically when entities or components change)
+    void invalidateStaticGeometry() { m_staticGeometryDirty = true; }
+    // rebuilds the static geometry now if it is out of date (drawVisualTextureComps() does this too)
+    void updateStaticGeometry();
+    // static geometry of the cell that contains point (NULL if the cell is empty)
+    const RenderBatch* getStaticGeometry(const Vector2D& point) const;
+    // number of texture components drawn from the static geometry cache / batched every frame
+    size_t getNumStaticTextureComps() const { return m_textureComps.size() - m_dynamicTextureComps.size(); }
+    size_t getNumDynamicTextureComps() const { return m_dynamicTextureComps.size(); }
+
+    // View-Frustum Culling: nur Komponenten, deren Bounding Box den sichtbaren Bereich schneidet, werden gezeichnet.
+    // Anzahl im letzten Frame gezeichneter / aller Komponenten (für das Profiling); statische Texturen zählen
+    // als sichtbar, wenn ihre Zelle sichtbar ist.
+    size_t getNumVisibleTextureComps() const { return m_numVisibleTextureComps; }
+    size_t getNumTextureComps() const { return m_textureComps.size(); }
+    size_t getNumVisibleAnimationComps() const { return m_numVisibleAnimComps; }
+    size_t getNumAnimationComps() const { return m_animComps.size(); }
+    // ob eine Box (in Weltkoordinaten) im Bild ist (gemäss setView() und setViewSize())
+    bool isVisible(const Aabb& box) const;
+
     // einen Texturierten Quadrat zeichnen
     void drawTexturedQuad(float texCoord[8], float vertexCoord[8], const std::string& texId, bool border=false, float alpha=1.0f);
     // einen Quadrat zeichnen
@@ -143,12 +178,52 @@ private:
 
     void onRegisterComponent(Component& component);
     void onUnregisterComponent(Component& component);
+    void onChangeComponent(Component& component);
     void onDispMessage(const std::string& message, int time);
 
     void drawShape(const CompShape& shape, const CompVisualTexture* tex, const Color* color, bool border=false);
     void drawPolygon(const CompShapePolygon& poly, const CompVisualTexture* tex, bool border=false);
     void drawCircle(const CompShapeCircle& circle, const CompVisualTexture* tex, bool border=false);
 
+    // add the shapes of a texture component to a batch (instead of drawing them directly)
+    void batchTextureComp(const CompVisualTexture& texComp, RenderBatch& batch);
+    void batchShape(const CompShape& shape, const CompVisualTexture& tex, const BatchTransform& transform, RenderBatch& batch);
+    static void calcEdgeQuad(const Vector2D& vertexA, const Vector2D& vertexB, float offset, float preCalcEdgeLenght, float texCoord[8], float vertexCoord[8]);
+
+    RenderBatch m_batch; // geometry of the visual components, drawn sorted by texture
+
+    // Texture components that can't move (no physics or a static body) are batched only once
+    // and redrawn from m_staticCells until an entity is added or removed.
+    // The static geometry is split into a uniform grid (by the center of each component's bounding box),
+    // so only the cells whose bounds intersect the view are drawn.
+    class StaticCell
+    {
+    public:
+        StaticCell() : bounds (), batch (), numComps (0) {}
+        Aabb bounds;        // bounding boxes of all components in the cell (may reach into other cells)
+        RenderBatch batch;
+        size_t numComps;
+    };
+    typedef std::map<std::pair<int, int>, StaticCell> StaticCellMap; // map: the batches must not be copied
+    void rebuildStaticGeometry();
+    StaticCellMap m_staticCells;
+    std::vector<const StaticCell*> m_visibleStaticCells; // only to keep the memory between frames
+    std::vector<CompVisualTexture*> m_dynamicTextureComps;
+    bool m_staticGeometryDirty;
+
+    // sichtbarer Bereich (setView und setViewSize)
+    Vector2D m_viewPosition;
+    float m_viewScale;
+    float m_viewAngle;
+    float m_viewWidth;
+    float m_viewHeight;
+    bool m_viewSet;     // ohne Kamera wird nichts weggelassen
+    Aabb m_viewBox;     // Bounding Box des (gedrehten) sichtbaren Bereichs
+    void updateViewBox();
+
+    size_t m_numVisibleTextureComps;
+    size_t m_numVisibleAnimComps;
+
     MatrixId m_currentMatrix;
     float m_matrixGUI[16];
     float m_matrixText[16];
@@ -156,7 +231,17 @@ private:
     int m_viewPortWidth;
     int m_viewPortHeight;
 
-    ResourceIds m_loadedResources;
+    ResourceIds m_loadedResources;   // von loadData(), bleiben bis deInit() geladen
+
+    // Ressourcen von acquireResources() mit Anzahl Referenzen (0 = wird beim nächsten acquire freigegeben)
+    typedef std::map<std::string, int> RefCountMap;
+    RefCountMap m_textureRefs;
+    RefCountMap m_animationRefs;
+    ResourceIds m_levelResources;    // davon erfolgreich geladen
+    ResourceIds m_catalog;           // alle Ressourcen aus graphics.info
+    TexQuality m_quality;
+
+    void freeUnusedResources();
 };
 
 #endif
@@ -39,13 +39,13 @@ bool SoundSystem::init(float volSound, float volMusic, float volMaster)
 {
     if ( m_isInit )
     {
-        log(Warning) << "SoundSubSystem::Init(): Sound SubSystem was already initialized!\n";
+        AA_LOG(Warning) << "SoundSubSystem::Init(): Sound SubSystem was already initialized!\n";
         return true;
     }
     if( Mix_OpenAudio( MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, 2, 1024 ) == -1 )
     {
         //throw Exception ( log() << "Error in Mix_OpenAudio: %s\n", Mix_GetError() ) );
-        log(Error) << "Error in Mix_OpenAudio: " << Mix_GetError() << "\n";
+        AA_LOG(Error) << "Error in Mix_OpenAudio: " << Mix_GetError() << "\n";
         return false;
     }
     Mix_AllocateChannels(64);
@@ -92,18 +92,18 @@ void SoundSystem::loadSound( const std::string& name, SoundId id )
 {
     if ( !m_isInit )
     {
-        log(Error) << "SoundSubSystem::LoadSound(): Sound SubSystem is not initialized!\n";
+        AA_LOG(Error) << "SoundSubSystem::LoadSound(): Sound SubSystem is not initialized!\n";
         return;
     }
     if ( m_sounds.count( id )==1 )
     {
-        log(Error) << "Loading sound: Sound with ID \"" << id << "\" exists already! (new sound was not loaded)\n";
+        AA_LOG(Error) << "Loading sound: Sound with ID \"" << id << "\" exists already! (new sound was not loaded)\n";
         return;
     }
     Mix_Chunk *sample = Mix_LoadWAV( name.c_str() );
     if( !sample )
     {
-        log(Error) << "Loading sound: " << Mix_GetError() << "\n";
+        AA_LOG(Error) << "Loading sound: " << Mix_GetError() << "\n";
         return;
     }
 
@@ -136,7 +136,7 @@ void SoundSystem::playSound(const SoundId &id)
     {
         if( Mix_PlayChannel( -1, c_it->second, 0 ) == -1 )
         {
-            log(Error) << "Error in Mix_PlayChannel: " << Mix_GetError() << "\n";
+            AA_LOG(Error) << "Error in Mix_PlayChannel: " << Mix_GetError() << "\n";
         }
     }
 }
@@ -145,19 +145,19 @@ void SoundSystem::loadMusic(const std::string& name, MusicId id)
 {
     if ( !m_isInit )
     {
-        log(Error) << "SoundSubSystem::LoadMusic(): Sound SubSystem is not initialized!\n";
+        AA_LOG(Error) << "SoundSubSystem::LoadMusic(): Sound SubSystem is not initialized!\n";
         return;
     }
     if ( m_music.count( id )==1 )
     {
-        log(Warning) << "Error loading music with ID \"" << id << "\" exists already! (new music was not loaded)\n";
+        AA_LOG(Warning) << "Error loading music with ID \"" << id << "\" exists already! (new music was not loaded)\n";
         return;
     }
     Mix_Music *music;
     music=Mix_LoadMUS( name.c_str() );
     if( !music )
     {
-        log(Error) << "Loading music '" << name << "': " << Mix_GetError() << "\n";
+        AA_LOG(Error) << "Loading music '" << name << "': " << Mix_GetError() << "\n";
         return;
     }
 
@@ -176,6 +176,11 @@ void SoundSystem::freeMusic(const MusicId &id)
     }
 }
 
+bool SoundSystem::isMusicLoaded(const MusicId &id) const
+{
+    return m_music.count( id ) == 1;
+}
+
 void SoundSystem::playMusic(const MusicId &id, bool forever, int fadeInMs)
 {
     if (Mix_VolumeMusic(-1) == 0)
@@ -185,7 +190,7 @@ void SoundSystem::playMusic(const MusicId &id, bool forever, int fadeInMs)
     {
         if( Mix_FadeInMusic(c_it->second, forever?-1:0, fadeInMs) == -1 )
         {
-            log(Error) << "Mix_FadeInMusic: " << Mix_GetError() << "\n";
+            AA_LOG(Error) << "Mix_FadeInMusic: " << Mix_GetError() << "\n";
         }
         m_currentPlayingMusic = c_it->second;
     }
@@ -35,6 +35,7 @@ public:
 
     void loadMusic( const std::string& name, MusicId id );
     void freeMusic( const MusicId& id );
+    bool isMusicLoaded( const MusicId& id ) const;
     void playMusic( const MusicId& id, bool forever, int fadeInMs );
     void stopMusic( int fadeOutMs );
     void pauseMusic();
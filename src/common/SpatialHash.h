@@ -0,0 +1,86 @@
+/*
+ * SpatialHash.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Räumlicher Index: findet schnell alle Objekte in einem Bereich der Welt
+
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include "common/Aabb.h"
+#include "common/Vector2D.h"
+
+#include <vector>
+#include <utility>
+#include <boost/unordered_map.hpp>
+
+// SpatialHash
+// -----------
+// Uniform grid over the whole (unbounded) world, only the cells that contain something are stored.
+// Each item is stored with its bounding box in every cell the box overlaps. Moving an item only
+// touches the cells it leaves and enters. Items that would cover too many cells (e.g. a huge
+// terrain polygon) are kept in a separate list that every query checks.
+// Item must be usable as a key of a boost::unordered_map (e.g. a pointer).
+// The cell size should be around the size of typical items (and queries).
+template <typename Item>
+class SpatialHash
+{
+public:
+    explicit SpatialHash(float cellSize);
+
+    // insert a new item or move an existing one
+    void update(const Item& item, const Aabb& box);
+    void remove(const Item& item);
+    void clear();
+
+    bool contains(const Item& item) const { return m_entries.find(item) != m_entries.end(); }
+    size_t size() const { return m_entries.size(); }
+    float getCellSize() const { return m_cellSize; }
+
+    // Append the items whose bounding box contains the point / intersects the box / intersects
+    // the circle to result. Every item is only added once.
+    void queryPoint(const Vector2D& point, std::vector<Item>& result) const;
+    void queryAabb(const Aabb& box, std::vector<Item>& result) const;
+    void queryRadius(const Vector2D& center, float radius, std::vector<Item>& result) const;
+
+private:
+    SpatialHash(const SpatialHash&);
+    SpatialHash& operator = (const SpatialHash&);
+
+    class Entry
+    {
+    public:
+        Item item;
+        Aabb box;
+        int x0, y0, x1, y1;                 // covered cells (inclusive)
+        bool oversized;                     // in m_oversized instead of the cells
+        mutable unsigned int queryStamp;    // last query that returned this item
+    };
+    typedef std::pair<int, int> CellKey;
+    typedef std::vector<Entry*> Cell;
+    typedef boost::unordered_map<CellKey, Cell> CellMap;
+    typedef boost::unordered_map<Item, Entry> EntryMap; // the entries never move in memory (node based)
+
+    enum QueryShape { QueryBox, QueryCircle };
+
+    float m_cellSize;
+    CellMap m_cells;
+    EntryMap m_entries;
+    std::vector<Entry*> m_oversized;
+    mutable unsigned int m_queryStamp;
+
+    int toCell(float coord) const;
+    void addToCells(Entry& entry);
+    void removeFromCells(Entry& entry);
+    static void removeFromCell(std::vector<Entry*>& cell, const Entry* entry);
+    void query(const Aabb& range, QueryShape shape, const Vector2D& center, float radius, std::vector<Item>& result) const;
+    void collect(const Entry& entry, const Aabb& range, QueryShape shape, const Vector2D& center, float radius,
+                 std::vector<Item>& result) const;
+};
+
+// we need to include the cpp because the template methods need to be implemented in the header...
+#include "SpatialHash_templ.cpp"
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ * SpatialHash_templ.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "common/Foreach.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace SpatialHashDetail {
+// more cells than this per item and it goes to the oversized list
+const int cMaxCellsPerItem = 64;
+}
+
+template <typename Item>
+SpatialHash<Item>::SpatialHash(float cellSize)
+: m_cellSize (cellSize), m_cells (), m_entries (), m_oversized (), m_queryStamp (0)
+{
+}
+
+template <typename Item>
+int SpatialHash<Item>::toCell(float coord) const
+{
+    return (int)std::floor(coord / m_cellSize);
+}
+
+template <typename Item>
+void SpatialHash<Item>::update(const Item& item, const Aabb& box)
+{
+    typename EntryMap::iterator it = m_entries.find(item);
+    if (it == m_entries.end())
+    {
+        Entry& entry = m_entries[item];
+        entry.item = item;
+        entry.box = box;
+        entry.queryStamp = 0;
+        addToCells(entry);
+        return;
+    }
+
+    Entry& entry = it->second;
+    entry.box = box;
+    // most moves stay in the same cells
+    if (!entry.oversized && !box.isEmpty() &&
+        toCell(box.lower.x) == entry.x0 && toCell(box.lower.y) == entry.y0 &&
+        toCell(box.upper.x) == entry.x1 && toCell(box.upper.y) == entry.y1)
+        return;
+    removeFromCells(entry);
+    addToCells(entry);
+}
+
+template <typename Item>
+void SpatialHash<Item>::remove(const Item& item)
+{
+    typename EntryMap::iterator it = m_entries.find(item);
+    if (it == m_entries.end())
+        return;
+    removeFromCells(it->second);
+    m_entries.erase(it);
+}
+
+template <typename Item>
+void SpatialHash<Item>::clear()
+{
+    m_cells.clear();
+    m_entries.clear();
+    m_oversized.clear();
+}
+
+template <typename Item>
+void SpatialHash<Item>::addToCells(Entry& entry)
+{
+    if (entry.box.isEmpty())
+    {
+        // not in any cell, can't be found
+        entry.oversized = false;
+        entry.x0 = entry.y0 = 0;
+        entry.x1 = entry.y1 = -1;
+        return;
+    }
+    entry.x0 = toCell(entry.box.lower.x);
+    entry.y0 = toCell(entry.box.lower.y);
+    entry.x1 = toCell(entry.box.upper.x);
+    entry.y1 = toCell(entry.box.upper.y);
+    entry.oversized = (double)(entry.x1 - entry.x0 + 1) * (entry.y1 - entry.y0 + 1) > SpatialHashDetail::cMaxCellsPerItem;
+    if (entry.oversized)
+    {
+        m_oversized.push_back(&entry);
+        return;
+    }
+    for (int x = entry.x0; x <= entry.x1; ++x)
+        for (int y = entry.y0; y <= entry.y1; ++y)
+            m_cells[CellKey(x, y)].push_back(&entry);
+}
+
+template <typename Item>
+void SpatialHash<Item>::removeFromCell(std::vector<Entry*>& cell, const Entry* entry)
+{
+    typename std::vector<Entry*>::iterator it = std::find(cell.begin(), cell.end(), entry);
+    if (it == cell.end())
+        return;
+    *it = cell.back(); // the order doesn't matter
+    cell.pop_back();
+}
+
+template <typename Item>
+void SpatialHash<Item>::removeFromCells(Entry& entry)
+{
+    if (entry.oversized)
+    {
+        removeFromCell(m_oversized, &entry);
+        return;
+    }
+    for (int x = entry.x0; x <= entry.x1; ++x)
+    {
+        for (int y = entry.y0; y <= entry.y1; ++y)
+        {
+            typename CellMap::iterator it = m_cells.find(CellKey(x, y));
+            if (it == m_cells.end())
+                continue;
+            removeFromCell(it->second, &entry);
+            if (it->second.empty())
+                m_cells.erase(it);
+        }
+    }
+}
+
+template <typename Item>
+void SpatialHash<Item>::queryPoint(const Vector2D& point, std::vector<Item>& result) const
+{
+    query(Aabb(point, point), QueryBox, point, 0.0f, result);
+}
+
+template <typename Item>
+void SpatialHash<Item>::queryAabb(const Aabb& box, std::vector<Item>& result) const
+{
+    query(box, QueryBox, Vector2D(), 0.0f, result);
+}
+
+template <typename Item>
+void SpatialHash<Item>::queryRadius(const Vector2D& center, float radius, std::vector<Item>& result) const
+{
+    query(Aabb(center, center).enlarged(radius), QueryCircle, center, radius, result);
+}
+
+template <typename Item>
+void SpatialHash<Item>::query(const Aabb& range, QueryShape shape, const Vector2D& center, float radius, std::vector<Item>& result) const
+{
+    if (range.isEmpty())
+        return;
+
+    // a new stamp per query, so items in several cells are only returned once
+    if (++m_queryStamp == 0)
+    {
+        for (typename EntryMap::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+            it->second.queryStamp = 0;
+        m_queryStamp = 1;
+    }
+
+    foreach (const Entry* entry, m_oversized)
+        collect(*entry, range, shape, center, radius, result);
+
+    int x0 = toCell(range.lower.x), y0 = toCell(range.lower.y);
+    int x1 = toCell(range.upper.x), y1 = toCell(range.upper.y);
+    if ((double)(x1 - x0 + 1) * (y1 - y0 + 1) > m_cells.size())
+    {
+        // big query: go through the stored cells instead of the covered ones
+        for (typename CellMap::const_iterator it = m_cells.begin(); it != m_cells.end(); ++it)
+        {
+            const CellKey& key = it->first;
+            if (key.first < x0 || key.first > x1 || key.second < y0 || key.second > y1)
+                continue;
+            foreach (const Entry* entry, it->second)
+                collect(*entry, range, shape, center, radius, result);
+        }
+        return;
+    }
+
+    for (int x = x0; x <= x1; ++x)
+    {
+        for (int y = y0; y <= y1; ++y)
+        {
+            typename CellMap::const_iterator it = m_cells.find(CellKey(x, y));
+            if (it == m_cells.end())
+                continue;
+            foreach (const Entry* entry, it->second)
+                collect(*entry, range, shape, center, radius, result);
+        }
+    }
+}
+
+template <typename Item>
+void SpatialHash<Item>::collect(const Entry& entry, const Aabb& range, QueryShape shape, const Vector2D& center, float radius,
+                                std::vector<Item>& result) const
+{
+    if (entry.queryStamp == m_queryStamp)
+        return; // already tested in an other cell
+    entry.queryStamp = m_queryStamp;
+    if (!entry.box.intersects(range))
+        return;
+    if (shape == QueryCircle)
+    {
+        // nächster Punkt der Box zum Kreismittelpunkt
+        Vector2D closest (std::max(entry.box.lower.x, std::min(center.x, entry.box.upper.x)),
+                          std::max(entry.box.lower.y, std::min(center.y, entry.box.upper.y)));
+        if ((closest - center).lengthSquared() > radius * radius)
+            return;
+    }
+    result.push_back(entry.item);
+}
@@ -0,0 +1,80 @@
+/*
+ * Symbol.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "Symbol.h"
+
+#include <map>
+#include <iostream>
+#include <SDL.h>
+
+namespace
+{
+
+typedef std::map<std::string, unsigned int> SymbolTable;
+
+// construct on first use, so that static Symbols can be used safely
+SymbolTable& symbolTable()
+{
+    static SymbolTable table;
+    return table;
+}
+
+// levels can be loaded in another thread (see LevelLoader)
+SDL_mutex* symbolTableMutex()
+{
+    static SDL_mutex* mutex = SDL_CreateMutex();
+    return mutex;
+}
+
+// wird beim Laden des Programms aufgerufen, damit der Mutex nicht gleichzeitig von zwei Threads erstellt wird
+SDL_mutex* gInitSymbolTableMutex = symbolTableMutex();
+
+const std::pair<const std::string, unsigned int>* intern(const std::string& name)
+{
+    SDL_mutex* mutex = symbolTableMutex();
+    SDL_mutexP(mutex);
+    SymbolTable& table = symbolTable();
+    SymbolTable::iterator it = table.find(name);
+    if (it == table.end())
+        it = table.insert( std::make_pair(name, static_cast<unsigned int>(table.size())) ).first;
+    SDL_mutexV(mutex);
+    return &*it; // map entries don't move
+}
+
+}
+
+Symbol::Symbol()
+: m_entry ( intern("") )
+{}
+
+Symbol::Symbol(const std::string& name)
+: m_entry ( intern(name) )
+{}
+
+Symbol::Symbol(const char* name)
+: m_entry ( intern(name) )
+{}
+
+std::size_t Symbol::getSymbolCount()
+{
+    SDL_mutexP(symbolTableMutex());
+    std::size_t count = symbolTable().size();
+    SDL_mutexV(symbolTableMutex());
+    return count;
+}
+
+std::ostream& operator<<(std::ostream& os, const Symbol& symbol)
+{
+    return os << symbol.str();
+}
+
+std::istream& operator>>(std::istream& is, Symbol& symbol)
+{
+    std::string name;
+    if (is >> name)
+        symbol = Symbol(name);
+    return is;
+}
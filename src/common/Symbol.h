@@ -0,0 +1,75 @@
+/*
+ * Symbol.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Interned strings (used for IDs)
+
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <string>
+#include <cstddef>
+#include <iosfwd>
+#include <boost/optional.hpp>
+#include <boost/property_tree/ptree_fwd.hpp>
+
+/*
+    A Symbol is a string stored once in a global table. Copying and comparing
+    symbols only copies/compares a pointer, so they are well suited as map keys.
+    Creating a symbol from a string needs a table lookup, so in hot code paths
+    symbols should be created once and stored.
+    NOTE: operator< does not order alphabetically (use str() for that).
+*/
+class Symbol
+{
+public:
+    Symbol(); // the empty symbol ""
+    Symbol(const std::string& name);
+    Symbol(const char* name);
+
+    const std::string& str() const { return m_entry->first; }
+    operator const std::string&() const { return m_entry->first; }
+    const char* c_str() const { return m_entry->first.c_str(); }
+    bool empty() const { return m_entry->first.empty(); }
+
+    // unique number of this symbol (numbered in order of creation)
+    unsigned int index() const { return m_entry->second; }
+
+    friend bool operator==(const Symbol& a, const Symbol& b) { return a.m_entry == b.m_entry; }
+    friend bool operator!=(const Symbol& a, const Symbol& b) { return a.m_entry != b.m_entry; }
+    friend bool operator< (const Symbol& a, const Symbol& b) { return a.index() < b.index(); }
+
+    // number of symbols in the table
+    static std::size_t getSymbolCount();
+
+private:
+    typedef std::pair<const std::string, unsigned int> Entry;
+    const Entry* m_entry; // entries are never removed from the table
+};
+
+// string concatenation (e.g. for error messages)
+inline std::string operator+(const std::string& a, const Symbol& b) { return a + b.str(); }
+inline std::string operator+(const Symbol& a, const std::string& b) { return a.str() + b; }
+inline std::string operator+(const char* a, const Symbol& b) { return a + b.str(); }
+inline std::string operator+(const Symbol& a, const char* b) { return a.str() + b; }
+
+std::ostream& operator<<(std::ostream& os, const Symbol& symbol);
+std::istream& operator>>(std::istream& is, Symbol& symbol);
+
+inline std::size_t hash_value(const Symbol& symbol) { return symbol.index(); }
+
+// so that Symbols can be read from and written to property trees like strings
+namespace boost { namespace property_tree {
+    struct SymbolTranslator
+    {
+        typedef std::string internal_type;
+        typedef Symbol external_type;
+        boost::optional<Symbol> get_value(const std::string& str) const { return boost::optional<Symbol>(Symbol(str)); }
+        boost::optional<std::string> put_value(const Symbol& symbol) const { return boost::optional<std::string>(symbol.str()); }
+    };
+    template <> struct translator_between<std::string, Symbol> { typedef SymbolTranslator type; };
+}}
+
+#endif /* SYMBOL_H */
@@ -10,8 +10,11 @@
 #include "Exception.h"
 #include "Foreach.h"
 #include "DataLoader.h"
+#include "TextureCache.h"
+#include "TextureDecoder.h"
 
 #include <cmath>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <IL/il.h>
@@ -22,6 +25,7 @@
 
 // Konstruktor
 TextureManager::TextureManager()
+: m_cache (new TextureCache)
 {
     // Version von DevIL überprüfen.
     ILint il_dynamic_library_version = ilGetInteger(IL_VERSION_NUM);
@@ -39,6 +43,9 @@ TextureManager::TextureManager()
 
     ilInit(); // Initialization von DevIL (IL)
     iluInit(); // Initialization von DevIL (ILU)
+
+    // mit AABake vorbereitete Texturen (optional)
+    m_cache->open(cTextureCacheManifest);
 }
 
 // Destruktor
@@ -59,16 +66,16 @@ void CheckOpenlGlError()
     if ((errCode = glGetError()) != GL_NO_ERROR)
     {
         errString = gluErrorString(errCode);
-        log(Error) << "========= OpenGL Error: " << errCode << ": " << errString << " =========\n";
+        AA_LOG(Error) << "========= OpenGL Error: " << errCode << ": " << errString << " =========\n";
     }
 }
 
-// Returns the smallest N such that 2^N >= x
-int getNext2PowN(int x)
+// maximale Breite und Höhe einer Textur
+int getMaxTextureSize()
 {
-    int p = 1;
-    while (p < x) p <<= 1;
-    return p;
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    return maxSize > 0 ? maxSize : 1024;
 }
 
 // Textur laden
@@ -76,117 +83,170 @@ void TextureManager::loadTexture(const std::string& fileName, TextureId id, cons
 {
     if ( m_textures.count( id )==1 )
     {
-        log(Warning) << "Loading texture: ID \"" << id << "\" already exists, new texture was not loaded\n";
+        AA_LOG(Warning) << "Loading texture: ID \"" << id << "\" already exists, new texture was not loaded\n";
         return;
     }
-    try
+    DecodedTexture texture (fileName, id, loadTexInfo);
+    decodeTexture(texture, getMaxTextureSize(), m_cache.get());
+    addDecodedTexture(texture, w, pH);
+}
+
+void TextureManager::loadTextures(const std::vector<DecodedTexture>& textures)
+{
+    // IDs, die schon existieren, werden übersprungen (wie in loadTexture)
+    std::vector<DecodedTexture> texturesToLoad;
+    std::set<TextureId> ids;
+    foreach (const DecodedTexture& texture, textures)
     {
-        log(Info) << "Loading texture \"" << fileName << "\"... ";
-
-        ILuint devIl_tex_id;                              // ID des DevIL Bildes
-        ILboolean success;                                // Speichert ob die Funktionen erfolgreich sind
-        ilGenImages(1, &devIl_tex_id);                    // neue Bild ID
-        ilBindImage(devIl_tex_id);                        // Textur binden (als aktuelle setzen)
-        success = ilLoadImage( (ILstring)fileName.c_str() );  // bild laden
-        if (success)                                      // Falls keine Fehler
-        {
-            if ( w != NULL )
-                *w = ilGetInteger(IL_IMAGE_WIDTH);
-            if ( pH != NULL )
-                *pH = ilGetInteger(IL_IMAGE_HEIGHT);
-            // Breite und Höhe müssen in der Form 2^n darstellbar sein. (n ist eine natürliche Zahl)
-            // Hier erhalten sie den nächsthöheren Wert der 2^n erfüllt.
-            int width = ilGetInteger(IL_IMAGE_WIDTH);
-            int height = ilGetInteger(IL_IMAGE_HEIGHT);
-            int depht = ilGetInteger(IL_IMAGE_DEPTH);
-            int width_2pown = getNext2PowN(width);
-            int height_2pown = getNext2PowN(height);
-
-            //log() << "GL: w=%i, h=%i\n", width_2pown, height_2pown );
-
-            // TODO: don't shift small numbers
-            switch (loadTexInfo.quality)
-            {
-            case QualityBest:
-                if (width != width_2pown || height != height_2pown)
-                    iluScale( width_2pown, height_2pown, depht);
-                break;
-            case QualityGood:
-                iluScale( width_2pown>>1, height_2pown>>1, depht);
-                break;
-            case QualityMiddle:
-                iluScale( width_2pown>>2, height_2pown>>2, depht);
-                break;
-            case QualityLow:
-                iluScale( width_2pown>>3, height_2pown>>3, depht);
-                break;
-            case QualityLowest:
-                iluScale( width_2pown>>4, height_2pown>>4, depht);
-                break;
-            }
+        if ( m_textures.count( texture.id )==1 || !ids.insert( texture.id ).second )
+            AA_LOG(Warning) << "Loading texture: ID \"" << texture.id << "\" already exists, new texture was not loaded\n";
+        else
+            texturesToLoad.push_back(texture);
+    }
 
-            success = ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE); // Farbkomponente in unsigned byte konvertieren
-            if (!success)
-                throw 0; // Error
+    // Hochladen in der gleichen Reihenfolge, damit die OpenGL IDs die gleichen sind wie beim seriellen Laden.
+    // Wird eine Exception geworfen, bricht der TextureDecoder die restlichen Texturen ab.
+    TextureDecoder decoder (texturesToLoad, getMaxTextureSize(), TextureDecoder::getDefaultNumThreads(), m_cache.get());
+    for (size_t i = 0; i < texturesToLoad.size(); ++i)
+    {
+        DecodedTexture& texture = decoder.waitFor(i);
+        addDecodedTexture(texture, NULL, NULL);
+        texture.levels.clear(); // Speicher freigeben, es gibt jetzt eine Kopie in OpenGL
+    }
+}
 
-            GLuint openGl_tex_id;
+void TextureManager::addDecodedTexture(const DecodedTexture& texture, int* w, int* h)
+{
+    AA_LOG(Detail) << "Loading texture \"" << texture.fileName << "\"" << (texture.fromCache ? " (baked)" : "") << "... ";
+    if (!texture.success)
+        throw DataLoadException("Error while loading the texture \"" + texture.fileName + "\": " + texture.errorMsg + ".\n");
+
+    if ( w != NULL )
+        *w = texture.originalWidth;
+    if ( h != NULL )
+        *h = texture.originalHeight;
+
+    TexInfo texInfo;
+    texInfo.glTexId = uploadTexture(texture.levels, texture.info);
+    texInfo.scale = texture.info.scale;
+    m_textures.insert( std::make_pair(texture.id,texInfo) ); // Textur in m_textures eintragen
+    AA_LOG(Detail) << "Done!\n";
+    CheckOpenlGlError();
+}
 
-            glGenTextures(1, &openGl_tex_id); // OpenGL Texture generieren
-            glBindTexture(GL_TEXTURE_2D, openGl_tex_id); // binden
+// Textur in die Grafikkarte laden (RGBA Daten mit allen Mipmaps), gibt die OpenGL ID zurück
+unsigned int TextureManager::uploadTexture(const std::vector<RgbaImage>& levels, const LoadTextureInfo& loadTexInfo)
+{
+    GLuint openGl_tex_id;
 
-            log(Detail) << "OpenGL ID: " << openGl_tex_id << " ";
+    glGenTextures(1, &openGl_tex_id); // OpenGL Texture generieren
+    glBindTexture(GL_TEXTURE_2D, openGl_tex_id); // binden
 
-            GLint texWrapModeX = (loadTexInfo.wrapModeX == WrapClamp) ? GL_CLAMP : GL_REPEAT;
-            GLint texWrapModeY = (loadTexInfo.wrapModeY == WrapClamp) ? GL_CLAMP : GL_REPEAT;
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texWrapModeX);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texWrapModeY);
+    AA_LOG(Detail) << "OpenGL ID: " << openGl_tex_id << " ";
 
-            if (loadTexInfo.loadMipmaps)
-            {
-                // Textur-Parameter setzen -> bestimmt die Qualität
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-
-                // Textur wird hier in die Grafikkarte geladen! Dabei werden Mipmaps generiert.
-                gluBuild2DMipmaps(GL_TEXTURE_2D,                    // 2D Textur wird geladen
-                                  GL_RGBA,                          // Farbiges Bild mit Alpha-Kanal
-                                  ilGetInteger(IL_IMAGE_WIDTH),     // Breite des Bildes
-                                  ilGetInteger(IL_IMAGE_HEIGHT),    // Höhe des Bildes
-                                  GL_RGBA,                          // Format
-                                  GL_UNSIGNED_BYTE,                 // Wie Daten aufgeschriben sind
-                                  ilGetData());                     // Die Bilddaten überhaupt (Pixels)
-                // TODO: GL_RGBA is not necessarily
-            }
-            else
-            {
-                // Textur-Parameter setzen -> bestimmt die Qualität
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-                // Das ist die Alternative ohne Mipmaps
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, ilGetInteger(IL_IMAGE_WIDTH),
-                    ilGetInteger(IL_IMAGE_HEIGHT), 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                    ilGetData());
-            }
-            TexInfo texInfo;
-            texInfo.glTexId = openGl_tex_id;
-            texInfo.scale = loadTexInfo.scale;
-            m_textures.insert( std::make_pair(id,texInfo) ); // Textur in m_textures eintragen
+    GLint texWrapModeX = (loadTexInfo.wrapModeX == WrapClamp) ? GL_CLAMP : GL_REPEAT;
+    GLint texWrapModeY = (loadTexInfo.wrapModeY == WrapClamp) ? GL_CLAMP : GL_REPEAT;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texWrapModeX);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texWrapModeY);
+
+    // Textur-Parameter setzen -> bestimmt die Qualität
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (levels.size() > 1)
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    else
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+    // Textur wird hier in die Grafikkarte geladen! Die Mipmaps wurden schon von TextureDecoder erzeugt.
+    for (size_t level = 0; level < levels.size(); ++level)
+    {
+        const RgbaImage& image = levels[level];
+        glTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &image.data[0]);
+    }
+    return openGl_tex_id;
+}
+
+namespace {
+
+// Abstand zwischen den Bildern im Atlas (wird mit den Randpixeln gefüllt)
+const int cAtlasPadding = 2;
+
+// Bild (RGBA) in den Atlas kopieren, inklusive der Randpixel im Abstand
+void blitToAtlas(std::vector<unsigned char>& atlas, int atlasWidth, const AtlasImage& image, const unsigned char* data, int padding)
+{
+    for (int row = -padding; row < image.height + padding; ++row)
+    {
+        int srcRow = std::min(std::max(row, 0), image.height - 1);
+        for (int col = -padding; col < image.width + padding; ++col)
+        {
+            int srcCol = std::min(std::max(col, 0), image.width - 1);
+            const unsigned char* src = data + 4 * (srcRow * image.width + srcCol);
+            unsigned char* dst = &atlas[4 * ((image.y + row) * atlasWidth + image.x + col)];
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = src[3];
         }
-        else
-             throw 0; // Error
+    }
+}
+
+}
+
+bool TextureManager::loadAtlas(const std::vector<std::string>& fileNames, TextureId id, const LoadTextureInfo& loadTexInfo, std::vector<TexRect>* rects)
+{
+    if ( m_textures.count( id )==1 )
+    {
+        AA_LOG(Warning) << "Loading texture atlas: ID \"" << id << "\" already exists, new texture was not loaded\n";
+        return false;
+    }
+    if ( fileNames.empty() )
+        return false;
+
+    // alle Bilder laden (die Qualität wird bei jedem Bild einzeln reduziert)
+    std::vector<RgbaImage> frames (fileNames.size());
+    std::vector<AtlasImage> images;
+    for (size_t i = 0; i < fileNames.size(); ++i)
+    {
+        std::string errorMsg;
+        bool fromCache = false;
+        if ( !decodeAnimFrame(fileNames[i], loadTexInfo.quality, frames[i], errorMsg, m_cache.get(), &fromCache) )
+            throw DataLoadException("Error while loading the texture \"" + fileNames[i] + "\": " + errorMsg + ".\n");
+        AA_LOG(Detail) << "Loaded texture \"" << fileNames[i] << "\"" << (fromCache ? " (baked)" : "") << "\n";
+        images.push_back(AtlasImage(frames[i].width, frames[i].height));
+    }
 
-        ilDeleteImages(1, &devIl_tex_id); // Löschen weil es schon eine kopie in OpenGL gibt
-        log(Info) << "Done!\n";
+    int maxSize = getMaxTextureSize();
+    AtlasPacker packer (cAtlasPadding, maxSize);
+    if ( !packer.pack(images) )
+    {
+        AA_LOG(Warning) << "Texture atlas \"" << id << "\" does not fit in " << maxSize << "x" << maxSize << " pixels\n";
+        return false;
     }
-    catch (...)
+
+    std::vector<RgbaImage> atlasLevels (1, RgbaImage(packer.getWidth(), packer.getHeight()));
+    for (size_t i = 0; i < images.size(); ++i)
     {
-        // Error
-        throw DataLoadException("Error while loading the texture \"" + fileName + "\": " + iluErrorString(ilGetError()) + ".\n");
+        blitToAtlas(atlasLevels[0].data, packer.getWidth(), images[i], &frames[i].data[0], packer.getPadding());
+        frames[i] = RgbaImage(); // Speicher freigeben
     }
+
+    AA_LOG(Info) << "Uploading texture atlas \"" << id << "\" (" << packer.getWidth() << "x" << packer.getHeight() << ")... ";
+    LoadTextureInfo atlasTexInfo = loadTexInfo;
+    atlasTexInfo.wrapModeX = WrapClamp; // Wiederholen geht nicht mit einem Atlas
+    atlasTexInfo.wrapModeY = WrapClamp;
+    TexInfo texInfo;
+    if (atlasTexInfo.loadMipmaps)
+        buildMipmaps(atlasLevels);
+    texInfo.glTexId = uploadTexture(atlasLevels, atlasTexInfo);
+    texInfo.scale = loadTexInfo.scale;
+    m_textures.insert( std::make_pair(id,texInfo) );
+    AA_LOG(Info) << "Done!\n";
+
+    rects->resize(images.size());
+    for (size_t i = 0; i < images.size(); ++i)
+        (*rects)[i] = packer.getTexRect(images[i]);
+
     CheckOpenlGlError();
-    if (ilGetError())
-        log(Warning) << "DevIL error: " << iluErrorString(ilGetError()) << "\n";
+    return true;
 }
 
 void TextureManager::freeTexture(const TextureId& id)
@@ -205,7 +265,7 @@ void TextureManager::freeTextureMemory(const TexInfo& tex)
 
     if ( (unsigned)curTexId == tex.glTexId )
         glDisable( GL_TEXTURE_2D );
-    log(Detail) << "Deleting OpenGL texture " << tex.glTexId << "\n";
+    AA_LOG(Detail) << "Deleting OpenGL texture " << tex.glTexId << "\n";
     glDeleteTextures(1, &tex.glTexId);
 }
 
@@ -222,7 +282,7 @@ void TextureManager::setTexture( const TextureId& id )
         glMatrixMode(GL_MODELVIEW);
     }
     else
-        log(Warning) << "*** SetTexture(): Texture ID '" << id << "' not found! ***\n";
+        AA_LOG(Warning) << "*** SetTexture(): Texture ID '" << id << "' not found! ***\n";
 }
 
 std::vector<TextureId> TextureManager::getTextureList() const
@@ -261,11 +321,58 @@ AnimationManager::~AnimationManager()
 }
 
 // Lädt eine Animationsdatei
+namespace {
+
+// Liest den Anfang einer .anim Datei: die Dateinamen der Frames und ihre Nummern (mit führenden Nullen)
+bool readAnimFrames(std::istream& input_stream, const std::string& fileName, std::vector<std::string>& files, std::vector<std::string>& numbers)
+{
+    std::string prefix;
+    std::string suffix;
+    int num_digits;
+    int num_frames;
+
+    if ( !(input_stream >> num_frames) )
+        return false;
+    if ( !(input_stream >> prefix) )
+        return false;
+    if ( !(input_stream >> num_digits) )
+        return false;
+    if ( !(input_stream >> suffix ) )
+        return false;
+
+    std::string path = fileName.substr( 0, fileName.find_last_of('/')+1 );
+
+    files.resize(num_frames);
+    numbers.resize(num_frames);
+    for ( int i = 0 ; i < num_frames; ++i )
+    {
+        std::stringstream digits_str;
+        digits_str.fill('0');
+        digits_str.width(num_digits);
+        digits_str << i;
+        numbers[i] = digits_str.str();
+        files[i] = path + prefix + numbers[i] + suffix;
+    }
+    return true;
+}
+
+}
+
+std::vector<std::string> AnimationManager::getFrameFileNames(const std::string& fileName)
+{
+    std::ifstream input_stream (fileName.c_str());
+    std::vector<std::string> files;
+    std::vector<std::string> numbers;
+    if ( !input_stream || !readAnimFrames( input_stream, fileName, files, numbers ) )
+        throw DataLoadException("Error loading '" + fileName + "'. (Bad syntax?)\n");
+    return files;
+}
+
 void AnimationManager::loadAnimation(const std::string& fileName, AnimationId id, const LoadTextureInfo& texInfo)
 {
     if ( m_animInfoMap.count( id )==1 )
     {
-        log(Warning) << "Loading animation: ID '" << id << "' exists already, new animation was not loaded\n";
+        AA_LOG(Warning) << "Loading animation: ID '" << id << "' exists already, new animation was not loaded\n";
         return;
     }
 
@@ -280,35 +387,38 @@ void AnimationManager::loadAnimation(const std::string& fileName, AnimationId id
 
     try
     {
-        std::string prefix;
-        std::string suffix;
-        int num_digits;
-        int num_frames;
-
-        if ( !(input_stream >> num_frames) )
-            throw 0;
-        if ( !(input_stream >> prefix) )
-            throw 0;
-        if ( !(input_stream >> num_digits) )
-            throw 0;
-        if ( !(input_stream >> suffix ) )
+        std::vector<std::string> files_to_load;
+        std::vector<std::string> frame_numbers;
+        if ( !readAnimFrames( input_stream, fileName, files_to_load, frame_numbers ) )
             throw 0;
+        int num_frames = (int)files_to_load.size();
 
-        std::string str_name ( fileName );
-        std::string path = str_name.substr( 0, str_name.find_last_of('/')+1 );
-
+        std::vector<TextureId> frame_tex_ids (num_frames);
         for ( int i = 0 ; i < num_frames; ++i )
+            frame_tex_ids[i] = std::string("_")+id+frame_numbers[i];
+
+        // Alle Frames in eine Textur packen, damit beim Abspielen nur die Texturkoordinaten wechseln.
+        // Falls sie zu gross sind, wird jeder Frame als eigene Textur geladen.
+        pAnimInfo->frames.resize(num_frames);
+        std::vector<TexRect> rects;
+        TextureId atlas_id = std::string("_")+id+"_atlas";
+        if ( m_texManager.loadAtlas(files_to_load, atlas_id, texInfo, &rects) )
         {
-            std::stringstream digits_str;
-            digits_str.fill('0');
-            digits_str.width(num_digits);
-            digits_str << i;
-            std::string file_to_load = path + prefix + digits_str.str() + suffix;
-            TextureId tex_id = std::string("_")+id+digits_str.str();
-            m_texManager.loadTexture(file_to_load, tex_id, texInfo);
+            for ( int i = 0 ; i < num_frames; ++i )
+            {
+                pAnimInfo->frames[i].texture = atlas_id;
+                pAnimInfo->frames[i].rect = rects[i];
+            }
+        }
+        else
+        {
+            for ( int i = 0 ; i < num_frames; ++i )
+            {
+                m_texManager.loadTexture(files_to_load[i], frame_tex_ids[i], texInfo);
+                pAnimInfo->frames[i].texture = frame_tex_ids[i];
+            }
         }
         pAnimInfo->totalFrames = num_frames;
-        pAnimInfo->numDigits = num_digits;
         pAnimInfo->name = id;
 
         AnimStateId stateId;
@@ -363,13 +473,9 @@ void AnimationManager::freeAnimation(AnimationId id)
 
 void AnimationManager::freeAnimationMemory(const AnimInfo& animInfo)
 {
-    for (int i = 0; i < animInfo.totalFrames; ++i)
-    {
-        std::stringstream frameNum;
-        frameNum.fill('0');
-        frameNum.width(animInfo.numDigits);
-        frameNum << i;
-        m_texManager.freeTexture(std::string("_") + animInfo.name + frameNum.str());
-    }
+    std::set<TextureId> textures;
+    foreach (const AnimFrame& frame, animInfo.frames)
+        textures.insert(frame.texture);
+    foreach (const TextureId& texture, textures)
+        m_texManager.freeTexture(texture);
 }
-
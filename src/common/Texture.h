@@ -14,9 +14,15 @@
 #include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "TextureAtlas.h"
 
 class LoadTextureInfo;
 class TexInfo;
+class RgbaImage;
+class DecodedTexture;
+class TextureCache;
 
 typedef std::string TextureId;
 typedef std::string AnimationId;
@@ -30,14 +36,24 @@ public:
     TextureManager();
     ~TextureManager();
     void loadTexture(const std::string& fileName, TextureId, const LoadTextureInfo&, int* w=NULL, int* h=NULL);
+    // Mehrere Texturen laden: die Bilder werden parallel dekodiert (TextureDecoder) und
+    // in der gleichen Reihenfolge hochgeladen wie mit loadTexture().
+    void loadTextures(const std::vector<DecodedTexture>& textures);
+    // Mehrere Bilder in eine Textur packen. rects erhält die Texturkoordinaten jedes Bildes.
+    // Gibt false zurück (ohne etwas zu laden), falls die Bilder nicht in eine Textur passen.
+    bool loadAtlas(const std::vector<std::string>& fileNames, TextureId, const LoadTextureInfo&, std::vector<TexRect>* rects);
     void freeTexture(const TextureId&);
     void setTexture(const TextureId&);
     std::vector<TextureId> getTextureList() const;
     void clear();
 private:
+    // fügt eine dekodierte Textur hinzu (wirft DataLoadException, falls das Dekodieren fehlgeschlagen ist)
+    void addDecodedTexture(const DecodedTexture& texture, int* w, int* h);
+    unsigned int uploadTexture(const std::vector<RgbaImage>& levels, const LoadTextureInfo&);
     void freeTextureMemory(const TexInfo& tex);
     typedef std::map<TextureId, TexInfo> TextureMap;
     TextureMap m_textures;      // Textur-Addressen für OpenGL
+    boost::scoped_ptr<TextureCache> m_cache; // gebackene Texturen (AABake)
 };
 
 typedef std::string AnimStateId;
@@ -57,6 +73,9 @@ public:
     void freeAnimation(AnimationId id);
     const AnimInfo* getAnimInfo(AnimationId animId) const;
 
+    // Bilddateien der Frames einer .anim Datei (wirft DataLoadException)
+    static std::vector<std::string> getFrameFileNames(const std::string& fileName);
+
 private:
     void freeAnimationMemory(const AnimInfo&);
     typedef std::map<AnimationId, boost::shared_ptr<AnimInfo> > AnimInfoMap;
@@ -107,13 +126,21 @@ public:
     std::set< int > stops;
 };
 
+// Ein Bild einer Animation (normalerweise ein Teil der Atlas-Textur der Animation)
+class AnimFrame
+{
+public:
+    TextureId texture;
+    TexRect rect;
+};
+
 // Informationen einer Animation
 class AnimInfo
 {
 public:
     AnimationId name;
     int totalFrames;
-    int numDigits;
+    std::vector<AnimFrame> frames;
     StateInfoMap states;
 };
 
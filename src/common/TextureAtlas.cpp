@@ -0,0 +1,107 @@
+/*
+ * TextureAtlas.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "TextureAtlas.h"
+
+#include <algorithm>
+
+namespace {
+
+int nextPowerOfTwo(int x)
+{
+    int p = 1;
+    while (p < x) p <<= 1;
+    return p;
+}
+
+// höhere Bilder zuerst, damit die Reihen gut gefüllt werden
+class HigherImageFirst
+{
+public:
+    HigherImageFirst(const std::vector<AtlasImage>& images) : m_images (images) {}
+    bool operator()(size_t a, size_t b) const { return m_images[a].height > m_images[b].height; }
+private:
+    const std::vector<AtlasImage>& m_images;
+};
+
+}
+
+AtlasPacker::AtlasPacker(int padding, int maxSize)
+: m_padding (padding), m_maxSize (maxSize), m_width (0), m_height (0)
+{}
+
+int AtlasPacker::packWithWidth(std::vector<AtlasImage>& images, const std::vector<size_t>& order, int width) const
+{
+    int x = 0, y = 0, shelfHeight = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        AtlasImage& image = images[order[i]];
+        int w = image.width + 2 * m_padding;
+        int h = image.height + 2 * m_padding;
+        if (w > width)
+            return 0;
+        if (x + w > width) // neue Reihe
+        {
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        image.x = x + m_padding;
+        image.y = y + m_padding;
+        x += w;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+    return y + shelfHeight;
+}
+
+bool AtlasPacker::pack(std::vector<AtlasImage>& images)
+{
+    m_width = m_height = 0;
+    if (images.empty())
+        return true;
+
+    std::vector<size_t> order (images.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), HigherImageFirst(images));
+
+    // alle möglichen Breiten ausprobieren und den kleinsten Atlas nehmen
+    int bestWidth = 0, bestHeight = 0;
+    for (int width = 1; width <= m_maxSize; width <<= 1)
+    {
+        int usedHeight = packWithWidth(images, order, width);
+        if (usedHeight == 0)
+            continue;
+        int height = nextPowerOfTwo(usedHeight);
+        if (height > m_maxSize)
+            continue;
+        long area = (long)width * height;
+        long bestArea = (long)bestWidth * bestHeight;
+        if (bestWidth == 0 || area < bestArea ||
+            (area == bestArea && std::max(width, height) < std::max(bestWidth, bestHeight)))
+        {
+            bestWidth = width;
+            bestHeight = height;
+        }
+    }
+    if (bestWidth == 0)
+        return false;
+
+    packWithWidth(images, order, bestWidth);
+    m_width = bestWidth;
+    m_height = bestHeight;
+    return true;
+}
+
+TexRect AtlasPacker::getTexRect(const AtlasImage& image) const
+{
+    if (m_width == 0 || m_height == 0)
+        return TexRect();
+    return TexRect( (float)image.x / m_width,
+                    (float)image.y / m_height,
+                    (float)(image.x + image.width) / m_width,
+                    (float)(image.y + image.height) / m_height );
+}
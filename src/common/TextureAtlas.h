@@ -0,0 +1,62 @@
+/*
+ * TextureAtlas.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Mehrere Bilder in eine Textur packen (z.B. die Frames einer Animation),
+// damit beim Zeichnen nur die Texturkoordinaten wechseln und nicht die Textur.
+
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <vector>
+#include <cstddef>
+
+// Rechteck in Texturkoordinaten (0..1), top ist die erste Bildzeile
+class TexRect
+{
+public:
+    TexRect() : left (0.0f), top (0.0f), right (1.0f), bottom (1.0f) {}
+    TexRect(float l, float t, float r, float b) : left (l), top (t), right (r), bottom (b) {}
+    float left, top, right, bottom;
+};
+
+// Ein Bild im Atlas (Grösse und Position in Pixel)
+class AtlasImage
+{
+public:
+    AtlasImage(int w = 0, int h = 0) : width (w), height (h), x (0), y (0) {}
+    int width, height;
+    int x, y; // gesetzt von AtlasPacker::pack()
+};
+
+// Ordnet Bilder in Reihen ("shelves") an. Die Grösse des Atlas ist immer eine Zweierpotenz.
+class AtlasPacker
+{
+public:
+    // padding: Abstand um jedes Bild (gegen Farbbluten beim linearen Filtern)
+    // maxSize: maximale Breite und Höhe des Atlas (GL_MAX_TEXTURE_SIZE)
+    AtlasPacker(int padding, int maxSize);
+
+    // Setzt x und y aller Bilder. Gibt false zurück, falls die Bilder keinen Platz haben.
+    bool pack(std::vector<AtlasImage>& images);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getPadding() const { return m_padding; }
+
+    // Texturkoordinaten eines gepackten Bildes
+    TexRect getTexRect(const AtlasImage& image) const;
+
+private:
+    // Höhe des Atlas wenn er width breit ist (0 falls nicht möglich)
+    int packWithWidth(std::vector<AtlasImage>& images, const std::vector<size_t>& order, int width) const;
+
+    int m_padding;
+    int m_maxSize;
+    int m_width;
+    int m_height;
+};
+
+#endif
@@ -0,0 +1,259 @@
+/*
+ * TextureCache.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "TextureCache.h"
+
+#include "DataLoader.h"
+#include "Foreach.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include <boost/property_tree/info_parser.hpp>
+
+using boost::property_tree::ptree;
+
+namespace {
+
+const char cMagic[4] = { 'A', 'A', 'T', 'C' };
+const boost::uint32_t cVersion = 1;
+const size_t cHeaderSize = sizeof(cMagic) + sizeof(boost::uint32_t);
+
+const char* getKindName(TextureCache::Kind kind)
+{
+    return kind == TextureCache::KindTexture ? "texture" : "animFrame";
+}
+
+// Anzahl Bytes aller Mipmaps ab width x height
+size_t getLevelsSize(int width, int height, int numLevels)
+{
+    size_t size = 0;
+    for (int i = 0; i < numLevels; ++i)
+    {
+        size += 4 * (size_t)width * height;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return size;
+}
+
+std::string hashToString(boost::uint64_t hash)
+{
+    std::ostringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return ss.str();
+}
+
+bool stringToHash(const std::string& str, boost::uint64_t& hash)
+{
+    std::istringstream ss (str);
+    return (ss >> std::hex >> hash) && ss.eof();
+}
+
+}
+
+TextureCache::TextureCache()
+: m_entries (),
+  m_file ()
+{
+}
+
+std::string TextureCache::makeKey(const std::string& sourceFileName, Kind kind, TexQuality quality)
+{
+    std::ostringstream ss;
+    ss << getKindName(kind) << ':' << (int)quality << ':' << sourceFileName;
+    return ss.str();
+}
+
+bool TextureCache::open(const std::string& manifestFileName)
+{
+    close();
+
+    ptree manifest;
+    try
+    {
+        read_info(manifestFileName, manifest);
+    }
+    catch (boost::property_tree::ptree_error&)
+    {
+        AA_LOG(Info) << "No baked textures (\"" << manifestFileName << "\"), run AABake to create them\n";
+        return false;
+    }
+
+    try
+    {
+        if (manifest.get<boost::uint32_t>("version") != cVersion)
+        {
+            AA_LOG(Warning) << "Baked textures \"" << manifestFileName << "\" have an old version, run AABake again\n";
+            return false;
+        }
+        std::string cacheFileName = manifest.get<std::string>("cacheFile");
+        size_t cacheSize = manifest.get<size_t>("cacheSize");
+        if (!m_file.open(cacheFileName) || m_file.getSize() != cacheSize || cacheSize < cHeaderSize ||
+            std::memcmp(m_file.getData(), cMagic, sizeof(cMagic)) != 0)
+        {
+            AA_LOG(Warning) << "Baked texture file \"" << cacheFileName << "\" is missing or does not match the manifest\n";
+            close();
+            return false;
+        }
+
+        foreach (const ptree::value_type& value, manifest)
+        {
+            if (value.first != "entry")
+                continue;
+            const ptree& entryTree = value.second;
+            Entry entry;
+            if (!stringToHash(entryTree.get<std::string>("hash"), entry.sourceHash))
+                throw DataLoadException("bad hash");
+            entry.width = entryTree.get<int>("width");
+            entry.height = entryTree.get<int>("height");
+            entry.numLevels = entryTree.get<int>("levels");
+            entry.originalWidth = entryTree.get<int>("originalWidth");
+            entry.originalHeight = entryTree.get<int>("originalHeight");
+            entry.offset = entryTree.get<size_t>("offset");
+            if (entry.width <= 0 || entry.height <= 0 || entry.numLevels <= 0 || entry.offset < cHeaderSize ||
+                entry.offset + getLevelsSize(entry.width, entry.height, entry.numLevels) > cacheSize)
+                throw DataLoadException("entry outside of the cache file");
+
+            TexQuality quality = (TexQuality)entryTree.get<int>("quality");
+            Kind kind = entryTree.get<std::string>("kind") == getKindName(KindTexture) ? KindTexture : KindAnimFrame;
+            m_entries[makeKey(entryTree.get<std::string>("source"), kind, quality)] = entry;
+        }
+    }
+    catch (boost::property_tree::ptree_error& e)
+    {
+        AA_LOG(Warning) << "Bad baked texture manifest \"" << manifestFileName << "\": " << e.what() << "\n";
+        close();
+        return false;
+    }
+    catch (DataLoadException& e)
+    {
+        AA_LOG(Warning) << "Bad baked texture manifest \"" << manifestFileName << "\": " << e.getMsg() << "\n";
+        close();
+        return false;
+    }
+
+    AA_LOG(Info) << "Using " << m_entries.size() << " baked textures from \"" << manifestFileName << "\"\n";
+    return true;
+}
+
+void TextureCache::close()
+{
+    m_entries.clear();
+    m_file.close();
+}
+
+bool TextureCache::load(const std::string& sourceFileName, Kind kind, TexQuality quality, std::vector<RgbaImage>& levels,
+                        int* originalWidth, int* originalHeight) const
+{
+    if (!isOpen())
+        return false;
+    EntryMap::const_iterator it = m_entries.find(makeKey(sourceFileName, kind, quality));
+    if (it == m_entries.end())
+        return false;
+    const Entry& entry = it->second;
+
+    boost::uint64_t hash = 0;
+    if (!hashFile(sourceFileName, hash) || hash != entry.sourceHash)
+        return false; // Quelldatei wurde verändert
+
+    levels.clear();
+    levels.reserve(entry.numLevels);
+    const char* data = m_file.getData() + entry.offset;
+    int width = entry.width;
+    int height = entry.height;
+    for (int i = 0; i < entry.numLevels; ++i)
+    {
+        levels.push_back(RgbaImage(width, height));
+        std::memcpy(&levels.back().data[0], data, levels.back().data.size());
+        data += levels.back().data.size();
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    if (originalWidth)
+        *originalWidth = entry.originalWidth;
+    if (originalHeight)
+        *originalHeight = entry.originalHeight;
+    return true;
+}
+
+bool TextureCache::hashFile(const std::string& fileName, boost::uint64_t& hash)
+{
+    MappedFile file;
+    if (!file.open(fileName))
+        return false;
+    hash = 14695981039346656037ULL;
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(file.getData());
+    for (size_t i = 0; i < file.getSize(); ++i)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return true;
+}
+
+TextureCacheWriter::TextureCacheWriter(const std::string& manifestFileName, const std::string& cacheFileName)
+: m_manifestFileName (manifestFileName),
+  m_cacheFileName (cacheFileName),
+  m_cacheFile (cacheFileName.c_str(), std::ios::binary),
+  m_manifest (),
+  m_offset (cHeaderSize),
+  m_numEntries (0)
+{
+    if (!m_cacheFile)
+        throw DataLoadException("Could not write baked texture file \"" + cacheFileName + "\"");
+    boost::uint32_t version = cVersion;
+    m_cacheFile.write(cMagic, sizeof(cMagic));
+    m_cacheFile.write(reinterpret_cast<const char*>(&version), sizeof(version));
+}
+
+void TextureCacheWriter::add(const std::string& sourceFileName, boost::uint64_t sourceHash, TextureCache::Kind kind, TexQuality quality,
+                             const std::vector<RgbaImage>& levels, int originalWidth, int originalHeight)
+{
+    ptree& entry = m_manifest.add("entry", "");
+    entry.put("source", sourceFileName);
+    entry.put("hash", hashToString(sourceHash));
+    entry.put("kind", getKindName(kind));
+    entry.put("quality", (int)quality);
+    entry.put("width", levels.front().width);
+    entry.put("height", levels.front().height);
+    entry.put("levels", levels.size());
+    entry.put("originalWidth", originalWidth);
+    entry.put("originalHeight", originalHeight);
+    entry.put("offset", m_offset);
+
+    foreach (const RgbaImage& level, levels)
+    {
+        m_cacheFile.write(reinterpret_cast<const char*>(&level.data[0]), level.data.size());
+        m_offset += level.data.size();
+    }
+    ++m_numEntries;
+}
+
+void TextureCacheWriter::finish()
+{
+    m_cacheFile.close();
+    if (!m_cacheFile)
+        throw DataLoadException("Could not write baked texture file \"" + m_cacheFileName + "\"");
+
+    // Kopf zuerst, damit man das Manifest auch von Hand lesen kann
+    ptree manifest;
+    manifest.put("version", cVersion);
+    manifest.put("cacheFile", m_cacheFileName);
+    manifest.put("cacheSize", m_offset);
+    foreach (const ptree::value_type& value, m_manifest)
+        manifest.push_back(value);
+    try
+    {
+        write_info(m_manifestFileName, manifest);
+    }
+    catch (boost::property_tree::ptree_error& e)
+    {
+        throw DataLoadException(e.what());
+    }
+}
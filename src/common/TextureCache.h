@@ -0,0 +1,107 @@
+/*
+ * TextureCache.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Vorberechnete Texturen (mit AABake skaliert und mit Mipmaps), damit sie beim Start nicht
+// dekodiert und skaliert werden müssen.
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include "MappedFile.h"
+#include "Texture.h"
+#include "TextureDecoder.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <boost/cstdint.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+/*
+    Der Cache besteht aus zwei Dateien:
+    - der Cache-Datei: "AATC", Version (uint32), danach die RGBA Daten aller Bilder
+    - dem Manifest (INFO-Datei): pro Bild die Quelldatei, deren Hash, die Qualität, die Art,
+      die Grösse und die Position in der Cache-Datei
+
+    Ein Bild ist nur gültig, solange der Hash der Quelldatei gleich ist. Sonst (oder wenn es
+    fehlt) wird die Quelldatei wie bisher geladen.
+*/
+
+const std::string cTextureCacheManifest = "data/baked_textures.info";
+const std::string cTextureCacheFile = "data/baked_textures.bin";
+
+class TextureCache
+{
+public:
+    enum Kind
+    {
+        KindTexture,   // wie decodeTexture(): Zweierpotenz, je nach Qualität verkleinert, alle Mipmaps
+        KindAnimFrame  // wie ein Bild im Atlas einer Animation: nur je nach Qualität verkleinert, ohne Mipmaps
+    };
+
+    TextureCache();
+
+    // gibt false zurück, wenn es keinen (gültigen) Cache gibt
+    bool open(const std::string& manifestFileName);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Kopiert die Bilder (levels[0] ist das ganze Bild, danach die Mipmaps), falls die Quelldatei
+    // seit dem Backen nicht verändert wurde. Kann von mehreren Threads gleichzeitig aufgerufen werden.
+    bool load(const std::string& sourceFileName, Kind kind, TexQuality quality, std::vector<RgbaImage>& levels,
+              int* originalWidth = NULL, int* originalHeight = NULL) const;
+
+    // 64 Bit FNV-1a Hash des Inhalts einer Datei
+    static bool hashFile(const std::string& fileName, boost::uint64_t& hash);
+
+private:
+    TextureCache(const TextureCache&);
+    TextureCache& operator = (const TextureCache&);
+
+    class Entry
+    {
+    public:
+        boost::uint64_t sourceHash;
+        int width, height;      // levels[0]
+        int numLevels;
+        int originalWidth, originalHeight;
+        size_t offset;
+    };
+    typedef std::map<std::string, Entry> EntryMap;
+
+    EntryMap m_entries;
+    MappedFile m_file;
+
+    friend class TextureCacheWriter;
+    static std::string makeKey(const std::string& sourceFileName, Kind kind, TexQuality quality);
+};
+
+// Schreibt einen neuen Cache (wird von AABake verwendet)
+class TextureCacheWriter
+{
+public:
+    // wirft DataLoadException, falls die Cache-Datei nicht geschrieben werden kann
+    TextureCacheWriter(const std::string& manifestFileName, const std::string& cacheFileName);
+
+    void add(const std::string& sourceFileName, boost::uint64_t sourceHash, TextureCache::Kind kind, TexQuality quality,
+             const std::vector<RgbaImage>& levels, int originalWidth, int originalHeight);
+    // schreibt das Manifest (erst danach ist der Cache gültig)
+    void finish();
+
+    size_t getNumEntries() const { return m_numEntries; }
+    boost::uint64_t getDataSize() const { return m_offset; }
+
+private:
+    std::string m_manifestFileName;
+    std::string m_cacheFileName;
+    std::ofstream m_cacheFile;
+    boost::property_tree::ptree m_manifest;
+    boost::uint64_t m_offset;
+    size_t m_numEntries;
+};
+
+#endif
@@ -0,0 +1,503 @@
+/*
+ * TextureDecoder.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "TextureDecoder.h"
+
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <csetjmp>
+#include <IL/il.h>
+#include <IL/ilu.h>
+#include <png.h>
+#include <jpeglib.h>
+#include <SDL.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace {
+
+// DevIL hat einen globalen Zustand (das gebundene Bild), darf also nur von einem Thread aufs Mal verwendet werden
+SDL_mutex* getDevIlMutex()
+{
+    static SDL_mutex* mutex = SDL_CreateMutex();
+    return mutex;
+}
+
+// wird beim Laden des Programms aufgerufen, damit der Mutex nicht gleichzeitig von zwei Threads erstellt wird
+SDL_mutex* gInitDevIlMutex = getDevIlMutex();
+
+class DevIlLock
+{
+public:
+    DevIlLock() { SDL_mutexP(getDevIlMutex()); }
+    ~DevIlLock() { SDL_mutexV(getDevIlMutex()); }
+};
+
+// PNG und JPG werden direkt mit libpng und libjpeg dekodiert: diese haben keinen globalen Zustand,
+// so können mehrere Threads gleichzeitig dekodieren (mit DevIL wäre das Dekodieren im Mutex).
+
+class FileCloser
+{
+public:
+    explicit FileCloser(FILE* file) : m_file (file) {}
+    ~FileCloser() { if (m_file) fclose(m_file); }
+private:
+    FILE* m_file;
+};
+
+class PngError
+{
+public:
+    jmp_buf jump;
+    std::string msg;
+};
+
+void pngErrorFunction(png_structp png, png_const_charp msg)
+{
+    PngError* error = static_cast<PngError*>(png_get_error_ptr(png));
+    error->msg = msg;
+    longjmp(error->jump, 1);
+}
+
+void pngWarningFunction(png_structp, png_const_charp) {}
+
+// nur lokale Variablen ohne Destruktor nach setjmp, longjmp überspringt keine Destruktoren
+bool readPng(FILE* file, RgbaImage& image, std::vector<png_bytep>& rows, PngError& error)
+{
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, &error, &pngErrorFunction, &pngWarningFunction);
+    if (png == NULL)
+    {
+        error.msg = "could not create the PNG reader";
+        return false;
+    }
+    png_infop info = png_create_info_struct(png);
+    if (info == NULL || setjmp(error.jump))
+    {
+        png_destroy_read_struct(&png, info ? &info : NULL, NULL);
+        return false;
+    }
+    png_init_io(png, file);
+    png_read_info(png, info);
+
+    // alles nach 8 Bit RGBA umwandeln (wie ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE))
+    png_set_expand(png); // Palette, Graustufen < 8 Bit und tRNS
+    png_set_strip_16(png);
+    png_set_gray_to_rgb(png);
+    png_set_filler(png, 0xff, PNG_FILLER_AFTER);
+    png_set_interlace_handling(png);
+    png_read_update_info(png, info);
+
+    image = RgbaImage((int)png_get_image_width(png, info), (int)png_get_image_height(png, info));
+    if (png_get_rowbytes(png, info) != 4 * (png_size_t)image.width)
+        png_error(png, "unsupported PNG format");
+    rows.resize(image.height);
+    for (int y = 0; y < image.height; ++y)
+        rows[y] = &image.data[4 * y * image.width];
+    png_read_image(png, &rows[0]);
+    png_read_end(png, NULL);
+    png_destroy_read_struct(&png, &info, NULL);
+    return true;
+}
+
+class JpegError
+{
+public:
+    jpeg_error_mgr mgr; // muss zuerst kommen (libjpeg kennt nur den jpeg_error_mgr)
+    jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr cinfo)
+{
+    longjmp(reinterpret_cast<JpegError*>(cinfo->err)->jump, 1);
+}
+
+void jpegOutputMessage(j_common_ptr) {}
+
+// wie readPng(): nur lokale Variablen ohne Destruktor nach setjmp
+bool readJpeg(FILE* file, RgbaImage& image, std::vector<unsigned char>& row, std::string& errorMsg)
+{
+    jpeg_decompress_struct cinfo;
+    JpegError error;
+    cinfo.err = jpeg_std_error(&error.mgr);
+    error.mgr.error_exit = &jpegErrorExit;
+    error.mgr.output_message = &jpegOutputMessage;
+    if (setjmp(error.jump))
+    {
+        char buffer[JMSG_LENGTH_MAX];
+        error.mgr.format_message(reinterpret_cast<j_common_ptr>(&cinfo), buffer);
+        errorMsg = buffer;
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, file);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB; // auch für Graustufen (CMYK geht nicht, das macht dann DevIL)
+    jpeg_start_decompress(&cinfo);
+
+    image = RgbaImage((int)cinfo.output_width, (int)cinfo.output_height);
+    row.resize(3 * image.width);
+    while (cinfo.output_scanline < cinfo.output_height)
+    {
+        JSAMPROW rowPointer = &row[0];
+        int y = (int)cinfo.output_scanline;
+        jpeg_read_scanlines(&cinfo, &rowPointer, 1);
+        unsigned char* dst = &image.data[4 * y * image.width];
+        for (int x = 0; x < image.width; ++x)
+        {
+            dst[4 * x + 0] = row[3 * x + 0];
+            dst[4 * x + 1] = row[3 * x + 1];
+            dst[4 * x + 2] = row[3 * x + 2];
+            dst[4 * x + 3] = 0xff;
+        }
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+bool hasExtension(const std::string& fileName, const char* extension)
+{
+    size_t length = std::strlen(extension);
+    if (fileName.size() < length)
+        return false;
+    for (size_t i = 0; i < length; ++i)
+    {
+        char c = fileName[fileName.size() - length + i];
+        if (c >= 'A' && c <= 'Z')
+            c = c - 'A' + 'a';
+        if (c != extension[i])
+            return false;
+    }
+    return true;
+}
+
+// false, falls die Datei nicht PNG oder JPG ist oder libpng bzw. libjpeg sie nicht lesen kann
+bool loadImageWithoutDevIl(const std::string& fileName, RgbaImage& image, std::string& errorMsg)
+{
+    bool png = hasExtension(fileName, ".png");
+    if (!png && !hasExtension(fileName, ".jpg") && !hasExtension(fileName, ".jpeg"))
+        return false;
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (file == NULL)
+        return false;
+    FileCloser closer (file);
+    if (png)
+    {
+        PngError error;
+        std::vector<png_bytep> rows;
+        bool success = readPng(file, image, rows, error);
+        if (!success)
+            errorMsg = error.msg;
+        return success;
+    }
+    std::vector<unsigned char> row;
+    return readJpeg(file, image, row, errorMsg);
+}
+
+// Returns the smallest N such that 2^N >= x
+int nextPowerOfTwo(int x)
+{
+    int p = 1;
+    while (p < x) p <<= 1;
+    return p;
+}
+
+// bilinear interpolation (Pixelmitten wie bei OpenGL)
+RgbaImage resampleBilinear(const RgbaImage& image, int width, int height)
+{
+    RgbaImage result (width, height);
+    float scaleX = (float)image.width / width;
+    float scaleY = (float)image.height / height;
+    for (int y = 0; y < height; ++y)
+    {
+        float srcY = std::max(0.0f, (y + 0.5f) * scaleY - 0.5f);
+        int y0 = std::min((int)srcY, image.height - 1);
+        int y1 = std::min(y0 + 1, image.height - 1);
+        float fy = srcY - y0;
+        for (int x = 0; x < width; ++x)
+        {
+            float srcX = std::max(0.0f, (x + 0.5f) * scaleX - 0.5f);
+            int x0 = std::min((int)srcX, image.width - 1);
+            int x1 = std::min(x0 + 1, image.width - 1);
+            float fx = srcX - x0;
+            const unsigned char* p00 = &image.data[4 * (y0 * image.width + x0)];
+            const unsigned char* p01 = &image.data[4 * (y0 * image.width + x1)];
+            const unsigned char* p10 = &image.data[4 * (y1 * image.width + x0)];
+            const unsigned char* p11 = &image.data[4 * (y1 * image.width + x1)];
+            unsigned char* dst = &result.data[4 * (y * width + x)];
+            for (int c = 0; c < 4; ++c)
+            {
+                float top = p00[c] + (p01[c] - p00[c]) * fx;
+                float bottom = p10[c] + (p11[c] - p10[c]) * fx;
+                dst[c] = (unsigned char)(top + (bottom - top) * fy + 0.5f);
+            }
+        }
+    }
+    return result;
+}
+
+}
+
+RgbaImage halveImage(const RgbaImage& image)
+{
+    RgbaImage result (std::max(1, image.width / 2), std::max(1, image.height / 2));
+    for (int y = 0; y < result.height; ++y)
+    {
+        int y0 = std::min(2 * y, image.height - 1);
+        int y1 = std::min(2 * y + 1, image.height - 1);
+        for (int x = 0; x < result.width; ++x)
+        {
+            int x0 = std::min(2 * x, image.width - 1);
+            int x1 = std::min(2 * x + 1, image.width - 1);
+            const unsigned char* p00 = &image.data[4 * (y0 * image.width + x0)];
+            const unsigned char* p01 = &image.data[4 * (y0 * image.width + x1)];
+            const unsigned char* p10 = &image.data[4 * (y1 * image.width + x0)];
+            const unsigned char* p11 = &image.data[4 * (y1 * image.width + x1)];
+            unsigned char* dst = &result.data[4 * (y * result.width + x)];
+            for (int c = 0; c < 4; ++c)
+                dst[c] = (unsigned char)((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+        }
+    }
+    return result;
+}
+
+void buildMipmaps(std::vector<RgbaImage>& levels)
+{
+    while (levels.back().width > 1 || levels.back().height > 1)
+        levels.push_back(halveImage(levels.back()));
+}
+
+RgbaImage scaleImage(const RgbaImage& image, int width, int height)
+{
+    if (image.width == width && image.height == height)
+        return image;
+    // grosse Verkleinerungen mit dem Boxfilter, sonst gehen beim bilinearen Filtern Pixel verloren
+    RgbaImage halved;
+    const RgbaImage* current = &image;
+    while (current->width >= 2 * width && current->height >= 2 * height)
+    {
+        halved = halveImage(*current);
+        current = &halved;
+    }
+    if (current->width == width && current->height == height)
+        return *current;
+    return resampleBilinear(*current, width, height);
+}
+
+DecodedTexture::DecodedTexture(const std::string& fileName, const TextureId& id, const LoadTextureInfo& info)
+: fileName (fileName),
+  id (id),
+  info (info),
+  success (false),
+  errorMsg (),
+  originalWidth (0),
+  originalHeight (0),
+  levels (),
+  fromCache (false)
+{
+}
+
+bool loadImage(const std::string& fileName, RgbaImage& image, std::string& errorMsg)
+{
+    if (loadImageWithoutDevIl(fileName, image, errorMsg))
+        return true;
+
+    // andere Formate (und was libpng/libjpeg nicht lesen können) mit DevIL, im Mutex
+    DevIlLock lock;
+    ILuint devIlId;
+    ilGenImages(1, &devIlId);
+    ilBindImage(devIlId);
+    if ( !ilLoadImage( (ILstring)fileName.c_str() ) || !ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE) )
+    {
+        errorMsg = iluErrorString(ilGetError());
+        ilDeleteImages(1, &devIlId);
+        return false;
+    }
+    image = RgbaImage(ilGetInteger(IL_IMAGE_WIDTH), ilGetInteger(IL_IMAGE_HEIGHT));
+    std::memcpy(&image.data[0], ilGetData(), image.data.size());
+    ilDeleteImages(1, &devIlId);
+    return true;
+}
+
+void decodeTexture(DecodedTexture& texture, int maxSize, const TextureCache* cache)
+{
+    texture.levels.clear();
+    texture.fromCache = false;
+
+    // gebackene Texturen haben alle Mipmaps, zu grosse Stufen werden weggelassen
+    if (cache && cache->load(texture.fileName, TextureCache::KindTexture, texture.info.quality, texture.levels,
+                             &texture.originalWidth, &texture.originalHeight))
+    {
+        size_t first = 0;
+        while (first + 1 < texture.levels.size() && (texture.levels[first].width > maxSize || texture.levels[first].height > maxSize))
+            ++first;
+        texture.levels.erase(texture.levels.begin(), texture.levels.begin() + first);
+        if (texture.levels[0].width <= maxSize && texture.levels[0].height <= maxSize)
+        {
+            if (!texture.info.loadMipmaps)
+                texture.levels.resize(1);
+            texture.fromCache = true;
+            texture.success = true;
+            return;
+        }
+        texture.levels.clear();
+    }
+
+    RgbaImage image;
+    if (!loadImage(texture.fileName, image, texture.errorMsg))
+    {
+        texture.success = false;
+        return;
+    }
+    texture.originalWidth = image.width;
+    texture.originalHeight = image.height;
+
+    // Breite und Höhe müssen in der Form 2^n darstellbar sein, kleiner je nach Qualität
+    int shift = (int)texture.info.quality;
+    int width = std::max(1, nextPowerOfTwo(image.width) >> shift);
+    int height = std::max(1, nextPowerOfTwo(image.height) >> shift);
+    while (width > maxSize || height > maxSize)
+    {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+
+    texture.levels.resize(1);
+    texture.levels[0] = scaleImage(image, width, height);
+    if (texture.info.loadMipmaps)
+        buildMipmaps(texture.levels);
+    texture.success = true;
+}
+
+bool decodeAnimFrame(const std::string& fileName, TexQuality quality, RgbaImage& image, std::string& errorMsg,
+                     const TextureCache* cache, bool* fromCache)
+{
+    std::vector<RgbaImage> levels;
+    if (cache && cache->load(fileName, TextureCache::KindAnimFrame, quality, levels))
+    {
+        image.width = levels[0].width;
+        image.height = levels[0].height;
+        image.data.swap(levels[0].data);
+        if (fromCache)
+            *fromCache = true;
+        return true;
+    }
+    if (fromCache)
+        *fromCache = false;
+
+    RgbaImage original;
+    if (!loadImage(fileName, original, errorMsg))
+        return false;
+    int shift = (int)quality;
+    image = scaleImage(original, std::max(1, original.width >> shift), std::max(1, original.height >> shift));
+    return true;
+}
+
+TextureDecoder::TextureDecoder(std::vector<DecodedTexture>& textures, int maxSize, unsigned int numThreads, const TextureCache* cache)
+: m_textures (textures),
+  m_maxSize (maxSize),
+  m_cache (cache),
+  m_done (textures.size(), 0),
+  m_next (0),
+  m_cancel (false),
+  m_mutex (SDL_CreateMutex()),
+  m_doneCond (SDL_CreateCond()),
+  m_threads ()
+{
+    numThreads = std::min(numThreads, (unsigned int)textures.size());
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        SDL_Thread* thread = SDL_CreateThread(&TextureDecoder::threadFunction, this);
+        if (thread == NULL)
+            break; // waitFor() dekodiert selbst, falls es keine Threads gibt
+        m_threads.push_back(thread);
+    }
+}
+
+TextureDecoder::~TextureDecoder()
+{
+    SDL_mutexP(m_mutex);
+    m_cancel = true;
+    SDL_mutexV(m_mutex);
+    for (size_t i = 0; i < m_threads.size(); ++i)
+        SDL_WaitThread(m_threads[i], NULL);
+    SDL_DestroyCond(m_doneCond);
+    SDL_DestroyMutex(m_mutex);
+}
+
+int TextureDecoder::threadFunction(void* decoder)
+{
+    static_cast<TextureDecoder*>(decoder)->decodeLoop();
+    return 0;
+}
+
+void TextureDecoder::decodeLoop()
+{
+    for (;;)
+    {
+        SDL_mutexP(m_mutex);
+        if (m_cancel || m_next >= m_textures.size())
+        {
+            SDL_mutexV(m_mutex);
+            return;
+        }
+        size_t i = m_next++;
+        SDL_mutexV(m_mutex);
+
+        try
+        {
+            decodeTexture(m_textures[i], m_maxSize, m_cache);
+        }
+        catch (std::exception& e)
+        {
+            m_textures[i].success = false;
+            m_textures[i].errorMsg = e.what();
+        }
+
+        SDL_mutexP(m_mutex);
+        m_done[i] = 1;
+        SDL_CondBroadcast(m_doneCond);
+        SDL_mutexV(m_mutex);
+    }
+}
+
+DecodedTexture& TextureDecoder::waitFor(size_t i)
+{
+    if (m_threads.empty())
+    {
+        if (!m_done[i])
+        {
+            decodeTexture(m_textures[i], m_maxSize, m_cache);
+            m_done[i] = 1;
+        }
+        return m_textures[i];
+    }
+    SDL_mutexP(m_mutex);
+    while (!m_done[i])
+        SDL_CondWait(m_doneCond, m_mutex);
+    SDL_mutexV(m_mutex);
+    return m_textures[i];
+}
+
+unsigned int TextureDecoder::getDefaultNumThreads()
+{
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    long numCpus = (long)systemInfo.dwNumberOfProcessors;
+#else
+    long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return (unsigned int)std::max(1L, std::min(numCpus, 16L));
+}
@@ -0,0 +1,109 @@
+/*
+ * TextureDecoder.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Bilder für Texturen vorbereiten (laden, skalieren, Mipmaps erzeugen), ohne OpenGL.
+// TextureDecoder macht das mit mehreren Threads, das Hochladen bleibt im OpenGL-Thread.
+
+#ifndef TEXTUREDECODER_H
+#define TEXTUREDECODER_H
+
+#include "Texture.h"
+
+#include <string>
+#include <vector>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+class TextureCache;
+
+// Ein Bild im RGBA Format (4 Bytes pro Pixel, erste Zeile zuerst)
+class RgbaImage
+{
+public:
+    RgbaImage(int w = 0, int h = 0) : width (w), height (h), data (4 * w * h) {}
+    int width;
+    int height;
+    std::vector<unsigned char> data;
+};
+
+// Lädt eine Bilddatei, PNG und JPG mit libpng bzw. libjpeg (gleichzeitig in mehreren Threads),
+// andere Formate mit DevIL (durch einen Mutex geschützt, kann auch von mehreren Threads aufgerufen werden)
+bool loadImage(const std::string& fileName, RgbaImage& image, std::string& errorMsg);
+// Skaliert auf width x height (zuerst halbieren mit Boxfilter, dann bilinear)
+RgbaImage scaleImage(const RgbaImage& image, int width, int height);
+// Halbiert Breite und Höhe (mindestens 1) mit einem 2x2 Boxfilter, wie gluBuild2DMipmaps
+RgbaImage halveImage(const RgbaImage& image);
+// Hängt an levels (mit dem ganzen Bild als levels[0]) die Mipmaps bis 1x1 an
+void buildMipmaps(std::vector<RgbaImage>& levels);
+
+// Eine Textur, die geladen werden soll, und das Resultat
+class DecodedTexture
+{
+public:
+    DecodedTexture(const std::string& fileName, const TextureId& id, const LoadTextureInfo& info);
+
+    std::string fileName;
+    TextureId id;
+    LoadTextureInfo info;
+
+    // Resultat von decodeTexture()
+    bool success;
+    std::string errorMsg;
+    int originalWidth;
+    int originalHeight;
+    std::vector<RgbaImage> levels; // Mipmaps, levels[0] ist das ganze Bild
+    bool fromCache; // aus dem TextureCache statt aus der Bilddatei
+};
+
+// Lädt das Bild mit loadImage(), skaliert es (Zweierpotenz und Qualität) und erzeugt die Mipmaps.
+// Kann von mehreren Threads gleichzeitig aufgerufen werden (nur DevIL selbst ist durch einen Mutex geschützt).
+// maxSize: maximale Breite und Höhe (GL_MAX_TEXTURE_SIZE)
+// cache: falls die Textur dort gültig ist, wird sie von dort genommen
+void decodeTexture(DecodedTexture& texture, int maxSize, const TextureCache* cache = NULL);
+
+// Lädt ein Bild einer Animation (für den Atlas): nur je nach Qualität verkleinert, ohne Zweierpotenz und Mipmaps
+bool decodeAnimFrame(const std::string& fileName, TexQuality quality, RgbaImage& image, std::string& errorMsg,
+                     const TextureCache* cache = NULL, bool* fromCache = NULL);
+
+/*
+    Dekodiert Texturen mit einem Pool von Threads. Die Threads nehmen die Texturen der Reihe nach,
+    mit waitFor() kann der OpenGL-Thread sie in der gleichen Reihenfolge hochladen, während die
+    folgenden Texturen noch dekodiert werden.
+*/
+class TextureDecoder
+{
+public:
+    // textures muss bis zum Ende des TextureDecoder bestehen bleiben
+    TextureDecoder(std::vector<DecodedTexture>& textures, int maxSize, unsigned int numThreads = getDefaultNumThreads(),
+                   const TextureCache* cache = NULL);
+    ~TextureDecoder(); // bricht ab und wartet auf die Threads
+
+    // wartet bis die Textur i dekodiert ist
+    DecodedTexture& waitFor(size_t i);
+
+    // Anzahl Prozessoren
+    static unsigned int getDefaultNumThreads();
+
+private:
+    TextureDecoder(const TextureDecoder&);
+    TextureDecoder& operator = (const TextureDecoder&);
+
+    static int threadFunction(void* decoder);
+    void decodeLoop();
+
+    std::vector<DecodedTexture>& m_textures;
+    int m_maxSize;
+    const TextureCache* m_cache;
+    std::vector<char> m_done;
+    size_t m_next;
+    bool m_cancel;
+    SDL_mutex* m_mutex;
+    SDL_cond* m_doneCond;
+    std::vector<SDL_Thread*> m_threads;
+};
+
+#endif
@@ -7,7 +7,6 @@
 #include "Vector2D.h"
 
 #include <Box2D/Box2D.h>
-#include <boost/make_shared.hpp>
 
 const float cPi = 3.141592653589793238462643383279502884f;
 
@@ -23,9 +22,9 @@ float radToDeg( float angleRad )
 
 Vector2D::Vector2D ( const b2Vec2& v ) : x ( v.x ), y ( v.y ) {}
 
-boost::shared_ptr<b2Vec2> Vector2D::to_b2Vec2() const
+b2Vec2 Vector2D::to_b2Vec2() const
 {
-    return boost::shared_ptr<b2Vec2>(boost::make_shared<b2Vec2>(x,y));
+    return b2Vec2(x,y);
 }
 
 // Macht den Vektor zu einem Einheitsvektor
@@ -10,7 +10,6 @@
 #define VECTOR2D_H
 
 #include <cmath>
-#include <boost/shared_ptr.hpp>
 
 extern const float cPi;
 
@@ -38,8 +37,8 @@ public:
     // The vector coordinates
     float x, y;
 
-    // Convert to a Box2D vector
-    boost::shared_ptr<b2Vec2> to_b2Vec2() const;
+    // Convert to a Box2D vector (by value, no heap allocation)
+    b2Vec2 to_b2Vec2() const;
 
     // Set new values for x and y
     inline void set( float new_x, float new_y )
@@ -0,0 +1,159 @@
+/*
+ * WorldIndex.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "WorldIndex.h"
+
+#include "common/components/CompPosition.h"
+#include "common/components/CompShape.h"
+
+#include "common/GameEvents.h"
+#include "common/Foreach.h"
+
+#include <algorithm>
+#include <boost/bind.hpp>
+
+WorldIndex::WorldIndex(GameEvents& gameEvents, float cellSize)
+: m_hash (cellSize), m_records (), m_shapesByPosition (), m_eventConnection1 (), m_eventConnection2 (), m_eventConnection3 ()
+{
+    m_eventConnection1 = gameEvents.newComponent.registerListener( boost::bind( &WorldIndex::onRegisterComp, this, _1 ) );
+    m_eventConnection2 = gameEvents.deleteComponent.registerListener( boost::bind( &WorldIndex::onUnregisterComp, this, _1 ) );
+    m_eventConnection3 = gameEvents.componentChanged.registerListener( boost::bind( &WorldIndex::onChangeComp, this, _1 ) );
+}
+
+void WorldIndex::onRegisterComp(Component& component)
+{
+    if (component.getTypeId() != CompShape::getTypeIdStatic())
+        return;
+    CompShape* shape = static_cast<CompShape*>(&component);
+    ShapeRecord& record = m_records[shape];
+    record.position = NULL;
+    setPosition(shape, record, shape->getSiblingComponent<CompPosition>());
+    record.localBox = shape->getBoundingBox();
+    updateShape(shape, record, true);
+}
+
+void WorldIndex::onUnregisterComp(Component& component)
+{
+    if (component.getTypeId() == CompPosition::getTypeIdStatic())
+    {
+        // die Formen bleiben (bis sie selbst entfernt werden) an der letzten Position
+        ShapesByPosition::iterator it = m_shapesByPosition.find(static_cast<CompPosition*>(&component));
+        if (it == m_shapesByPosition.end())
+            return;
+        foreach (CompShape* shape, it->second)
+            m_records[shape].position = NULL;
+        m_shapesByPosition.erase(it);
+        return;
+    }
+    if (component.getTypeId() != CompShape::getTypeIdStatic())
+        return;
+    CompShape* shape = static_cast<CompShape*>(&component);
+    RecordMap::iterator it = m_records.find(shape);
+    if (it == m_records.end())
+        return;
+    setPosition(shape, it->second, NULL);
+    m_hash.remove(shape);
+    m_records.erase(it);
+}
+
+void WorldIndex::setPosition(CompShape* shape, ShapeRecord& record, const CompPosition* position)
+{
+    if (record.position == position)
+        return;
+    if (record.position)
+    {
+        std::vector<CompShape*>& shapes = m_shapesByPosition[record.position];
+        shapes.erase(std::find(shapes.begin(), shapes.end(), shape));
+        if (shapes.empty())
+            m_shapesByPosition.erase(record.position);
+    }
+    record.position = position;
+    if (position)
+        m_shapesByPosition[position].push_back(shape);
+}
+
+void WorldIndex::onChangeComp(Component& component)
+{
+    // eine Form oder die Position der Einheit wurde geändert (z.B. im Editor, wo update() nicht aufgerufen wird)
+    foreach (CompShape* shape, component.getSiblingComponents<CompShape>())
+    {
+        RecordMap::iterator it = m_records.find(shape);
+        if (it == m_records.end())
+            continue;
+        setPosition(shape, it->second, shape->getSiblingComponent<CompPosition>());
+        it->second.localBox = shape->getBoundingBox();
+        updateShape(shape, it->second, true);
+    }
+}
+
+void WorldIndex::updatePosition(const CompPosition& position)
+{
+    ShapesByPosition::iterator it = m_shapesByPosition.find(&position);
+    if (it == m_shapesByPosition.end())
+        return;
+    foreach (CompShape* shape, it->second)
+        updateShape(shape, m_records[shape], false);
+}
+
+void WorldIndex::updateShape(CompShape* shape, ShapeRecord& record, bool force)
+{
+    Vector2D position;
+    float orientation = 0.0f;
+    if (record.position)
+    {
+        position = record.position->getPosition();
+        orientation = record.position->getOrientation();
+    }
+    // hat sich nichts geändert, muss nichts gemacht werden
+    if (!force && position == record.lastPosition && orientation == record.lastOrientation)
+        return;
+    record.lastPosition = position;
+    record.lastOrientation = orientation;
+    m_hash.update(shape, record.localBox.transformed(position, orientation));
+}
+
+void WorldIndex::queryPoint(const Vector2D& point, std::vector<CompShape*>& shapes) const
+{
+    size_t first = shapes.size();
+    m_hash.queryPoint(point, shapes);
+
+    // nur die Formen behalten, die den Punkt wirklich enthalten
+    size_t numHits = first;
+    for (size_t i = first; i < shapes.size(); ++i)
+    {
+        const ShapeRecord& record = m_records.find(shapes[i])->second;
+        Vector2D localPoint = (point - record.lastPosition).rotated(-record.lastOrientation);
+        if (shapes[i]->containsPoint(localPoint))
+            shapes[numHits++] = shapes[i];
+    }
+    shapes.resize(numHits);
+}
+
+void WorldIndex::queryAabb(const Aabb& box, std::vector<CompShape*>& shapes) const
+{
+    m_hash.queryAabb(box, shapes);
+}
+
+void WorldIndex::queryRadius(const Vector2D& center, float radius, std::vector<CompShape*>& shapes) const
+{
+    m_hash.queryRadius(center, radius, shapes);
+}
+
+std::set<EntityId> WorldIndex::getEntities(const std::vector<CompShape*>& shapes)
+{
+    std::set<EntityId> entities;
+    foreach (const CompShape* shape, shapes)
+        entities.insert(shape->getEntityId());
+    return entities;
+}
+
+Aabb WorldIndex::getBoundingBox(const CompShape& shape) const
+{
+    RecordMap::const_iterator it = m_records.find(const_cast<CompShape*>(&shape));
+    if (it == m_records.end())
+        return Aabb();
+    return it->second.localBox.transformed(it->second.lastPosition, it->second.lastOrientation);
+}
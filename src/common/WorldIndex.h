@@ -0,0 +1,82 @@
+/*
+ * WorldIndex.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Räumlicher Index aller Formen (CompShape) der Welt, z.B. für "welche Einheiten sind in diesem Bereich?"
+// (Auswahl im Editor, Trigger für Bereiche, ...)
+
+#ifndef WORLDINDEX_H
+#define WORLDINDEX_H
+
+#include "common/Aabb.h"
+#include "common/Event.h"
+#include "common/IdTypes.h"
+#include "common/SpatialHash.h"
+#include "common/Vector2D.h"
+
+#include <set>
+#include <vector>
+#include <boost/unordered_map.hpp>
+
+class Component;
+class CompPosition;
+class CompShape;
+class GameEvents;
+
+// Zellengrösse in Welteinheiten (etwa die Grösse einer Kiste oder des Spielers)
+const float cWorldIndexCellSize = 4.0f;
+
+class WorldIndex
+{
+public:
+    WorldIndex(GameEvents& gameEvents, float cellSize = cWorldIndexCellSize);
+
+    // Die Formen dieser Position im Index verschieben (PhysicsSystem ruft das für die Körper auf, die sich bewegt haben,
+    // ruhende und statische Formen kosten also nichts).
+    // Formen kommen automatisch in den Index, wenn ihre Einheit erstellt wird,
+    // und werden neu eingetragen, wenn eine Komponente ihrer Einheit geändert wird (componentChanged).
+    void updatePosition(const CompPosition& position);
+
+    // Formen, die den Punkt enthalten (genauer Test mit der Form)
+    void queryPoint(const Vector2D& point, std::vector<CompShape*>& shapes) const;
+    // Formen, deren Bounding Box den Bereich bzw. den Kreis schneidet
+    void queryAabb(const Aabb& box, std::vector<CompShape*>& shapes) const;
+    void queryRadius(const Vector2D& center, float radius, std::vector<CompShape*>& shapes) const;
+
+    // die Einheiten der Formen (jede nur einmal)
+    static std::set<EntityId> getEntities(const std::vector<CompShape*>& shapes);
+
+    // Bounding Box einer Form in Weltkoordinaten (leer, falls sie nicht im Index ist)
+    Aabb getBoundingBox(const CompShape& shape) const;
+    size_t getNumShapes() const { return m_records.size(); }
+
+private:
+    class ShapeRecord
+    {
+    public:
+        const CompPosition* position; // NULL: die Form bleibt beim Ursprung
+        Aabb localBox;
+        Vector2D lastPosition;        // Position und Winkel beim letzten update()
+        float lastOrientation;
+    };
+    typedef boost::unordered_map<CompShape*, ShapeRecord> RecordMap;
+    typedef boost::unordered_map<const CompPosition*, std::vector<CompShape*> > ShapesByPosition;
+
+    SpatialHash<CompShape*> m_hash;
+    RecordMap m_records;
+    ShapesByPosition m_shapesByPosition; // für updatePosition()
+
+    EventConnection m_eventConnection1;
+    EventConnection m_eventConnection2;
+    EventConnection m_eventConnection3;
+
+    void onRegisterComp(Component&);
+    void onUnregisterComp(Component&);
+    void onChangeComp(Component&);
+    void setPosition(CompShape* shape, ShapeRecord& record, const CompPosition* position);
+    void updateShape(CompShape* shape, ShapeRecord& record, bool force);
+};
+
+#endif
@@ -32,7 +32,7 @@ const PathPoint& CompPath::getPathPoint(size_t i) const
 {
     if (i >= m_points.size())
     {
-        log(Error) << "CompPath::getPathPoint(i): index out of bounds\n";
+        AA_LOG(Error) << "CompPath::getPathPoint(i): index out of bounds\n";
         return nullPathPoint;
     }
     return m_points[i];
@@ -5,6 +5,9 @@
  */
 
 #include "CompPathMove.h"
+#include "CompPath.h"
+#include "CompPosition.h"
+#include "CompPhysics.h"
 
 #include "common/Foreach.h"
 #include "common/DataLoader.h"
@@ -45,15 +48,21 @@ CompPathMove::CompPathMove(const ComponentId& id, GameEvents& gameEvents)
   m_numUpdatesToNextPoint (0),
   m_numUpdatesToAccelerate (0),
   m_detalLinearVelocity (),
-  m_detalAngularVelocity (0.0f)
+  m_detalAngularVelocity (0.0f),
+  m_compPath (NULL),
+  m_compPosition (NULL),
+  m_compPhysics (NULL)
 {
+    declareSibling(m_compPath, &m_pathId);
+    declareSibling(m_compPosition);
+    declareSibling(m_compPhysics);
 }
 
 const PathMovePoint& CompPathMove::getPathPoint(size_t i) const
 {
     if (i >= m_points.size())
     {
-        log(Error) << "CompPathMove::getPathPoint(i): index out of bounds\n";
+        AA_LOG(Error) << "CompPathMove::getPathPoint(i): index out of bounds\n";
         return nullPathPoint;
     }
     return m_points[i];
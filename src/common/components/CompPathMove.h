@@ -12,6 +12,10 @@
 
 #include <vector>
 
+class CompPath;
+class CompPosition;
+class CompPhysics;
+
 class PathMovePoint
 {
 public:
@@ -74,6 +78,11 @@ private:
 
     std::vector<PathMovePoint> m_points;
 
+    // declared siblings
+    CompPath* m_compPath;
+    CompPosition* m_compPosition;
+    CompPhysics* m_compPhysics;
+
     friend class PhysicsSystem;
 };
 
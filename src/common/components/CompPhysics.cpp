@@ -5,6 +5,8 @@
  */
 
 #include "CompPhysics.h"
+#include "CompPosition.h"
+#include "CompGravField.h"
 
 #include "common/Foreach.h"
 #include "common/Logger.h"
@@ -34,8 +36,18 @@ CompPhysics::CompPhysics(const ComponentId& id, GameEvents& gameEvents, const Bo
     m_smoothAngle (0.0f),
     m_previousAngle (0.0f),
     m_gravField (NULL),
-    m_nUpdatesSinceGravFieldChange (UINT_MAX)
-{}
+    m_nUpdatesSinceGravFieldChange (UINT_MAX),
+    m_gravFieldContacts (),
+    m_gravFieldContactsChanged (true),
+    m_gravFieldContactsMove (false),
+    m_foundGravField (NULL),
+    m_foundGravFieldPoint (),
+    m_compPosition (NULL),
+    m_ownGravField (NULL)
+{
+    declareSibling(m_compPosition);
+    declareSibling(m_ownGravField);
+}
 
 void CompPhysics::addShapeDef( boost::shared_ptr<ShapeDef> pShapeDef )
 {
@@ -46,7 +58,7 @@ bool CompPhysics::setShapeFriction(const ComponentId& shapeName, float friction)
 {
     if (m_body==NULL)
     {
-        log(Warning) << "setShapeFriction: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "setShapeFriction: component was not yet initialized by physics system\n";
         return false;
     }
 
@@ -58,7 +70,7 @@ bool CompPhysics::setShapeFriction(const ComponentId& shapeName, float friction)
     }
     else
     {
-        log(Warning) << "setShapeFriction: fixture for shape '" << shapeName << "' does not exist\n";
+        AA_LOG(Warning) << "setShapeFriction: fixture for shape '" << shapeName << "' does not exist\n";
         return false;
     }
 
@@ -78,7 +90,7 @@ float CompPhysics::getMass() const
 {
     if (m_body==NULL)
     {
-        log(Warning) << "getMass: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "getMass: component was not yet initialized by physics system\n";
         return -1.0f;
     }
     return m_body->GetMass();
@@ -88,7 +100,7 @@ float CompPhysics::getAngle() const
 {
     if (m_body==NULL)
     {
-        log(Warning) << "getAngle: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "getAngle: component was not yet initialized by physics system\n";
         return 0.0f;
     }
     return m_body->GetAngle();
@@ -122,11 +134,18 @@ bool CompPhysics::isBullet() const
     return m_bodyDef.bullet;
 }
 
+bool CompPhysics::isStatic() const
+{
+    if (m_body)
+        return m_body->GetType() == b2_staticBody;
+    return false;
+}
+
 Vector2D CompPhysics::getLinearVelocity() const
 {
     if (m_body==NULL)
     {
-        log(Warning) << "getLinearVelocity: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "getLinearVelocity: component was not yet initialized by physics system\n";
         return Vector2D();
     }
     return Vector2D( m_body->GetLinearVelocity() );
@@ -136,37 +155,38 @@ void CompPhysics::setLinearVelocity(const Vector2D& vel)
 {
     if (m_body==NULL)
     {
-        log(Warning) << "setLinearVelocity: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "setLinearVelocity: component was not yet initialized by physics system\n";
         return;
     }
-    m_body->SetLinearVelocity( *vel.to_b2Vec2() );
+    m_body->SetLinearVelocity( vel.to_b2Vec2() );
 }
 
 void CompPhysics::applyLinearImpulse(const Vector2D& impulse, const Vector2D& point)
 {
     if (m_body==NULL)
     {
-        log(Warning) << "applyLinearImpulse: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "applyLinearImpulse: component was not yet initialized by physics system\n";
         return;
     }
-    m_body->ApplyLinearImpulse(*impulse.to_b2Vec2(), *point.to_b2Vec2(), true);
+    m_body->ApplyLinearImpulse(impulse.to_b2Vec2(), point.to_b2Vec2(), true);
 }
 
 void CompPhysics::applyForce(const Vector2D& impulse, const Vector2D& point)
 {
     if (m_body==NULL)
     {
-        log(Warning) << "applyForce: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "applyForce: component was not yet initialized by physics system\n";
         return;
     }
-    m_body->ApplyForce(*impulse.to_b2Vec2(), *point.to_b2Vec2(), false);
+    // the gravitation doesn't wake up bodies anymore, so a force has to
+    m_body->ApplyForce(impulse.to_b2Vec2(), point.to_b2Vec2(), true);
 }
 
 void CompPhysics::rotate( float deltaAngle, const Vector2D& localPoint )
 {
     if (m_body==NULL)
     {
-        log(Warning) << "rotate: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "rotate: component was not yet initialized by physics system\n";
         return;
     }
 
@@ -176,7 +196,7 @@ void CompPhysics::rotate( float deltaAngle, const Vector2D& localPoint )
     Vector2D worldRotationCenterToBodyCenter ( -localPoint.rotated(newAngle) );
     Vector2D newPos = worldRotationCenter + worldRotationCenterToBodyCenter;
 
-    m_body->SetTransform( *newPos.to_b2Vec2(), newAngle );
+    m_body->SetTransform( newPos.to_b2Vec2(), newAngle );
 }
 
 
@@ -184,7 +204,7 @@ Vector2D CompPhysics::getPosition() const
 {
     if (m_body==NULL)
     {
-        log(Warning) << "getPosition: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "getPosition: component was not yet initialized by physics system\n";
         return Vector2D();
     }
     return m_body->GetPosition();
@@ -194,7 +214,7 @@ Vector2D CompPhysics::getSmoothPosition() const
 {
     if (m_body==NULL)
     {
-        log(Warning) << "getSmoothPosition: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "getSmoothPosition: component was not yet initialized by physics system\n";
         return Vector2D();
     }
     return m_smoothCenterOfMass - Vector2D(m_body->GetLocalCenter()).rotated(m_smoothAngle);
@@ -204,7 +224,7 @@ ContactVector CompPhysics::getContacts(bool getSensors) const
 {
     if (m_body==NULL)
     {
-        log(Warning) << "getContacts: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "getContacts: component was not yet initialized by physics system\n";
         return ContactVector();
     }
 
@@ -256,7 +276,7 @@ Vector2D CompPhysics::getCenterOfMass() const
 {
     if (m_body==NULL)
     {
-        log(Warning) << "getCenterOfMass: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "getCenterOfMass: component was not yet initialized by physics system\n";
         return Vector2D();
     }
     return Vector2D( m_body->GetWorldCenter() );
@@ -352,8 +372,8 @@ Vector2D CompPhysics::globalToLocal(const Vector2D& global) const
 {
     if (m_body==NULL)
     {
-        log(Warning) << "globalToLocal: component was not yet initialized by physics system\n";
+        AA_LOG(Warning) << "globalToLocal: component was not yet initialized by physics system\n";
         return Vector2D();
     }
-    return m_body->GetWorldVector(*global.to_b2Vec2());
+    return m_body->GetWorldVector(global.to_b2Vec2());
 }
@@ -24,6 +24,7 @@ class b2Body;
 class b2Fixture;
 
 class CompGravField;
+class CompPosition;
 class CompPhysics;
 class CompShape;
 
@@ -146,6 +147,7 @@ public:
     float getAngularDamping() const;
     bool isFixedRotation() const;
     bool isBullet() const;
+    bool isStatic() const; // static bodies never move (only valid after registration in the physics system)
 
     void rotate( float deltaAngle, const Vector2D& localPoint ); // Rotate the body by daltaAngle counterclockwise around a local point
 
@@ -179,6 +181,19 @@ private:
 
     const CompGravField* m_gravField;
     unsigned int m_nUpdatesSinceGravFieldChange;
+    // bodies with a gravitation field that touch this body, rebuilt from the contact list
+    // only when a contact with a gravitation field began or ended (see PhysicsSystem::update)
+    std::vector<const CompPhysics*> m_gravFieldContacts;
+    bool m_gravFieldContactsChanged;
+    bool m_gravFieldContactsMove; // one of the fields is not static, its fixtures can move under the gravitation point
+    // Result of the last search and the gravitation point it was found for. Touching a field is not enough
+    // (the point can be outside its fixtures), so the point is tested again whenever it has moved.
+    const CompGravField* m_foundGravField;
+    Vector2D m_foundGravFieldPoint;
+
+    // declared siblings
+    CompPosition* m_compPosition;
+    CompGravField* m_ownGravField; // gravitation field of this entity (not the one acting on it)
 
     friend class PhysicsSystem; // Das Physik-System darf auf alles hier zugreifen!
 };
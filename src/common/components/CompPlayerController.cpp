@@ -8,6 +8,8 @@
 
 #include "CompVisualAnimation.h"
 #include "CompPhysics.h"
+#include "CompPosition.h"
+#include "CompVariable.h"
 
 #include "common/Foreach.h"
 #include "common/Logger.h"
@@ -25,6 +27,14 @@ const ComponentTypeId& CompPlayerController::getTypeIdStatic()
     return *typeId;
 }
 
+namespace
+{
+// IDs of the sibling components used by the player controller
+const ComponentId cBodyAnimId = "bodyAnim";
+const ComponentId cJetpackAnimId = "jetpack";
+const ComponentId cJetpackEnergyId = "JetpackEnergy";
+}
+
 // Konstruktor der Komponente
 CompPlayerController::CompPlayerController(const ComponentId& id, GameEvents& gameEvents) :
      Component(id, gameEvents),
@@ -32,9 +42,18 @@ CompPlayerController::CompPlayerController(const ComponentId& id, GameEvents& ga
      m_spaceKeyDownLastUpdate ( false ),
      m_playerCouldWalkLastUpdate ( false ),
      m_rechargeTime ( cMaxRecharge ),
-     m_walkingTime ( 0 )
+     m_walkingTime ( 0 ),
+     m_compPhysics ( NULL ),
+     m_compPosition ( NULL ),
+     m_jetpackEnergy ( NULL ),
+     m_bodyAnim ( NULL ),
+     m_jetpackAnim ( NULL )
 {
-    // Update-Methode registrieren, damit sie in jede Aktualisierung (GameUpdate) aufgerufen wird:
+    declareSibling(m_compPhysics);
+    declareSibling(m_compPosition);
+    declareSibling(m_jetpackEnergy, &cJetpackEnergyId);
+    declareSibling(m_bodyAnim, &cBodyAnimId);
+    declareSibling(m_jetpackAnim, &cJetpackAnimId);
 }
 
 void CompPlayerController::setLowFriction( CompPhysics* playerCompPhysics )
@@ -71,19 +90,11 @@ void CompPlayerController::writeToPropertyTree(ptree& propTree) const
 void CompPlayerController::updateAnims(bool flyingUp, bool movingOnGround, bool usingJetpack)
 {
     // Laufanimation steuern
-    CompVisualAnimation* bodyAnim = NULL;
-    CompVisualAnimation* jetpackAnim = NULL;
-    std::vector<CompVisualAnimation*> player_anims = getSiblingComponents<CompVisualAnimation>();
-    for ( size_t i = 0; i < player_anims.size(); ++i )
-    {
-        if ( player_anims[i]->getId() == "bodyAnim" )
-            bodyAnim = player_anims[i];
-        else if ( player_anims[i]->getId() == "jetpack" )
-            jetpackAnim = player_anims[i];
-    }
+    CompVisualAnimation* bodyAnim = m_bodyAnim;
+    CompVisualAnimation* jetpackAnim = m_jetpackAnim;
 
     if (bodyAnim == NULL)
-        log(Warning) << "entity '" << getEntityId() << "' has component CompPlayerController but no 'bodyAnim' shape\n";
+        AA_LOG(Warning) << "entity '" << getEntityId() << "' has component CompPlayerController but no 'bodyAnim' shape\n";
     else
     {
         if (flyingUp)
@@ -116,7 +127,7 @@ void CompPlayerController::updateAnims(bool flyingUp, bool movingOnGround, bool
     }
     
     if (jetpackAnim == NULL)
-        log(Warning) << "entity '" << getEntityId() << "' has component CompPlayerController but no 'jetpack' shape\n";
+        AA_LOG(Warning) << "entity '" << getEntityId() << "' has component CompPlayerController but no 'jetpack' shape\n";
     else // Raketenrucksack animation
     {
         if ( usingJetpack ) // Spieler benutzt gerade den Jetpack
@@ -17,6 +17,9 @@
 
 class GameEvents;
 class CompPhysics;
+class CompPosition;
+class CompVariable;
+class CompVisualAnimation;
 
 // Constants
 const int cMaxRecharge = 15;                    // wie wie muss der Spieler warten bis der Racketenrucksack startet?
@@ -48,6 +51,13 @@ private:
     int m_walkingTime;                // number of updates the player is walking (pressing walk key on ground)
     int m_nonWalkingTime;             // number of updates since the player stopped to walk
     Vector2D m_rotationPoint;
+
+    // declared siblings
+    CompPhysics* m_compPhysics;
+    CompPosition* m_compPosition;
+    CompVariable* m_jetpackEnergy;
+    CompVisualAnimation* m_bodyAnim;
+    CompVisualAnimation* m_jetpackAnim;
 };
 
 #endif
@@ -12,7 +12,6 @@
 
 #include <Box2D/Box2D.h> // need this for converting to Box2D shapes
 #include <boost/scoped_ptr.hpp>
-#include <boost/make_shared.hpp>
 #include <boost/property_tree/ptree.hpp>
 
 using boost::property_tree::ptree;
@@ -34,6 +33,7 @@ CompShapePolygon::CompShapePolygon(const ComponentId& id, GameEvents& gameEvents
 
 void CompShapePolygon::loadFromPropertyTree(const ptree& propTree)
 {
+    m_vertices.clear(); // the editor loads a changed tree again
     foreach(const ptree::value_type &v, propTree.get_child("polygon"))
     {
         const ptree& vertex = v.second;
@@ -54,16 +54,14 @@ void CompShapePolygon::writeToPropertyTree(ptree& propTree) const
     }
 }
 
-boost::shared_ptr<b2Shape> CompShapePolygon::toB2Shape() const
+void CompShapePolygon::toB2Shape(b2PolygonShape& shape) const
 {
-    boost::shared_ptr<b2PolygonShape> poly_shape = boost::make_shared<b2PolygonShape>();
     b2Vec2 vertices[b2_maxPolygonVertices];
     for (size_t i=0; i<m_vertices.size() && i<b2_maxPolygonVertices; i++)
     {
         vertices[i].Set(m_vertices[i].x, m_vertices[i].y);
     }
-    poly_shape->Set(vertices, m_vertices.size());
-    return poly_shape;
+    shape.Set(vertices, m_vertices.size());
 }
 
 void CompShapePolygon::setVertex(size_t i, const Vector2D& v)
@@ -86,6 +84,35 @@ const Vector2D* CompShapePolygon::getVertex(size_t i) const
     return &m_vertices[i];
 }
 
+Aabb CompShapePolygon::getBoundingBox() const
+{
+    Aabb box;
+    foreach (const Vector2D& vertex, m_vertices)
+        box.extend(vertex);
+    return box;
+}
+
+bool CompShapePolygon::containsPoint(const Vector2D& localPoint) const
+{
+    if (m_vertices.size() < 3)
+        return false;
+    // inside if the point is on the same side of every edge (works for both vertex orders)
+    bool hasPositive = false, hasNegative = false;
+    for (size_t i = 0; i < m_vertices.size(); ++i)
+    {
+        const Vector2D& a = m_vertices[i];
+        const Vector2D& b = m_vertices[(i + 1) % m_vertices.size()];
+        float side = (b - a).perpDotProd(localPoint - a);
+        if (side > 0.0f)
+            hasPositive = true;
+        else if (side < 0.0f)
+            hasNegative = true;
+        if (hasPositive && hasNegative)
+            return false;
+    }
+    return true;
+}
+
 CompShapeCircle::CompShapeCircle(const ComponentId& id, GameEvents& gameEvents, const Vector2D& center, float radius) :
         CompShape(id, gameEvents),
         m_center (center),
@@ -106,10 +133,18 @@ void CompShapeCircle::writeToPropertyTree(ptree& propTree) const
     propTree.add("circle.r", m_radius);
 }
 
-boost::shared_ptr<b2Shape> CompShapeCircle::toB2Shape() const
+void CompShapeCircle::toB2Shape(b2CircleShape& shape) const
+{
+    shape.m_radius = m_radius;
+    shape.m_p = m_center.to_b2Vec2();
+}
+
+Aabb CompShapeCircle::getBoundingBox() const
+{
+    return Aabb(m_center - Vector2D(m_radius, m_radius), m_center + Vector2D(m_radius, m_radius));
+}
+
+bool CompShapeCircle::containsPoint(const Vector2D& localPoint) const
 {
-    boost::shared_ptr<b2CircleShape> circle_shape = boost::make_shared<b2CircleShape>();
-    circle_shape->m_radius = m_radius;
-    circle_shape->m_p = *m_center.to_b2Vec2();
-    return circle_shape;
+    return (localPoint - m_center).lengthSquared() <= m_radius * m_radius;
 }
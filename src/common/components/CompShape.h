@@ -8,13 +8,14 @@
 #ifndef COMPSHAPE_H
 #define COMPSHAPE_H
 
+#include "common/Aabb.h"
 #include "common/Component.h"
 #include "common/Vector2D.h"
 
 #include <vector>
-#include <boost/shared_ptr.hpp>
 
-class b2Shape;
+class b2PolygonShape;
+class b2CircleShape;
 
 //--------------------------------------------//
 //-----------   CompShape class   ------------//
@@ -27,11 +28,13 @@ public:
 
     const ComponentTypeId& getTypeId() const { return getTypeIdStatic(); }
 
-    virtual boost::shared_ptr<b2Shape> toB2Shape() const = 0;
-
     enum Type { Polygon, Circle };
     virtual Type getType() const = 0;
 
+    // Bounding Box und Punkttest in lokalen Koordinaten (relativ zur Position der Einheit)
+    virtual Aabb getBoundingBox() const = 0;
+    virtual bool containsPoint(const Vector2D& localPoint) const = 0;
+
     static const ComponentTypeId& getTypeIdStatic();
 };
 
@@ -45,7 +48,7 @@ public:
     void loadFromPropertyTree(const boost::property_tree::ptree& propTree);
     void writeToPropertyTree(boost::property_tree::ptree& propTree) const;
 
-    boost::shared_ptr<b2Shape> toB2Shape() const; // up to the caller to delete the shape
+    void toB2Shape(b2PolygonShape& shape) const;
 
     void setVertex(size_t i, const Vector2D& v);
 
@@ -53,6 +56,8 @@ public:
     size_t getVertexCount() const { return m_vertices.size(); }
 
     Type getType() const { return Polygon; }
+    Aabb getBoundingBox() const;
+    bool containsPoint(const Vector2D& localPoint) const; // the polygon must be convex
 
     static const unsigned int cMaxVertices = 8;
 
@@ -71,12 +76,14 @@ public:
     void loadFromPropertyTree(const boost::property_tree::ptree& propTree);
     void writeToPropertyTree(boost::property_tree::ptree& propTree) const;
 
-    boost::shared_ptr<b2Shape> toB2Shape() const;
+    void toB2Shape(b2CircleShape& shape) const;
 
     float getRadius() const { return m_radius; }
     const Vector2D& getCenter() const { return m_center; }
 
     Type getType() const { return Circle; }
+    Aabb getBoundingBox() const;
+    bool containsPoint(const Vector2D& localPoint) const;
 
 private:
     Vector2D m_center;
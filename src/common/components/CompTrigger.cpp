@@ -106,7 +106,7 @@ void CompTrigger::loadFromPropertyTree(const ptree& propTree)
                 else if (strCompareType == "net")
                     compareType = NotEqualTo;
                 else
-                    log(Warning) << "No compare operation with name '" << strCompareType << "' found!\n";
+                    AA_LOG(Warning) << "No compare operation with name '" << strCompareType << "' found!\n";
 
                 addCondition(boost::make_shared<ConditionCompareVariable>(boost::ref(m_gameEvents), entityId, varName, compareType, numToCompare));
             }
@@ -117,7 +117,7 @@ void CompTrigger::loadFromPropertyTree(const ptree& propTree)
                 addCondition(boost::make_shared<ConditionContact>(boost::ref(m_gameEvents), entity1, entity2));
             }
             else
-                log(Warning) << "No condition found with id '" << condId << "'!\n";
+                AA_LOG(Warning) << "No condition found with id '" << condId << "'!\n";
         }
         else if (nodeName == "effect")
         {
@@ -157,12 +157,12 @@ void CompTrigger::loadFromPropertyTree(const ptree& propTree)
                 else if (strChangeType == "divide")
                     changeType = Divide;
                 else
-                    log(Warning) << "No change operation with name '" << strChangeType << "' found!\n";
+                    AA_LOG(Warning) << "No change operation with name '" << strChangeType << "' found!\n";
 
                 addEffect(boost::make_shared<EffectModifyVariable>(boost::ref(m_gameEvents), entityId, varName, changeType, num));
             }
             else
-                log(Warning) << "No effect found with id '" << effectId << "'!\n";
+                AA_LOG(Warning) << "No effect found with id '" << effectId << "'!\n";
         }
     }
 }
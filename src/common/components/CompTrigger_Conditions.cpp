@@ -20,37 +20,35 @@ ConditionCompareVariable::ConditionCompareVariable(GameEvents& gameEvents, const
   m_compareType (comp),
   m_numToCompareWith (numToCompareWith)
 {
-    m_eventConnection1 = gameEvents.variableUpdate.registerListener(boost::bind(&ConditionCompareVariable::onVariableUpdate, this, _1, _2, _3));
+    // only called for updates of this variable
+    m_eventConnection1 = gameEvents.variableUpdate.registerListener(VariableKey(entity, var), boost::bind(&ConditionCompareVariable::onVariableUpdate, this, _1));
 }
 
-void ConditionCompareVariable::onVariableUpdate(const EntityId& entity, const ComponentId& var, int val)
+void ConditionCompareVariable::onVariableUpdate(int val)
 {
-    if (m_entity == entity && m_var == var)
+    switch ( m_compareType )
     {
-        switch ( m_compareType )
-        {
-        case GreaterThan:
-            setConditionState(val > m_numToCompareWith);
-            break;
-        case GreaterThanOrEqualTo:
-            setConditionState(val >= m_numToCompareWith);
-            break;
-        case LessThan:
-            setConditionState(val < m_numToCompareWith);
-            break;
-        case LessThanOrEqualTo:
-            setConditionState(val <= m_numToCompareWith);
-            break;
-        case EqualTo:
-            setConditionState(val == m_numToCompareWith);
-            break;
-        case NotEqualTo:
-            setConditionState(val != m_numToCompareWith);
-            break;
-        default:
-            setConditionState(false);
-            break;
-        }
+    case GreaterThan:
+        setConditionState(val > m_numToCompareWith);
+        break;
+    case GreaterThanOrEqualTo:
+        setConditionState(val >= m_numToCompareWith);
+        break;
+    case LessThan:
+        setConditionState(val < m_numToCompareWith);
+        break;
+    case LessThanOrEqualTo:
+        setConditionState(val <= m_numToCompareWith);
+        break;
+    case EqualTo:
+        setConditionState(val == m_numToCompareWith);
+        break;
+    case NotEqualTo:
+        setConditionState(val != m_numToCompareWith);
+        break;
+    default:
+        setConditionState(false);
+        break;
     }
 }
 
@@ -58,14 +56,11 @@ ConditionContact::ConditionContact(GameEvents& gameEvents, const EntityId& entit
 : m_entity1 (entityId1),
   m_entity2 (entityId2)
 {
-    m_eventConnection1 = gameEvents.newContact.registerListener(boost::bind(&ConditionContact::onNewContact, this, _1, _2));
+    // only called for contacts between these two entities
+    m_eventConnection1 = gameEvents.entityContact.registerListener(makeEntityPair(entityId1, entityId2), boost::bind(&ConditionContact::onNewContact, this));
 }
 
-void ConditionContact::onNewContact(CompShape& shape1, CompShape& shape2)
+void ConditionContact::onNewContact()
 {
-    if (   (shape1.getEntityId() == m_entity1 && shape2.getEntityId() == m_entity2)
-        || (shape2.getEntityId() == m_entity1 && shape1.getEntityId() == m_entity2))
-    {
-        setConditionState(true);
-    }
+    setConditionState(true);
 }
@@ -41,7 +41,7 @@ public:
     ComponentId getVariable()    const { return m_var; }
     
 private:
-    void onVariableUpdate(const EntityId& entity, const ComponentId& var, int val);
+    void onVariableUpdate(int val);
 
     EntityId m_entity;
     ComponentId m_var;
@@ -61,7 +61,7 @@ public:
     EntityId getEntity2() const { return m_entity2; }
 
 private:
-    void onNewContact(CompShape& shape1, CompShape& shape2);
+    void onNewContact();
 
     EntityId m_entity1;
     EntityId m_entity2;
@@ -24,7 +24,7 @@ public:
     EffectId        getId() const { return getIdStatic(); }
     static EffectId getIdStatic() { return "KillEntity"; }
     void fire();
-    std::string getEntityId() const { return m_entityToKill; }
+    EntityId getEntityId() const { return m_entityToKill; }
 private:
     GameEvents& m_gameEvents;
     EntityId m_entityToKill;
@@ -6,9 +6,10 @@
 
 #include "CompVisualAnimation.h"
 
+#include "CompPosition.h"
 #include "common/GameEvents.h"
 
-#include <sstream>
+#include <cmath>
 #include <boost/bind.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/make_shared.hpp>
@@ -34,23 +35,42 @@ CompVisualAnimation::CompVisualAnimation(const ComponentId& id, GameEvents& game
   m_running (false),
   m_wantToFinish (false),
   m_flip (false),
-  m_playDirection (1)
+  m_playDirection (1),
+  m_compPosition (NULL),
+  m_boundingBox (),
+  m_boxPosition (),
+  m_boxOrientation (0.0f),
+  m_boxValid (false)
 {
+    declareSibling(m_compPosition);
 }
 
-TextureId CompVisualAnimation::getCurrentTexture() const
+const Aabb& CompVisualAnimation::updateBoundingBox()
 {
-    if ( m_animInfo!=NULL )
+    if (m_compPosition == NULL)
+        return m_boundingBox;
+
+    Vector2D position = m_compPosition->getDrawingPosition();
+    float orientation = m_compPosition->getDrawingOrientation();
+    if (!m_boxValid || position != m_boxPosition || orientation != m_boxOrientation)
     {
-        // Namen Bilden (z.B.: "Anim005", besteht aus "Anim" + "005" )
-        std::stringstream digits_str;
-        digits_str.fill('0');
-        digits_str.width(m_animInfo->numDigits);
-        digits_str << m_currentFrame;
-        return std::string("_") + m_animInfo->name + digits_str.str(); // Namen der Textur zurückgeben.
+        // die Mitte wird beim Spiegeln auch gespiegelt, darum mit |center.x| rechnen
+        float hw = m_halfWidth + std::fabs(m_center.x);
+        Aabb localBox (Vector2D(-hw, -m_halfHeight - m_center.y), Vector2D(hw, m_halfHeight - m_center.y));
+        m_boundingBox = localBox.transformed(position, orientation);
+        m_boxPosition = position;
+        m_boxOrientation = orientation;
+        m_boxValid = true;
     }
+    return m_boundingBox;
+}
+
+const AnimFrame* CompVisualAnimation::getCurrentFrame() const
+{
+    if ( m_animInfo!=NULL && m_currentFrame >= 0 && m_currentFrame < (int)m_animInfo->frames.size() )
+        return &m_animInfo->frames[m_currentFrame];
     else
-        return "";
+        return NULL;
 }
 
 void CompVisualAnimation::setState( AnimStateId new_state )
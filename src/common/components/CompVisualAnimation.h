@@ -12,10 +12,13 @@
 #ifndef COMPVISUALANIMATION_H
 #define COMPVISUALANIMATION_H
 
+#include "common/Aabb.h"
 #include "common/Component.h"
 #include "common/Texture.h"
 #include "common/Vector2D.h"
 
+class CompPosition;
+
 //--------------------------------------------//
 //------ CompVisualAnimation Klasse ----------//
 //--------------------------------------------//
@@ -27,14 +30,14 @@ public:
     const ComponentTypeId& getTypeId() const { return getTypeIdStatic(); }
     static const ComponentTypeId& getTypeIdStatic();
 
-    // Welche Textur muss rerade gezeichnet werden? (Eine Animation besteht aus mehreren Texturen)
-    TextureId getCurrentTexture() const;
+    // Welches Bild muss gerade gezeichnet werden? (Textur und Texturkoordinaten, NULL falls die Animation noch nicht bereit ist)
+    const AnimFrame* getCurrentFrame() const;
 
     // Die Mitte der Animation (relativ zur Position der Einheit)
     const Vector2D& center() { return m_center; }
 
     // Dimensionen (Grösse)
-    void setDimensions( float hw, float hh ) { m_halfWidth = hw; m_halfHeight = hh; }
+    void setDimensions( float hw, float hh ) { m_halfWidth = hw; m_halfHeight = hh; m_boxValid = false; }
     void getDimensions( float *hw, float *hh ) { *hw = m_halfWidth; *hh = m_halfHeight; }
 
     // Animation steuern
@@ -52,6 +55,12 @@ public:
     AnimStateId getState() { return m_curState; }    
 
     const AnimInfo* getAnimInfo() const { return m_animInfo; }    
+    const AnimationId& getAnimInfoId() const { return m_animInfoId; }
+
+    // Bounding Box in Weltkoordinaten (für beide Ausrichtungen), wird von updateBoundingBox() nachgeführt
+    const Aabb& getBoundingBox() const { return m_boundingBox; }
+    // rechnet die Box nur neu, wenn sich der Körper bewegt hat
+    const Aabb& updateBoundingBox();
 
     // Ausrichtung ( wenn flip=true wird die Animation eifach horizontal gespiegelt )
     void setFlip( bool flip ) { m_flip = flip; }
@@ -79,6 +88,13 @@ private:
     bool m_wantToFinish;
     bool m_flip;
     int m_playDirection; // Animationsrichtung (vorwärz (1) oder rückwärz (-1))
+
+    CompPosition* m_compPosition; // declared sibling
+
+    Aabb m_boundingBox;
+    Vector2D m_boxPosition;
+    float m_boxOrientation;
+    bool m_boxValid;
 };
 
 #endif
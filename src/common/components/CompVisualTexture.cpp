@@ -7,6 +7,8 @@
 #include "CompVisualTexture.h"
 
 #include "CompShape.h"
+#include "CompPosition.h"
+#include "CompPhysics.h"
 #include "common/Foreach.h"
 
 #include <sstream>
@@ -15,19 +17,63 @@
 
 using boost::property_tree::ptree;
 
+namespace {
+// Kanten werden (wie in RenderSystem::calcEdgeQuad) eine Einheit breit nach aussen gezeichnet
+const float cEdgeHeight = 1.0f;
+}
+
 // eindeutige ID
 const ComponentTypeId& CompVisualTexture::getTypeIdStatic()
 {
     static boost::scoped_ptr<ComponentTypeId> typeId (new ComponentTypeId("CompVisualTexture"));
     return *typeId;
 }
-const std::string CompVisualTexture::ALL_SHAPES = "ALL_SHAPES";
+const ComponentId CompVisualTexture::ALL_SHAPES = "ALL_SHAPES";
 
 CompVisualTexture::CompVisualTexture(const ComponentId& id, GameEvents& gameEvents, TextureId texId)
-: Component(id, gameEvents), m_textureId (texId), m_shapeId (ALL_SHAPES) {}
+: Component(id, gameEvents), m_textureId (texId), m_shapeId (ALL_SHAPES), m_compPosition (NULL), m_compPhysics (NULL),
+  m_localBox (), m_localBoxValid (false), m_boundingBox (), m_boxPosition (), m_boxOrientation (0.0f), m_boxValid (false)
+{
+    declareSibling(m_compPosition);
+    declareSibling(m_compPhysics);
+    declareSiblings(m_compShapes);
+}
+
+const Aabb& CompVisualTexture::updateBoundingBox()
+{
+    if (m_compPosition == NULL)
+        return m_boundingBox;
+
+    if (!m_localBoxValid)
+    {
+        m_localBox = Aabb();
+        bool allShapes = (m_shapeId == ALL_SHAPES);
+        foreach (const CompShape* shape, m_compShapes)
+        {
+            if (!allShapes && shape->getId() != m_shapeId)
+                continue;
+            m_localBox.extend(shape->getBoundingBox());
+        }
+        if (!m_edgeTexId.empty())
+            m_localBox = m_localBox.enlarged(cEdgeHeight);
+        m_localBoxValid = true;
+    }
+
+    Vector2D position = m_compPosition->getDrawingPosition();
+    float orientation = m_compPosition->getDrawingOrientation();
+    if (!m_boxValid || position != m_boxPosition || orientation != m_boxOrientation)
+    {
+        m_boundingBox = m_localBox.transformed(position, orientation);
+        m_boxPosition = position;
+        m_boxOrientation = orientation;
+        m_boxValid = true;
+    }
+    return m_boundingBox;
+}
 
 void CompVisualTexture::loadFromPropertyTree(const ptree& propTree)
 {
+    invalidateBoundingBox();
     m_textureId = propTree.get<std::string>("texture");
     m_shapeId = propTree.get("shape", ALL_SHAPES);
 
@@ -111,7 +157,7 @@ TextureId CompVisualTexture::getEdgeTexture(size_t edgeNum) const
     return it->second;
 }
 
-const std::string& CompVisualTexture::getShapeId() const
+const ComponentId& CompVisualTexture::getShapeId() const
 {
     return m_shapeId;
 }
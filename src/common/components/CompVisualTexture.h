@@ -13,6 +13,7 @@
 #ifndef COMPVISUALTEXTURE_H
 #define COMPVISUALTEXTURE_H
 
+#include "common/Aabb.h"
 #include "common/Component.h"
 #include "common/Texture.h"
 #include "common/Vector2D.h"
@@ -20,6 +21,10 @@
 #include <map>
 #include <vector>
 
+class CompPosition;
+class CompPhysics;
+class CompShape;
+
 //--------------------------------------------//
 //-------- CompVisualTexture Klasse ----------//
 //--------------------------------------------//
@@ -37,19 +42,42 @@ public:
     TextureId getTextureId() const { return m_textureId; }
     size_t getNumTexturedEdges() const { return m_edgeTexId.size(); }
     TextureId getEdgeTexture(size_t edgeNum) const;
-    const std::string& getShapeId() const;
+    const std::map<size_t, TextureId>& getEdgeTextures() const { return m_edgeTexId; }
+    const ComponentId& getShapeId() const;
+
+    // Bounding Box in Weltkoordinaten (mit den Kanten), wird von updateBoundingBox() nachgeführt
+    const Aabb& getBoundingBox() const { return m_boundingBox; }
+    // rechnet die Box nur neu, wenn sich der Körper bewegt hat (oder nach invalidateBoundingBox())
+    const Aabb& updateBoundingBox();
+    // muss aufgerufen werden, wenn die Formen verändert wurden
+    void invalidateBoundingBox() { m_localBoxValid = false; m_boxValid = false; }
     const std::vector<Vector2D>& getTexMap() const;
 
     void loadFromPropertyTree(const boost::property_tree::ptree& propTree);
     void writeToPropertyTree(boost::property_tree::ptree& propTree) const;
 
-    static const std::string ALL_SHAPES;
+    static const ComponentId ALL_SHAPES;
 
 private:
     TextureId m_textureId;
     std::map<size_t, TextureId> m_edgeTexId;
-    std::string m_shapeId; // ID of the shape to be textured or ALL_SHAPES
+    ComponentId m_shapeId; // ID of the shape to be textured or ALL_SHAPES
     std::vector<Vector2D> m_texMap;
+
+    // declared siblings
+    CompPosition* m_compPosition;
+    CompPhysics* m_compPhysics;
+    std::vector<CompShape*> m_compShapes;
+
+    // Bounding Box der texturierten Formen relativ zur Position und die letzte Box in Weltkoordinaten
+    Aabb m_localBox;
+    bool m_localBoxValid;
+    Aabb m_boundingBox;
+    Vector2D m_boxPosition;
+    float m_boxOrientation;
+    bool m_boxValid;
+
+    friend class RenderSystem;
 };
 
 #endif
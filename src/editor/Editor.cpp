@@ -46,7 +46,7 @@ void Editor::setTextureList(const std::vector<std::string>& textureList)
     m_currentTextureIt = m_textureList.begin();
     m_guiData.currentTexture = *m_currentTextureIt;
     if (m_textureList.empty())
-        log(Warning) << "No textures found for editor!\n";
+        AA_LOG(Warning) << "No textures found for editor!\n";
 }
 
 
@@ -68,7 +68,7 @@ void Editor::loadLevel(const std::string& fileName)
     }
     catch (DataLoadException& e)
     {
-        log(Error) << "Could not read level: " << e.getMsg() << "\n";
+        AA_LOG(Error) << "Could not read level: " << e.getMsg() << "\n";
         return;
     }
 }
@@ -185,11 +185,17 @@ void Editor::cmdSetNewCompId(const ComponentId& id, const Component* comp)
         if (c == comp)
         {
             c->setId(id);
+            cmdUpdateComponent(*c); // e.g. a texture refers to its shape by ID
             break;
         }
     }
 }
 
+void Editor::cmdUpdateComponent(Component& comp)
+{
+    m_events.componentChanged.fire(comp);
+}
+
 const EditorGuiData& Editor::getGuiData()
 {
     return m_guiData;
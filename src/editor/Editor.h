@@ -52,6 +52,8 @@ public:
     void cmdSelect(const Vector2D& pos);
     bool cmdSetNewEntityId(const EntityId& id);
     void cmdSetNewCompId(const ComponentId& id, const Component* comp);
+    // must be called after a component was changed (e.g. with loadFromPropertyTree), so that the systems update it
+    void cmdUpdateComponent(Component& comp);
 
     const EditorGuiData& getGuiData();
 
@@ -182,7 +182,7 @@ void EditorFrame::enableEntity(const EntityId& id, const std::vector<const Compo
     int index = 0;
     foreach(const Component* comp, comps)
     {
-        wxString compTypeId (comp->getTypeId().substr(4).c_str(), wxConvUTF8);
+        wxString compTypeId (comp->getTypeId().str().substr(4).c_str(), wxConvUTF8);
         wxString compId (comp->getId().c_str(), wxConvUTF8);
 
         m_compList->InsertItem(index, compTypeId); // col. 1
@@ -435,6 +435,7 @@ void EditorFrame::onPropEdit()
     pt.parent.erase(pt.parent.to_iterator(pt.it));
     pt.parent.put(id, dialog.getValue());
     m_selectedComp->loadFromPropertyTree(*m_propTree);
+    m_editor.cmdUpdateComponent(*m_selectedComp);
     enableComponent(m_selectedComp); // update
 }
 
@@ -447,6 +448,7 @@ void EditorFrame::onPropNew(wxCommandEvent&)
 
     m_propTree->put(dialog.getKey(), dialog.getValue());
     m_selectedComp->loadFromPropertyTree(*m_propTree);
+    m_editor.cmdUpdateComponent(*m_selectedComp);
     enableComponent(m_selectedComp); // update
 }
 
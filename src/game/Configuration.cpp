@@ -16,6 +16,76 @@ using boost::property_tree::ptree;
 
 ptree gConfig;
 
+Event2<const ConfigSnapshot&, const ConfigSnapshot&> gConfigChanged;
+
+namespace {
+ConfigSnapshot configSnapshot;
+}
+
+ConfigSnapshot::ConfigSnapshot()
+: antiAliasing (0),
+  fullScreen (false),
+  idleFps (10),
+  maxFps (120),
+  mouseSensitivity (1.0f),
+  screenBpp (32),
+  screenWidth (1024),
+  screenHeight (768),
+  texQuality (0),
+  vSync (1),
+  volMaster (0.5f),
+  volMusic (1.0f),
+  volSound (1.0f)
+{
+}
+
+bool ConfigSnapshot::operator == (const ConfigSnapshot& other) const
+{
+    return antiAliasing == other.antiAliasing &&
+           fullScreen == other.fullScreen &&
+           idleFps == other.idleFps &&
+           maxFps == other.maxFps &&
+           mouseSensitivity == other.mouseSensitivity &&
+           screenBpp == other.screenBpp &&
+           screenWidth == other.screenWidth &&
+           screenHeight == other.screenHeight &&
+           texQuality == other.texQuality &&
+           vSync == other.vSync &&
+           volMaster == other.volMaster &&
+           volMusic == other.volMusic &&
+           volSound == other.volSound;
+}
+
+const ConfigSnapshot& getConfig()
+{
+    return configSnapshot;
+}
+
+void applyConfig()
+{
+    const ConfigSnapshot defaults;
+    ConfigSnapshot config;
+    config.antiAliasing = gConfig.get("AntiAliasing", defaults.antiAliasing);
+    config.fullScreen = gConfig.get("FullScreen", defaults.fullScreen);
+    config.idleFps = gConfig.get("IdleFps", defaults.idleFps);
+    config.maxFps = gConfig.get("MaxFps", defaults.maxFps);
+    config.mouseSensitivity = gConfig.get("MouseSensitivity", defaults.mouseSensitivity);
+    config.screenBpp = gConfig.get("ScreenBpp", defaults.screenBpp);
+    config.screenWidth = gConfig.get("ScreenWidth", defaults.screenWidth);
+    config.screenHeight = gConfig.get("ScreenHeight", defaults.screenHeight);
+    config.texQuality = gConfig.get("TexQuality", defaults.texQuality);
+    config.vSync = gConfig.get("V-Sync", defaults.vSync);
+    config.volMaster = gConfig.get("VolMaster", defaults.volMaster);
+    config.volMusic = gConfig.get("VolMusic", defaults.volMusic);
+    config.volSound = gConfig.get("VolSound", defaults.volSound);
+
+    if (config == configSnapshot)
+        return;
+    ConfigSnapshot oldConfig = configSnapshot;
+    configSnapshot = config;
+    gConfigChanged.fire(oldConfig, configSnapshot);
+}
+
 void loadConfig(const std::string& fileName, boost::property_tree::ptree& config)
 {
     try
@@ -36,6 +106,8 @@ void loadDefaultConfig(boost::property_tree::ptree& config)
     config.put("AntiAliasing", 0);
     config.put("EditorLevel", "data/Levels/level_editor.info");
     config.put("FullScreen", false);
+    config.put("IdleFps", 10);
+    config.put("MaxFps", 120);
     config.put("MouseSensitivity", 1.0);
     config.put("ScreenBpp", 32);
     config.put("ScreenWidth", 1024);
@@ -69,6 +141,10 @@ bool writeConfig(const std::string& fileName, const ptree& config)
             comment = "The level that will be edited in the level editor";
         else if (name == "FullScreen")
             comment = "true: full screen, false: windowed";
+        else if (name == "IdleFps")
+            comment = "Frame rate while the window has no focus or is minimized - 0: same as MaxFps";
+        else if (name == "MaxFps")
+            comment = "Frame rate limit, the rest of the time is given to other programs - 0: no limit";
         else if (name == "MouseSensitivity")
             comment = "Mouse sensitivity - any floating point number";
         else if (name == "ScreenBpp")
@@ -7,12 +7,49 @@
 #ifndef CONFIGURATION_H
 #define CONFIGURATION_H
 
+#include "common/Event.h"
+
 #include <string>
 #include <boost/property_tree/ptree.hpp>
 
 // the global configuration property tree
 extern boost::property_tree::ptree gConfig;
 
+// Typisierte Kopie von gConfig, damit oft gelesene Werte (z.B. jedes Frame in InputSubSystem::update)
+// nicht jedes Mal im ptree gesucht und umgewandelt werden müssen.
+class ConfigSnapshot
+{
+public:
+    ConfigSnapshot(); // default values (same as loadDefaultConfig)
+
+    bool operator == (const ConfigSnapshot& other) const;
+    bool operator != (const ConfigSnapshot& other) const { return !(*this == other); }
+
+    int antiAliasing;
+    bool fullScreen;
+    unsigned int idleFps;
+    unsigned int maxFps;
+    float mouseSensitivity;
+    int screenBpp;
+    int screenWidth;
+    int screenHeight;
+    int texQuality;
+    int vSync;
+    float volMaster;
+    float volMusic;
+    float volSound;
+};
+
+// the values of gConfig at the last applyConfig()
+const ConfigSnapshot& getConfig();
+
+// Read gConfig into the snapshot, call it after gConfig was changed.
+// Missing or invalid entries get the default value.
+// If something changed, gConfigChanged is fired with the old and the new values.
+void applyConfig();
+
+extern Event2<const ConfigSnapshot&, const ConfigSnapshot&> gConfigChanged;
+
 void loadConfig(const std::string& fileName, boost::property_tree::ptree& config);
 void loadDefaultConfig(boost::property_tree::ptree& config);
 
@@ -10,6 +10,7 @@
 #include "Input.h"
 #include "Gui.h"
 #include "GameState.h"
+#include "HeadlessBenchmark.h"
 
 #include "states/MainMenuState.h"
 #include "states/PlayingState.h"
@@ -21,14 +22,31 @@
 #include "common/Component.h"
 #include "common/Texture.h"
 #include "common/Exception.h"
+#include "common/Profiler.h"
+#include "common/Clock.h"
 
 #include <string>
 #include <iostream>
+#include <sstream>
+#include <algorithm>
 #include <SDL.h>
 #include <SDL_opengl.h>
 #include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/lexical_cast.hpp>
+
+#ifdef AA_PROFILE
+namespace {
+// written at exit or when F12 is pressed
+const char* const cProfilerTraceFileName = "profiler_trace.json";
+}
+#endif
+
+namespace {
+// written at exit or when F11 is pressed
+const char* const cFrameTimesFileName = "frame_times.txt";
+}
 
 // Konstruktor
 GameApp::GameApp(const std::vector<std::string>& args) :
@@ -36,15 +54,21 @@ GameApp::GameApp(const std::vector<std::string>& args) :
         m_subSystems (),
         m_quit ( false ),
         m_eventConnection (),
+        m_configConnection (),
         m_fpsMeasureStart ( 0 ),
         m_framesCounter ( 0 ),
         m_fps ( 0 ),
+        m_framePacer (),
+        m_frameTimes (),
         m_startGame ( true ),
         m_fullScreen ( false ),
         m_overrideFullScreen ( false ),
-        m_doRestart (false)
+        m_doRestart (false),
+        m_headless (false),
+        m_headlessTicks (6000)
 {
     m_eventConnection = m_subSystems.events.quitGame.registerListener( boost::bind( &GameApp::onQuit, this, _1 ) );
+    m_configConnection = gConfigChanged.registerListener( boost::bind( &GameApp::onConfigChanged, this, _1, _2 ) );
 
     parseArguments(args);
 }
@@ -69,8 +93,9 @@ SubSystems::~SubSystems()
 // TODO: handle bad inits
 bool SubSystems::init()
 {
-    renderer.init( gConfig.get<int>("ScreenWidth"), gConfig.get<int>("ScreenHeight") );
-    sound.init(gConfig.get<float>("VolSound"), gConfig.get<float>("VolMusic"), gConfig.get<float>("VolMaster"));
+    const ConfigSnapshot& config = getConfig();
+    renderer.init( config.screenWidth, config.screenHeight );
+    sound.init(config.volSound, config.volMusic, config.volMaster);
     return true;
 }
 
@@ -95,7 +120,7 @@ bool GameApp::doRestart()
 // Alle Objekte von GameApp initialisieren
 void GameApp::init()
 {
-    log(Info) << "* Started initialization *\n\n";  // In Log-Datei schreiben
+    AA_LOG(Info) << "* Started initialization *\n\n";  // In Log-Datei schreiben
 
     //========================= SDL ============================//
     if ( !initSDL() ) // SDL initialisieren
@@ -106,17 +131,17 @@ void GameApp::init()
         throw Exception(std::string() + "Error setting up the screen - " + gConfig.get<std::string>("ScreenWidth") + "x" + gConfig.get<std::string>("ScreenHeight") + " " + gConfig.get<std::string>("ScreenBpp") + " Bit\n" + SDL_GetError() + "\n");
 
     //===================== Untersysteme =======================//
-    log(Info) << "Initializing sub systems... ";
+    AA_LOG(Info) << "Initializing sub systems... ";
     m_subSystems.init();
-    log(Info) << "[ Done ]\n";
+    AA_LOG(Info) << "[ Done ]\n";
 
     // "Loading..." -> Ladungsanzeige zeichnen
     m_subSystems.renderer.displayLoadingScreen();
 
-    // Texturen laden
-    m_subSystems.renderer.loadData((TexQuality) gConfig.get<int>("TexQuality"));
+    // nur globale Texturen und Schriften laden, die Grafiken der Levels lädt PlayingState
+    m_subSystems.renderer.loadData((TexQuality) getConfig().texQuality, RenderSystem::GlobalResources);
 
-    log(Info) << "\n* Finished initialization *\n";
+    AA_LOG(Info) << "\n* Finished initialization *\n";
 
     boost::shared_ptr<GameState> gameState;
     if (m_levelToLoad.empty())
@@ -131,14 +156,14 @@ void GameApp::init()
 // SDL und Fenster initialisieren
 bool GameApp::initSDL()
 {
-    log(Info) << "Initializing SDL... ";
+    AA_LOG(Info) << "Initializing SDL... ";
 
     if ( SDL_Init( SDL_INIT_VIDEO | SDL_INIT_AUDIO ) == -1 )       // SDL initialisieren
         return false;
 
     SDL_WM_SetCaption(GAME_NAME, NULL); // Fensterbeschriftung
     SDL_ShowCursor(SDL_DISABLE);
-    if (gConfig.get<bool>("FullScreen")) // TODO: change this on config update
+    if (getConfig().fullScreen) // TODO: change this on config update
         SDL_WM_GrabInput(SDL_GRAB_ON); // No cursor + SDL_GRAB_ON = relative mouse
 
     // Events, die ignoriert werden können
@@ -152,7 +177,7 @@ bool GameApp::initSDL()
     SDL_EventState(SDL_MOUSEBUTTONDOWN, SDL_IGNORE);
     SDL_EventState(SDL_MOUSEBUTTONUP, SDL_IGNORE);
 
-    log(Info) << "[ Done ]\n";
+    AA_LOG(Info) << "[ Done ]\n";
 
     return true;
 }
@@ -160,17 +185,19 @@ bool GameApp::initSDL()
 // Anzeige initialisieren
 bool GameApp::initVideo()
 {
-    log(Info) << "Setting up video... ";
+    AA_LOG(Info) << "Setting up video... ";
+
+    const ConfigSnapshot& config = getConfig();
 
     // Einige OpenGL Flags festlegen, bevor wir SDL_SetVideoMode() aufrufen
-    SDL_GL_SetAttribute ( SDL_GL_RED_SIZE, gConfig.get<int>("ScreenBpp")/4 );    // Grösse der Rotkomponente im Framebuffer, in Bits
-    SDL_GL_SetAttribute ( SDL_GL_GREEN_SIZE, gConfig.get<int>("ScreenBpp")/4 );  // Grösse der Greenkomponente im Framebuffer, in Bits
-    SDL_GL_SetAttribute ( SDL_GL_BLUE_SIZE, gConfig.get<int>("ScreenBpp")/4 );   // Grösse der Blaukomponente im Framebuffer, in Bits
-    SDL_GL_SetAttribute ( SDL_GL_ALPHA_SIZE, gConfig.get<int>("ScreenBpp")/4 );  // Grösse der Alphakomponente im Framebuffer, in Bits
+    SDL_GL_SetAttribute ( SDL_GL_RED_SIZE, config.screenBpp/4 );    // Grösse der Rotkomponente im Framebuffer, in Bits
+    SDL_GL_SetAttribute ( SDL_GL_GREEN_SIZE, config.screenBpp/4 );  // Grösse der Greenkomponente im Framebuffer, in Bits
+    SDL_GL_SetAttribute ( SDL_GL_BLUE_SIZE, config.screenBpp/4 );   // Grösse der Blaukomponente im Framebuffer, in Bits
+    SDL_GL_SetAttribute ( SDL_GL_ALPHA_SIZE, config.screenBpp/4 );  // Grösse der Alphakomponente im Framebuffer, in Bits
     SDL_GL_SetAttribute ( SDL_GL_DEPTH_SIZE, 16 ); // TODO: what value?
     //SDL_GL_SetAttribute ( SDL_GL_BUFFER_SIZE, 16 );
     SDL_GL_SetAttribute ( SDL_GL_DOUBLEBUFFER, 1 );                              // Double Buffering aktivieren
-    int AA = gConfig.get<int>("AntiAliasing");
+    int AA = config.antiAliasing;
     if (AA!=0)
     {
         SDL_GL_SetAttribute ( SDL_GL_MULTISAMPLEBUFFERS, 1 );               // Full Screen Anti-Aliasing aktivieren und
@@ -178,7 +205,7 @@ bool GameApp::initVideo()
     }
     else
         SDL_GL_SetAttribute ( SDL_GL_MULTISAMPLEBUFFERS, 0 );
-    SDL_GL_SetAttribute( SDL_GL_SWAP_CONTROL, gConfig.get<int>("V-Sync") );
+    SDL_GL_SetAttribute( SDL_GL_SWAP_CONTROL, config.vSync );
 
     // Videomodus einrichten. Überprüfen ob es Fehler gab.
     Uint32 flags = SDL_OPENGL;
@@ -187,16 +214,16 @@ bool GameApp::initVideo()
         if ( m_fullScreen )
             flags |= SDL_FULLSCREEN;
     }
-    else if ( gConfig.get<bool>("FullScreen") )
+    else if ( config.fullScreen )
         flags |= SDL_FULLSCREEN;
 
-    if ( !SDL_VideoModeOK( gConfig.get<int>("ScreenWidth"), gConfig.get<int>("ScreenHeight"), gConfig.get<int>("ScreenBpp"), flags ) ) {
-        log(Error) << "Video mode not supported\n";
+    if ( !SDL_VideoModeOK( config.screenWidth, config.screenHeight, config.screenBpp, flags ) ) {
+        AA_LOG(Error) << "Video mode not supported\n";
         return false;
     }
     
     // set up screen
-    if ( !SDL_SetVideoMode ( gConfig.get<int>("ScreenWidth"), gConfig.get<int>("ScreenHeight"), gConfig.get<int>("ScreenBpp"), flags ) )
+    if ( !SDL_SetVideoMode ( config.screenWidth, config.screenHeight, config.screenBpp, flags ) )
         return false; // TODO: more info
 
     GLenum errCode;
@@ -204,35 +231,36 @@ bool GameApp::initVideo()
     if ((errCode = glGetError()) != GL_NO_ERROR)
     {
         errString = gluErrorString(errCode);
-        log(Error) << "GameApp::initVideo> OpenGL Error: " << errString << "\n";
+        AA_LOG(Error) << "GameApp::initVideo> OpenGL Error: " << errString << "\n";
     }
 
-    log(Info) << "[ Done ]\n\n";
+    AA_LOG(Info) << "[ Done ]\n\n";
 
-    log(Info) << "Graphic card: " << glGetString(GL_RENDERER) << "(" << glGetString(GL_VENDOR) << ")\n";
-    log(Info) << "OpenGL version: " << glGetString(GL_VERSION) << "\n";
+    AA_LOG(Info) << "Graphic card: " << glGetString(GL_RENDERER) << "(" << glGetString(GL_VENDOR) << ")\n";
+    AA_LOG(Info) << "OpenGL version: " << glGetString(GL_VERSION) << "\n";
 
     const SDL_VideoInfo* vidInfo = SDL_GetVideoInfo();
 
     int value = 0;
     SDL_GL_GetAttribute ( SDL_GL_BUFFER_SIZE, &value );
     gConfig.put("ScreenBpp", value);
-    log(Info) << "Resolution: " << vidInfo->current_w << "x" << vidInfo->current_h << "\n";
-    //log(Info) << "Widescreen: " << (gConfig.get<bool>("WideScreen")?"on":"off") << "\n";
-    log(Info) << "Bits per pixel: " << value << "\n";
+    AA_LOG(Info) << "Resolution: " << vidInfo->current_w << "x" << vidInfo->current_h << "\n";
+    //AA_LOG(Info) << "Widescreen: " << (gConfig.get<bool>("WideScreen")?"on":"off") << "\n";
+    AA_LOG(Info) << "Bits per pixel: " << value << "\n";
     SDL_GL_GetAttribute ( SDL_GL_DOUBLEBUFFER, &value );
-    log(Info) << "Double buffer: " << (value?"on":"off") << "\n";
+    AA_LOG(Info) << "Double buffer: " << (value?"on":"off") << "\n";
     value = 1;
     SDL_GL_GetAttribute ( SDL_GL_MULTISAMPLESAMPLES, &value );
     gConfig.put("AntiAliasing", value);
     if (value==1)
-        log(Info) << "Anti-aliasing: off\n";
+        AA_LOG(Info) << "Anti-aliasing: off\n";
     else
-        log(Info) << "Anti-aliasing: " << value << "x\n";
+        AA_LOG(Info) << "Anti-aliasing: " << value << "x\n";
     SDL_GL_GetAttribute ( SDL_GL_SWAP_CONTROL, &value );
     gConfig.put("V-Sync", value);
     value = 1;
-    log(Info) << "V-Sync: " << (value?"on":"off") << "\n\n";
+    AA_LOG(Info) << "V-Sync: " << (value?"on":"off") << "\n\n";
+    applyConfig(); // the values that were really set
 
     return true;
 }
@@ -242,32 +270,43 @@ void GameApp::deInit()
 {
     if (m_isInit)
     {
-        log(Info) << "* Started deinitialization *\n\n";      // In Log-Datei schreiben
+        AA_LOG(Info) << "* Started deinitialization *\n\n";      // In Log-Datei schreiben
 
-        log(Info) << "Cleaning up SubSystems...";
+        PROFILE_WRITE_TRACE(cProfilerTraceFileName);
+
+        AA_LOG(Info) << "Cleaning up SubSystems...";
         m_subSystems.deInit();
-        log(Info) << "[ Done ]\n";
+        AA_LOG(Info) << "[ Done ]\n";
 
         // SDL beenden
-        log(Info) << "Shuting down SDL...";
+        AA_LOG(Info) << "Shuting down SDL...";
         SDL_Quit();
-        log(Info) << "[ Done ]\n";
+        AA_LOG(Info) << "[ Done ]\n";
 
-        log(Info) << "\n* Finished deinitialization *\n";   // In Log-Datei schreiben
+        AA_LOG(Info) << "\n* Finished deinitialization *\n";   // In Log-Datei schreiben
         m_isInit = false;
     }
 }
 
 // Nach der Initialisation Spiel m_fpsMeasureStarten (d.h. Hauptschleife m_fpsMeasureStarten)
-void GameApp::run()
+bool GameApp::run()
 {
     if (!m_startGame)
-        return;
+        return true;
+    if (m_headless)
+    {
+        // no SDL, OpenGL or sound initialization needed
+        HeadlessBenchmark benchmark (m_levelToLoad, m_headlessTicks);
+        bool success = benchmark.run();
+        PROFILE_WRITE_TRACE(cProfilerTraceFileName);
+        return success;
+    }
     init();
     //deInit();
     //init(); // TODO this doesn't work, is it supposed to work?
     mainLoop();
     deInit();
+    return true;
 }
 
 // Kleine vereinfachungen der Hauptfunktionen
@@ -278,18 +317,28 @@ void GameApp::run()
 // Hauptschleife des Spieles
 void GameApp::mainLoop()
 {
-    log(Info) << "Main loop started\n";
-    m_fpsMeasureStart = SDL_GetTicks();
+    AA_LOG(Info) << "Main loop started\n";
+    m_fpsMeasureStart = getMonotonicTimeNs();
+
+    m_framePacer.setMaxFps(getConfig().maxFps);
+    m_framePacer.setIdleFps(getConfig().idleFps);
 
-    // Variablen um Zeit zu messen
-    Uint32 currentTimeMsecs = 0;              // momentane Zeit
-    Uint32 lastTimeMsecs = 0;                 // Zeit, wo letzes Frame gerendert wurde
-    currentTimeMsecs = lastTimeMsecs = SDL_GetTicks(); // Alle mit aktuellen Zeit initialisieren
+    // Variablen um Zeit zu messen (SDL_GetTicks() hat nur Millisekunden, das ist zu ungenau für 16.7ms Updates)
+    boost::uint64_t currentTimeNs = 0;              // momentane Zeit
+    boost::uint64_t lastTimeNs = 0;                 // Zeit, wo letzes Frame gerendert wurde
+    currentTimeNs = lastTimeNs = getMonotonicTimeNs(); // Alle mit aktuellen Zeit initialisieren
 
     float timeAccumulator = 0.0f; // Time Akkumulator: damit eine PC unabhängige interne schlaufe immer mit 60Hz durchlaufen kann
 
     float deltaTime = 0.0; // Zeit seit letzter Frame -> um Bewegungen in einer konstanten Rate zu aktualisieren
 
+    // Frame-Zeiten werden erst am Anfang der nächsten Schleife bekannt (inklusive Warten im FramePacer),
+    // update und draw werden bis dann zurückgehalten, damit alle drei Verteilungen die gleichen Frames enthalten.
+    // Leerlauf (IdleFps), minimierte Fenster und Ladeframes zählen nicht, sonst sähen sie wie Hänger aus.
+    bool recordLastFrame = false;
+    boost::uint64_t lastUpdateNs = 0;
+    boost::uint64_t lastDrawNs = 0;
+
     SDL_Event sdlWindowEvent; // SDL Eingabe-Ereignisse (nur für den Fall, wann der Benutzer das Fenster schliessen will)
     // Die restlichen Eingaben werden in Input.cpp gemacht.
 
@@ -302,26 +351,40 @@ void GameApp::mainLoop()
     // Solange der benutzer noch nicht abgebrochen hat
     while ( m_quit == false )
     {
-        currentTimeMsecs = SDL_GetTicks();
-        deltaTime = (currentTimeMsecs - lastTimeMsecs) * 0.001f;
-        lastTimeMsecs = currentTimeMsecs;
+        PROFILE_ZONE("GameApp::mainLoop");
+        currentTimeNs = getMonotonicTimeNs();
+        deltaTime = (currentTimeNs - lastTimeNs) * 1e-9f;
+        if (recordLastFrame)
+        {
+            m_frameTimes.frame.add(currentTimeNs - lastTimeNs);
+            m_frameTimes.update.add(lastUpdateNs);
+            m_frameTimes.draw.add(lastDrawNs);
+        }
+        recordLastFrame = false;
+        lastTimeNs = currentTimeNs;
 
-        bool hasFocus = ((SDL_GetAppState() & SDL_APPACTIVE) != 0);
+        Uint8 appState = SDL_GetAppState();
+        bool hasFocus = ((appState & SDL_APPACTIVE) != 0);
+        bool idle = !hasFocus || (appState & SDL_APPINPUTFOCUS) == 0; // minimiert oder im Hintergrund
         if (hasFocus)
         {
-            calcFPS(currentTimeMsecs);
+            calcFPS(currentTimeNs);
 
-            FRAME(deltaTime);
+            {
+                PROFILE_ZONE("FRAME");
+                FRAME(deltaTime);
+            }
 
             timeAccumulator += deltaTime;
 
             const float cMaxTimeAccumulator = 0.5f;
 
             // If the game was in a loading state, the accumulator is too big or the windows hanst focus, reset the accumulator
+            bool loading = m_subSystems.isLoading;
             if (m_subSystems.isLoading || deltaTime > cMaxTimeAccumulator)
             {
                 if (!m_subSystems.isLoading)
-                    log(Warning) << "Time accumulator too big, skipping updates\n";
+                    AA_LOG(Warning) << "Time accumulator too big, skipping updates\n";
 
                 timeAccumulator = 0;
                 m_subSystems.isLoading = false;
@@ -330,24 +393,35 @@ void GameApp::mainLoop()
 
             const float slowMotionDelay = 0.0f; // mainly for testing purpose
 
+            boost::uint64_t updateStartNs = getMonotonicTimeNs();
             while (timeAccumulator >= cPhysicsTimeStep + slowMotionDelay)
             {
+                PROFILE_ZONE("UPDATE");
                 UPDATE();
                 timeAccumulator -= cPhysicsTimeStep + slowMotionDelay;
             }
+            boost::uint64_t drawStartNs = getMonotonicTimeNs();
 
             if (m_quit)
                 break; // don't redraw the screen if we are quitting
 
             //m_subSystems.renderer.clearScreen();
-            DRAW(timeAccumulator/(cPhysicsTimeStep + slowMotionDelay) * cPhysicsTimeStep); // Spiel zeichnen
-            m_subSystems.renderer.drawFPS(m_fps);
+            {
+                PROFILE_ZONE("DRAW");
+                DRAW(timeAccumulator/(cPhysicsTimeStep + slowMotionDelay) * cPhysicsTimeStep); // Spiel zeichnen
+                m_subSystems.renderer.drawFPS(m_fps);
+            }
             m_subSystems.renderer.flipBuffer();
+
+            // isLoading kann auch in UPDATE() gesetzt werden (z.B. Neustart vom Snapshot)
+            recordLastFrame = !idle && !loading && !m_subSystems.isLoading;
+            lastUpdateNs = drawStartNs - updateStartNs;
+            lastDrawNs = getMonotonicTimeNs() - drawStartNs;
         }
 
         handleSdlQuitEvents(sdlWindowEvent); // check if user wants to close window
 
-        SDL_Delay(0);
+        m_framePacer.endFrame(idle); // warten bis zum nächsten Frame
     }
 
     ////////////////////////////////////////////////////////
@@ -356,13 +430,22 @@ void GameApp::mainLoop()
     //                                                    //
     ////////////////////////////////////////////////////////
 
+    writeFrameTimes();
+
+}
+
+// Einstellungen übernehmen, die ohne Neustart geändert werden können
+void GameApp::onConfigChanged(const ConfigSnapshot& /*oldConfig*/, const ConfigSnapshot& newConfig)
+{
+    m_framePacer.setMaxFps(newConfig.maxFps);
+    m_framePacer.setIdleFps(newConfig.idleFps);
 }
 
 void GameApp::onQuit(bool restart)
 {
     m_quit = true;
     m_doRestart = restart;
-    log(Info) << "User requested to quit, quitting...\n";
+    AA_LOG(Info) << "User requested to quit, quitting...\n";
     m_subSystems.renderer.displayTextScreen("Closing AstroAttack...");
 }
 
@@ -392,6 +475,14 @@ void GameApp::handleSdlQuitEvents(SDL_Event& sdlEvent)
                 if (sdlEvent.key.keysym.mod & KMOD_LALT) // ALT-F4
                     onQuit();
                 break;
+            case SDLK_F11:
+                writeFrameTimes();
+                break;
+#ifdef AA_PROFILE
+            case SDLK_F12:
+                PROFILE_WRITE_TRACE(cProfilerTraceFileName);
+                break;
+#endif
 
             default:
                 break;
@@ -411,19 +502,32 @@ void GameApp::handleSdlQuitEvents(SDL_Event& sdlEvent)
 
 // Framerate aktualisieren (Frames pro Sekunde)
 // Einmal pro frame aufrufen
-void GameApp::calcFPS( unsigned int curTime )
+void GameApp::calcFPS( boost::uint64_t curTimeNs )
 {
-    if ( m_fpsMeasureStart + 1000 < curTime )
+    if ( m_fpsMeasureStart + 1000000000 < curTimeNs )
     {
         // m_framesCounter ist jetzt die Anzahl Frames in dieser Sekunde, also die FPS
         m_fps = m_framesCounter;
-        log(Info) << "FPS: " << m_fps << "\n";
+        FramePacer::Stats stats = m_framePacer.takeStats();
+        boost::uint64_t totalNs = std::max(stats.getTotalNs(), (boost::uint64_t)1);
+        AA_LOG(Info) << "FPS: " << m_fps << " (work " << stats.workNs * 100 / totalNs << "%, sleep "
+                  << stats.sleepNs * 100 / totalNs << "%, spin " << stats.spinNs * 100 / totalNs << "%)\n";
         m_framesCounter = 0;
-        m_fpsMeasureStart = SDL_GetTicks();
+        m_fpsMeasureStart = curTimeNs;
     }
     ++m_framesCounter;
 }
 
+// Verteilung der letzten Frame-Zeiten ins Log und in cFrameTimesFileName schreiben (F11 und beim Beenden)
+void GameApp::writeFrameTimes()
+{
+    std::ostringstream out;
+    m_frameTimes.write(out);
+    AA_LOG(Info) << out.str();
+    if (!m_frameTimes.writeToFile(cFrameTimesFileName))
+        AA_LOG(Warning) << "Could not write frame times to '" << cFrameTimesFileName << "'\n";
+}
+
 // Programmargumente verarbeiten
 void GameApp::parseArguments( const std::vector<std::string>& args )
 {
@@ -445,6 +549,23 @@ void GameApp::parseArguments( const std::vector<std::string>& args )
         {
             m_levelToLoad = args[++i];
         }
+        else if ( args[i]=="--headless" )
+        {
+            m_headless = true;
+        }
+        else if ( args[i]=="--ticks" && i+1<args.size() )
+        {
+            try
+            {
+                m_headlessTicks = boost::lexical_cast<unsigned int>(args[++i]);
+            }
+            catch (boost::bad_lexical_cast&)
+            {
+                outputStr = "Invalid number of ticks: " + args[i] + "\n";
+                m_startGame = false;
+                break;
+            }
+        }
         else if ( args[i]=="-v" || args[i]=="--version" )
         {
             outputStr = GAME_NAME " " GAME_VERSION "\n";
@@ -460,12 +581,21 @@ void GameApp::parseArguments( const std::vector<std::string>& args )
                          " -h, --help             :  show help\n"
                          " -l, --level LEVELFILE  :  directly load a level file at startup\n"
                          " -f, --full-screen      :  start in full screen mode\n"
+                         " --headless             :  simulate the level given with --level without window\n"
+                         "                           and sound as fast as possible and print timings\n"
+                         " --ticks N              :  number of updates to simulate in headless mode (default 6000)\n"
                          "See README.txt for more info.\n";
             m_startGame = false;
             break;
         }
     }
 
+    if ( m_startGame && m_headless && m_levelToLoad.empty() )
+    {
+        outputStr = "--headless needs a level (--level LEVELFILE)\n";
+        m_startGame = false;
+    }
+
     if ( outputStr != "" )
     {
         std::cout << outputStr;
@@ -14,6 +14,8 @@
 #include "game/GameState.h"
 
 #include "common/Event.h"
+#include "common/FramePacer.h"
+#include "common/FrameTimes.h"
 #include "common/Physics.h"
 #include "common/Renderer.h"
 #include "common/Sound.h"
@@ -24,6 +26,7 @@
 #include <string>
 
 union SDL_Event;
+class ConfigSnapshot;
 
 // Alle wichtigen Untersysteme des Spieles
 class SubSystems
@@ -56,7 +59,7 @@ public:
     GameApp(const std::vector<std::string>& args);
     ~GameApp();
 
-    void run();     // Spiel starten (nach der Initialisierung ), d.h. Hauptschleife starten
+    bool run();     // Spiel starten (nach der Initialisierung ), d.h. Hauptschleife starten. false: Fehler (z.B. Benchmark fehlgeschlagen)
 
     bool doRestart(); // tells whether the app wants to be should be re-run after destruction
 
@@ -74,14 +77,19 @@ private:
     void onQuit(bool restart = false); // Spiel beenden (Wird von einem Event aufgerufen)
 
     EventConnection m_eventConnection;
+    EventConnection m_configConnection;
+    void onConfigChanged(const ConfigSnapshot& oldConfig, const ConfigSnapshot& newConfig);
 
     void updateGame();
     void handleSdlQuitEvents( SDL_Event& );
-    void calcFPS( unsigned int curTime );
+    void calcFPS( boost::uint64_t curTimeNs );
+    void writeFrameTimes();
 
-    unsigned int m_fpsMeasureStart;
+    boost::uint64_t m_fpsMeasureStart;
     unsigned int m_framesCounter;
     unsigned int m_fps;
+    FramePacer m_framePacer; // begrenzt die Bildrate (MaxFps, IdleFps)
+    FrameTimes m_frameTimes;
 
     std::string m_levelToLoad; // empty if shoud go to main menu
     bool m_startGame; // true if the game should be started (or false if only a message should be printed i.e. '--version')
@@ -91,6 +99,9 @@ private:
 
     bool m_doRestart;
 
+    bool m_headless;              // only simulate m_levelToLoad without window, graphics and sound (see HeadlessBenchmark)
+    unsigned int m_headlessTicks; // number of updates to simulate in headless mode
+
     // Initialisationsfunktionen in Init.cpp
     bool initSDL();
     bool initVideo();
@@ -23,7 +23,7 @@ StateManager::~StateManager()
 
 void StateManager::changeState(boost::shared_ptr<GameState> pState)
 {
-    log(Info) << "\n=== Changing State to \"" << pState->getId() << "\" ===\n\n";
+    AA_LOG(Info) << "\n=== Changing State to \"" << pState->getId() << "\" ===\n\n";
 
     // Momentaner State aufräumen und löschen
     if ( !m_states.empty() )
@@ -43,11 +43,11 @@ void StateManager::pushState(boost::shared_ptr<GameState> pState)
     // Momentaner State anhalten
     if ( !m_states.empty() )
     {
-        log(Info) << "\n=== Pausing State \"" << m_states.back()->getId() << "\" ===\n\n";
+        AA_LOG(Info) << "\n=== Pausing State \"" << m_states.back()->getId() << "\" ===\n\n";
         m_states.back()->pause();
     }
 
-    log(Info) << "\n=== Pushing State \"" << pState->getId() << "\" ===\n\n";
+    AA_LOG(Info) << "\n=== Pushing State \"" << pState->getId() << "\" ===\n\n";
     // Neuer State speichern und initialisieren
     m_states.push_back( pState );
     m_states.back()->init();
@@ -59,7 +59,7 @@ void StateManager::popState()
     // Momentaner State aufräumen und löschen
     if ( !m_states.empty() )
     {
-        log(Info) << "\n=== Popping State \"" << m_states.back()->getId() << "\" ===\n\n";
+        AA_LOG(Info) << "\n=== Popping State \"" << m_states.back()->getId() << "\" ===\n\n";
         m_states.back()->cleanup();
         m_states.back()->getSubSystems().isLoading = true;
         m_states.pop_back();
@@ -68,7 +68,7 @@ void StateManager::popState()
     // Voheriger State wiederaufnehmen
     if ( !m_states.empty() )
     {
-        log(Info) << "\n=== Resuming State \"" << m_states.back()->getId() << "\" ===\n\n";
+        AA_LOG(Info) << "\n=== Resuming State \"" << m_states.back()->getId() << "\" ===\n\n";
         m_states.back()->resume();
     }
 }
@@ -78,7 +78,7 @@ void StateManager::clear()
     // Alle States aufräumen
     while ( !m_states.empty() )
     {
-        log(Info) << "\n=== Cleaning up State \"" << m_states.back()->getId() << "\" ===\n\n";
+        AA_LOG(Info) << "\n=== Cleaning up State \"" << m_states.back()->getId() << "\" ===\n\n";
         m_states.back()->cleanup();
         m_states.pop_back();
     }
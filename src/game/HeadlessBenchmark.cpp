@@ -0,0 +1,151 @@
+/*
+ * HeadlessBenchmark.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+#include "HeadlessBenchmark.h"
+
+#include "common/components/CompVariable.h"
+#include "common/Clock.h"
+#include "common/DataLoader.h"
+#include "common/Exception.h"
+#include "common/Foreach.h"
+#include "common/Logger.h"
+#include "common/Profiler.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <boost/bind.hpp>
+
+HeadlessBenchmark::HeadlessBenchmark(const std::string& levelFileName, unsigned int numTicks)
+: m_levelFileName (levelFileName),
+  m_numTicks (numTicks),
+  m_events (),
+  m_input (),
+  m_physics (m_events),
+  m_triggerSys (m_events),
+  m_playerController (m_events, m_input),
+  m_compMgr (m_events),
+  m_eventConnections (),
+  m_entitiesToDelete (),
+  m_currentTick (0),
+  m_levelEndTick (-1),
+  m_levelEndMessage (),
+  m_physicsNs (0),
+  m_playerControllerNs (0),
+  m_triggerSysNs (0),
+  m_deleteEntitiesNs (0)
+{
+    m_eventConnections.add(m_events.wantToDeleteEntity.registerListener( boost::bind( &HeadlessBenchmark::onEntityDeleted, this, _1 ) ));
+    m_eventConnections.add(m_events.levelEnd.registerListener( boost::bind( &HeadlessBenchmark::onLevelEnd, this, _1, _2 ) ));
+}
+
+bool HeadlessBenchmark::run()
+{
+    AA_LOG(Info) << "Headless benchmark: loading '" << m_levelFileName << "'...\n";
+
+    boost::uint64_t loadStart = getMonotonicTimeNs();
+    try
+    {
+        // wie in PlayingState::init()
+        DataLoader::loadToWorld( "data/player.info", m_compMgr, m_events );
+        DataLoader::loadToWorld( m_levelFileName, m_compMgr, m_events );
+    }
+    catch (DataLoadException& e)
+    {
+        AA_LOG(Error) << e.getMsg() << "\n";
+        // stdout is only for the results
+        std::cerr << "Could not load level '" << m_levelFileName << "': " << e.getMsg() << std::endl;
+        return false;
+    }
+
+    CompVariable* varJetpackEnergy = m_compMgr.getComponent<CompVariable>("Player", "JetpackEnergy");
+    CompVariable* varHealth = m_compMgr.getComponent<CompVariable>("Player", "Health");
+    if (varJetpackEnergy && varHealth)
+    {
+        varJetpackEnergy->setValue(1000);
+        varHealth->setValue(1000);
+    }
+    boost::uint64_t loadTimeNs = getMonotonicTimeNs() - loadStart;
+
+    boost::uint64_t runStart = getMonotonicTimeNs();
+    for (m_currentTick = 0; m_currentTick < m_numTicks; ++m_currentTick)
+        update();
+    boost::uint64_t totalTimeNs = getMonotonicTimeNs() - runStart;
+
+    printReport(loadTimeNs, totalTimeNs);
+    return true;
+}
+
+// Entspricht PlayingState::update() ohne RenderSystem
+void HeadlessBenchmark::update()
+{
+    PROFILE_ZONE("UPDATE");
+    boost::uint64_t t0 = getMonotonicTimeNs();
+    m_physics.update();
+    boost::uint64_t t1 = getMonotonicTimeNs();
+    m_playerController.update();
+    boost::uint64_t t2 = getMonotonicTimeNs();
+    m_triggerSys.update();
+    boost::uint64_t t3 = getMonotonicTimeNs();
+
+    std::vector<EntityId> entitiesToDelete;
+    entitiesToDelete.swap(m_entitiesToDelete);
+    foreach(const EntityId& id, entitiesToDelete)
+        m_compMgr.removeEntity(id);
+    boost::uint64_t t4 = getMonotonicTimeNs();
+
+    m_physicsNs += t1 - t0;
+    m_playerControllerNs += t2 - t1;
+    m_triggerSysNs += t3 - t2;
+    m_deleteEntitiesNs += t4 - t3;
+}
+
+void HeadlessBenchmark::onEntityDeleted(const EntityId& entityId)
+{
+    m_entitiesToDelete.push_back(entityId);
+}
+
+void HeadlessBenchmark::onLevelEnd(bool win, const std::string& msg)
+{
+    if (m_levelEndTick != -1)
+        return;
+    m_levelEndTick = (int)m_currentTick;
+    m_levelEndMessage = std::string(win ? "won" : "lost") + " (" + msg + ")";
+}
+
+namespace {
+
+void writeSystemTime(std::ostream& out, const char* name, boost::uint64_t timeNs, unsigned int numTicks, boost::uint64_t totalTimeNs)
+{
+    out << "  " << std::left << std::setw(26) << name << std::right
+        << std::setw(10) << timeNs / 1e6 << " ms"
+        << std::setw(10) << (numTicks ? timeNs / 1e3 / numTicks : 0.0) << " us/tick"
+        << std::setw(7) << (totalTimeNs ? 100.0 * timeNs / totalTimeNs : 0.0) << " %\n";
+}
+
+}
+
+void HeadlessBenchmark::printReport(boost::uint64_t loadTimeNs, boost::uint64_t totalTimeNs) const
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "Headless benchmark of '" << m_levelFileName << "'\n";
+    out << "  entities:                 " << m_compMgr.getAllEntities().size() << "\n";
+    out << "  load time:                " << loadTimeNs / 1e6 << " ms\n";
+    out << "  ticks:                    " << m_numTicks << " (" << m_numTicks * cPhysicsTimeStep << " s game time)\n";
+    out << "  total time:               " << totalTimeNs / 1e6 << " ms\n";
+    out << "  ticks per second:         " << (totalTimeNs ? m_numTicks / (totalTimeNs / 1e9) : 0.0) << "\n";
+    if (m_levelEndTick != -1)
+        out << "  level ended at tick:      " << m_levelEndTick << ", " << m_levelEndMessage << "\n";
+    writeSystemTime(out, "PhysicsSystem::update", m_physicsNs, m_numTicks, totalTimeNs);
+    writeSystemTime(out, "PlayerController::update", m_playerControllerNs, m_numTicks, totalTimeNs);
+    writeSystemTime(out, "TriggerSystem::update", m_triggerSysNs, m_numTicks, totalTimeNs);
+    writeSystemTime(out, "removing entities", m_deleteEntitiesNs, m_numTicks, totalTimeNs);
+
+    std::cout << out.str();
+    std::cout.flush();
+    AA_LOG(Info) << out.str();
+}
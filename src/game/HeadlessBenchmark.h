@@ -0,0 +1,65 @@
+/*
+ * HeadlessBenchmark.h
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Simuliert ein Level ohne Fenster, OpenGL und Sound (--headless), um die Spiellogik zu messen.
+
+#ifndef HEADLESSBENCHMARK_H
+#define HEADLESSBENCHMARK_H
+
+#include "Input.h"
+#include "PlayerController.h"
+
+#include "common/ComponentManager.h"
+#include "common/GameEvents.h"
+#include "common/Physics.h"
+#include "common/TriggerSystem.h"
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+class HeadlessBenchmark
+{
+public:
+    HeadlessBenchmark(const std::string& levelFileName, unsigned int numTicks);
+
+    // Level laden, numTicks Updates (cPhysicsTimeStep) so schnell wie möglich ausführen und
+    // die Zeiten ausgeben. Gibt false zurück, falls das Level nicht geladen werden konnte.
+    bool run();
+
+private:
+    void update();
+    void printReport(boost::uint64_t loadTimeNs, boost::uint64_t totalTimeNs) const;
+
+    void onEntityDeleted(const EntityId& entityId);
+    void onLevelEnd(bool win, const std::string& msg);
+
+    std::string m_levelFileName;
+    unsigned int m_numTicks;
+
+    // Es gibt keinen RenderSystem und SoundSystem: die Simulation braucht sie nicht.
+    GameEvents m_events;
+    InputSubSystem m_input; // wird nie aktualisiert, es sind also keine Tasten gedrückt
+    PhysicsSystem m_physics;
+    TriggerSystem m_triggerSys;
+    PlayerController m_playerController;
+    ComponentManager m_compMgr; // zuletzt, damit die Komponenten vor den Systemen gelöscht werden
+
+    EventConnections m_eventConnections;
+    std::vector<EntityId> m_entitiesToDelete;
+
+    unsigned int m_currentTick;
+    int m_levelEndTick; // -1 falls das Level nicht beendet wurde
+    std::string m_levelEndMessage;
+
+    // Gesamtzeit pro System
+    boost::uint64_t m_physicsNs;
+    boost::uint64_t m_playerControllerNs;
+    boost::uint64_t m_triggerSysNs;
+    boost::uint64_t m_deleteEntitiesNs;
+};
+
+#endif
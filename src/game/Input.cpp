@@ -7,6 +7,7 @@
 #include "Input.h"
 #include "Configuration.h"
 #include "common/Logger.h"
+#include "common/Profiler.h"
 
 InputSubSystem::InputSubSystem() : m_sdlKeyStates ( NULL ),
                                    m_sdlMouseStates ( 0 ),
@@ -53,6 +54,7 @@ InputSubSystem::InputSubSystem() : m_sdlKeyStates ( NULL ),
 // Eingabestatus speichern (Maus und Tastatur)
 void InputSubSystem::update()
 {
+    PROFILE_ZONE("InputSubSystem::update");
     // Eingabe aktualisieren
     m_sdlKeyStates = SDL_GetKeyState( NULL );
     std::set<Key>::iterator next;
@@ -64,20 +66,21 @@ void InputSubSystem::update()
             m_consumedKeys.erase( it );
     }
 
-    if ( !gConfig.get<bool>("FullScreen") )
+    const ConfigSnapshot& config = getConfig();
+    if ( !config.fullScreen )
     {
         int mousePosX;
         int mousePosY;
         m_sdlMouseStates = SDL_GetMouseState( &mousePosX, &mousePosY );
-        m_windowMousePos.x = mousePosX / ( float ) gConfig.get<int>("ScreenWidth");
-        m_windowMousePos.y = mousePosY / ( float ) gConfig.get<int>("ScreenHeight");
+        m_windowMousePos.x = mousePosX / ( float ) config.screenWidth;
+        m_windowMousePos.y = mousePosY / ( float ) config.screenHeight;
     }
     else
     {
         int relMouseX = 0, relMouseY = 0;
         m_sdlMouseStates = SDL_GetRelativeMouseState(&relMouseX, &relMouseY);
-        m_windowMousePos.x += relMouseX * gConfig.get<float>("MouseSensitivity") / gConfig.get<int>("ScreenWidth");
-        m_windowMousePos.y += relMouseY * gConfig.get<float>("MouseSensitivity") / gConfig.get<int>("ScreenHeight");
+        m_windowMousePos.x += relMouseX * config.mouseSensitivity / config.screenWidth;
+        m_windowMousePos.y += relMouseY * config.mouseSensitivity / config.screenHeight;
         if ( m_windowMousePos.x < 0.0f )
             m_windowMousePos.x = 0.0f;
         if ( m_windowMousePos.x > 1.0f )
@@ -103,7 +106,7 @@ bool InputSubSystem::testKey(Key key)
     {
         std::map<Key,SDLKey>::const_iterator i = m_keyMap.find(key);
         if ( i == m_keyMap.end() ) {
-            log(Warning) << "Asking for key <" << key << "> which is not in key map\n";
+            AA_LOG(Warning) << "Asking for key <" << key << "> which is not in key map\n";
             return false;
         }
         if ( !m_sdlKeyStates )
@@ -129,7 +132,7 @@ const Vector2D& InputSubSystem::getMousePos() const
 
 void InputSubSystem::warpMouseToCenter()
 {
-    SDL_WarpMouse((Uint16)(gConfig.get<int>("ScreenWidth")/2), (Uint16)(gConfig.get<int>("ScreenHeight")/2));
+    SDL_WarpMouse((Uint16)(getConfig().screenWidth/2), (Uint16)(getConfig().screenHeight/2));
 }
 
 MouseState InputSubSystem::getMouseStateInArea(const Rect& buttonRect, bool consume)
@@ -35,7 +35,7 @@ const float cMaxZoom = 90000.0f;
 
 // Konstruktor
 InputCameraController::InputCameraController(InputSubSystem& inputSubSystem, RenderSystem& renderSubSystem, ComponentManager& compMgr)
- : CameraController(renderSubSystem, (float(gConfig.get<int>("ScreenWidth")))/gConfig.get<int>("ScreenHeight")),
+ : CameraController(renderSubSystem, (float(getConfig().screenWidth))/getConfig().screenHeight),
    m_inputSubSystem (inputSubSystem),
    m_compManager (compMgr),
    m_isFollowingPlayer ( false ),
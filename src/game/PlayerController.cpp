@@ -20,6 +20,7 @@
 #include "common/GameEvents.h"
 #include "common/Vector2D.h"
 #include "common/Logger.h"
+#include "common/Profiler.h"
 
 namespace
 {
@@ -52,20 +53,21 @@ void PlayerController::onRegisterComponent(Component& component)
 
 void PlayerController::update()
 {
+    PROFILE_ZONE("PlayerController::update");
     if (m_compPlayerContrl == NULL)
         return;
 
     // Physikkomponente vom Spieler suchen, damit wir Kräfte an ihm ausüben können
-    CompPhysics* playerCompPhysics = m_compPlayerContrl->getSiblingComponent<CompPhysics>();
+    CompPhysics* playerCompPhysics = m_compPlayerContrl->m_compPhysics;
     if ( playerCompPhysics == NULL )
     {
-        log(Warning) << "entity '" << m_compPlayerContrl->getEntityId() << "' has component CompPlayerController but no CompPhysics\n";
+        AA_LOG(Warning) << "entity '" << m_compPlayerContrl->getEntityId() << "' has component CompPlayerController but no CompPhysics\n";
         return; // keine Physikkomponente, also abbrechen
     }
-    CompPosition* playerCompPos = m_compPlayerContrl->getSiblingComponent<CompPosition>();
+    CompPosition* playerCompPos = m_compPlayerContrl->m_compPosition;
     if ( playerCompPos == NULL )
     {
-        log(Warning) << "entity '" << m_compPlayerContrl->getEntityId() << "' has component CompPlayerController but no CompPosition\n";
+        AA_LOG(Warning) << "entity '" << m_compPlayerContrl->getEntityId() << "' has component CompPlayerController but no CompPosition\n";
         return;
     }
 
@@ -269,7 +271,7 @@ void PlayerController::update()
     const float steepness_compensation = 800.0f; // je grösser, desto besser kann der Astronaut steile hänge laufen
                                           // und desto langsamer abhänge hinunterlaufen
 
-    CompVariable* jetpackVar = m_compPlayerContrl->getSiblingComponent<CompVariable>("JetpackEnergy");
+    CompVariable* jetpackVar = m_compPlayerContrl->m_jetpackEnergy;
     // Jetpack nach oben
     if ( m_inputSubSystem.isKeyDown(Up, false) && jetpackVar->getValue() > 0 && (m_compPlayerContrl->m_rechargeTime==cMaxRecharge || !isTouchingSth ) )
     {
@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <string>
+#include <cstdlib>
 
 namespace {
 const std::string cConfigFileName = "data/config.info";
@@ -25,10 +26,13 @@ int main ( int argc, char* argv[] )
     std::vector<std::string> args (argv+1, argv+argc);
 
     loadConfig(cConfigFileName, gConfig);
+    applyConfig();
     setUpLoggerFromPropTree(gConfig);
 
     putenv(const_cast<char*>("SDL_VIDEO_CENTERED=1"));
 
+    int exitCode = EXIT_SUCCESS;
+
 #ifdef CATCH_EXCEPTION
     try
 #endif
@@ -37,14 +41,15 @@ int main ( int argc, char* argv[] )
         do
         {
             restart = false;
-            log(Info).writeHeader(GAME_NAME " " GAME_VERSION);
+            AA_LOG(Info).writeHeader(GAME_NAME " " GAME_VERSION);
 
             GameApp aaApp(args);
-            aaApp.run();
+            if (!aaApp.run())
+                exitCode = EXIT_FAILURE;
 
             if ( aaApp.doRestart() )
             {
-                log(Info) << "\n\n============= Restarting " GAME_NAME " =============\n\n";
+                AA_LOG(Info) << "\n\n============= Restarting " GAME_NAME " =============\n\n";
                 restart = true;
             }
 
@@ -55,16 +60,19 @@ int main ( int argc, char* argv[] )
 #ifdef CATCH_EXCEPTION
     catch ( Exception& e )
     {
-        log(Fatal) << e.getMsg() << "\n";
+        AA_LOG(Fatal) << e.getMsg() << "\n";
         OsMsgBox(e.getMsg(), "Exception");
+        exitCode = EXIT_FAILURE;
     }
     catch ( std::bad_alloc& )
     {
-        log(Fatal) << "Error: Memory could not be allocated!\n";
+        AA_LOG(Fatal) << "Error: Memory could not be allocated!\n";
+        exitCode = EXIT_FAILURE;
     }
     catch ( std::exception& e )
     {
-        log(Fatal) << e.what() << "\n";
+        AA_LOG(Fatal) << e.what() << "\n";
+        exitCode = EXIT_FAILURE;
     }
     catch (...)
     {
@@ -74,5 +82,5 @@ int main ( int argc, char* argv[] )
 
     writeConfig(cConfigFileName, gConfig);
 
-    return 0;
+    return exitCode;
 }
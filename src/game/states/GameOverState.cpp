@@ -18,10 +18,13 @@
 // eindeutige ID
 const GameStateId GameOverState::STATE_ID = "GameOverState";
 
-GameOverState::GameOverState( SubSystems& subSystems, const std::string& stringToShow, const std::string& levelFileName )
+GameOverState::GameOverState( SubSystems& subSystems, const std::string& stringToShow, const std::string& levelFileName,
+                              const boost::shared_ptr<const LevelSnapshot>& levelSnapshot )
 : GameState( subSystems ),
   m_stringToShow ( stringToShow ),
-  m_levelFileName ( levelFileName )
+  m_levelFileName ( levelFileName ),
+  m_levelSnapshot ( levelSnapshot ),
+  m_restart ( false )
 {
 }
 
@@ -33,6 +36,9 @@ void GameOverState::init()
 
 void GameOverState::cleanup()
 {
+    // PlayingState hat die Musik für einen Neustart geladen gelassen (z.B. nicht bei ESC ins Menü)
+    if ( !m_restart )
+        getSubSystems().sound.freeMusic( "music" );
 }
 
 void GameOverState::pause()
@@ -47,7 +53,8 @@ void GameOverState::update()
 {
     if ( getSubSystems().input.isKeyDown(Enter) )
     {
-        boost::shared_ptr<PlayingState> playState (new PlayingState(getSubSystems(), m_levelFileName)); // Zum Spiel-Stadium wechseln
+        boost::shared_ptr<PlayingState> playState (new PlayingState(getSubSystems(), m_levelFileName, m_levelSnapshot)); // Zum Spiel-Stadium wechseln
+        m_restart = m_levelSnapshot.get() != NULL;
         getSubSystems().stateManager.changeState( playState );
         return;
     }
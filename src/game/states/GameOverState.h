@@ -11,6 +11,9 @@
 
 #include "game/GameState.h"
 #include <string>
+#include <boost/shared_ptr.hpp>
+
+class LevelSnapshot;
 
 const float cBackgroundColor[3] = { 0.3f, 0.1f, 0.2f };
 
@@ -20,7 +23,9 @@ const float cBackgroundColor[3] = { 0.3f, 0.1f, 0.2f };
 class GameOverState : public GameState
 {
 public:
-    GameOverState( SubSystems& subSystems, const std::string& stringToShow, const std::string& levelFileName );
+    // levelSnapshot: to play again without loading the level file (can be NULL)
+    GameOverState( SubSystems& subSystems, const std::string& stringToShow, const std::string& levelFileName,
+                   const boost::shared_ptr<const LevelSnapshot>& levelSnapshot );
 
     const GameStateId& getId() const { return STATE_ID; }
 
@@ -38,6 +43,8 @@ private:
 
     std::string m_stringToShow;
     std::string m_levelFileName;
+    boost::shared_ptr<const LevelSnapshot> m_levelSnapshot;
+    bool m_restart; // die Musik von PlayingState bleibt geladen
 };
 
 #endif
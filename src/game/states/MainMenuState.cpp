@@ -69,11 +69,11 @@ void MainMenuState::init()        // State starten
 {
     using boost::make_shared;
 
-    log(Info) << "Loading menu... ";
+    AA_LOG(Info) << "Loading menu... ";
     //GetSubSystems().renderer.DisplayLoadingScreen();
     
     // Grafiken aus XML-Datei laden
-    m_menuResources = DataLoader::loadGraphics(cMenuGraphicsFileName, &getSubSystems().renderer.getTextureManager(), NULL, NULL, (TexQuality) gConfig.get<int>("TexQuality"));
+    m_menuResources = DataLoader::loadGraphics(cMenuGraphicsFileName, &getSubSystems().renderer.getTextureManager(), NULL, NULL, (TexQuality) getConfig().texQuality);
 
     getSubSystems().sound.loadMusic( "data/Music/ParagonX9___Chaoz_C.ogg", "menuMusic" );
     getSubSystems().sound.loadSound( "data/Sounds/Single click stab with delay_Nightingale Music Productions_12046.wav", "mouseclick" );
@@ -122,7 +122,7 @@ void MainMenuState::init()        // State starten
     pugi::xml_parse_result result = doc.load_file(cLevelSequenceFileName.c_str());
     if (!result)
     {
-        log(Error) << "[ Error parsing file '" << cLevelSequenceFileName << "' at offset " << result.offset << "!\nError description: " << result.description() << " ]\n\n";
+        AA_LOG(Error) << "[ Error parsing file '" << cLevelSequenceFileName << "' at offset " << result.offset << "!\nError description: " << result.description() << " ]\n\n";
         return;
     }
 
@@ -197,7 +197,7 @@ void MainMenuState::init()        // State starten
     getSubSystems().gui.addWidget( menuNames[Options], make_shared<WidgetButton>( Rect(x,x+w,y,y+h), "1280x1024", boost::bind( &MainMenuState::onPressedResolution, this, 1280, 1024 ), boost::bind( &MainMenuState::onPressedSound, this ) ) );
 
     
-    log(Info) << "[ Done ]\n";
+    AA_LOG(Info) << "[ Done ]\n";
 }
 
 void MainMenuState::cleanup()     // State abbrechen
@@ -304,7 +304,7 @@ void MainMenuState::draw( float /*accumulator*/ )        // Spiel zeichnen
                               1.0f, 1.0f,
                               1.0f, 0.0f };
 
-        float aspectRatio = (float(gConfig.get<int>("ScreenWidth")))/gConfig.get<int>("ScreenHeight");
+        float aspectRatio = (float(getConfig().screenWidth))/getConfig().screenHeight;
 
         float w = 0.035;
         float h = 0.035f * aspectRatio;
@@ -390,6 +390,7 @@ void MainMenuState::onPressedButApplyConfig()
     {
         gConfig.put("ScreenWidth", m_newWidth);
         gConfig.put("ScreenHeight", m_newHeight);
+        applyConfig();
         m_restart = true;
         m_wantToQuit = true;
     }
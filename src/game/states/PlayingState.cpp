@@ -17,6 +17,8 @@
 #include "common/Logger.h"
 #include "common/GameEvents.h"
 #include "common/DataLoader.h"
+#include "common/LevelLoader.h"
+#include "common/LevelSnapshot.h"
 #include "common/Sound.h"
 #include "common/Vector2D.h"
 #include "common/Renderer.h"
@@ -24,9 +26,9 @@
 #include "common/Foreach.h"
 
 #include <sstream>
+#include <fstream>
 #include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
-#include <boost/make_shared.hpp>
 
 // define this to draw gravitation vector and other
 //#define DRAW_DEBUG
@@ -40,38 +42,86 @@
 // Alle Entities in der Welt werden in dieser Datei aufgelistet
 const std::string cWordLogFileName = "world.txt";
 
+// Zeit pro Frame, in der geladene Entities registriert werden (damit das Fenster reagiert)
+const boost::uint64_t cLoadCommitTimePerFrameNs = 4000000;
+
 const GameStateId PlayingState::STATE_ID = "PlayingState";
 
-PlayingState::PlayingState( SubSystems& subSystems, const std::string& levelFileName )
+PlayingState::PlayingState( SubSystems& subSystems, const std::string& levelFileName,
+                            const boost::shared_ptr<const LevelSnapshot>& levelSnapshot )
 : GameState( subSystems ),
   m_compMgr ( getSubSystems().events ),
   m_cameraController ( getSubSystems().input, getSubSystems().renderer, m_compMgr ),
   m_eventConnection1 (), m_eventConnection2 (),
-  m_curentDeleteSet (1), m_wantToEndGame( false ), m_alphaOverlay( 0.0 ),
-  m_levelFileName ( levelFileName )
+  m_curentDeleteSet (1), m_wantToEndGame( false ), m_alphaOverlay( 0.0 ), m_keepMusic( false ),
+  m_levelFileName ( levelFileName ), m_levelLoader (), m_levelSnapshot ( levelSnapshot ), m_resources ()
 {}
 
-void PlayingState::init()        // State starten
+// hier definiert, weil LevelLoader im Header nur deklariert ist
+PlayingState::~PlayingState()
 {
-    //getSubSystems().renderer.displayLoadingScreen();
-
-    log(Info) << "Loading world...\n\n";
+}
 
-    try
+void PlayingState::init()        // State starten
+{
+    if ( m_levelSnapshot )
     {
-        // Welt von XML-Datei laden
-        DataLoader::loadToWorld( "data/player.info", m_compMgr, getSubSystems().events );
-        DataLoader::loadToWorld( m_levelFileName, m_compMgr, getSubSystems().events );
+        // Neustart: ohne Dateien und ohne Ladebalken
+        AA_LOG(Info) << "Restoring world from snapshot (" << m_levelSnapshot->getNumEntities() << " entities)...\n";
+        m_levelSnapshot->restore( m_compMgr, getSubSystems().events );
+        AA_LOG(Info) << "[ Done ]\n\n";
+        finishLoading();
+        return;
     }
-    catch (DataLoadException& e)
+
+    AA_LOG(Info) << "Loading world...\n\n";
+
+    // Welt von INFO-Dateien laden
+    std::vector<std::string> fileNames;
+    fileNames.push_back( "data/player.info" );
+    fileNames.push_back( m_levelFileName );
+    m_levelLoader.reset( new LevelLoader(fileNames, getSubSystems().events) );
+}
+
+// Im Hauptthread pro Frame aufgerufen, solange geladen wird
+void PlayingState::updateLoading()
+{
+    if ( !m_levelLoader->isLoaded() )
+        return;
+
+    if ( m_levelLoader->hasFailed() )
     {
         // TODO show error in game
-        log(Error) << e.getMsg() << "\n";
+        AA_LOG(Error) << m_levelLoader->getErrorMsg() << "\n";
+        m_levelLoader.reset();
         boost::shared_ptr<MainMenuState> menuState (new MainMenuState(getSubSystems()));
         getSubSystems().stateManager.changeState(menuState);
         return;
     }
 
+    if ( m_levelLoader->commit( m_compMgr, cLoadCommitTimePerFrameNs ) )
+    {
+        m_levelLoader.reset();
+
+        // Alle Entities und Komponenten in Text Datei anzeigen
+        std::ofstream worldLog (cWordLogFileName.c_str());
+        worldLog << "World Entities:\n\n";
+        m_compMgr.writeEntities(worldLog);
+
+        // vor dem ersten Update, damit ein Neustart wieder genau diesen Zustand hat
+        m_levelSnapshot.reset( new LevelSnapshot( m_compMgr ) );
+        AA_LOG(Info) << "Level snapshot: " << m_levelSnapshot->getSize() / 1024 << " KiB\n";
+
+        finishLoading();
+    }
+}
+
+void PlayingState::finishLoading()
+{
+    // nur die Grafiken laden, die das Level braucht
+    m_resources = DataLoader::getUsedGraphics(m_compMgr);
+    getSubSystems().renderer.acquireResources(m_resources);
+
     CompVariable* varJetpackEnergy = m_compMgr.getComponent<CompVariable>("Player", "JetpackEnergy");
     CompVariable* varHealth = m_compMgr.getComponent<CompVariable>("Player", "Health");
     if (varJetpackEnergy && varHealth) {
@@ -79,24 +129,19 @@ void PlayingState::init()        // State starten
         varHealth->setValue(1000);
     }
     else {
-        log(Error) << "Missing 'JetpackEnergy' or 'Health' CompVariable in Player" << "\n";
+        AA_LOG(Error) << "Missing 'JetpackEnergy' or 'Health' CompVariable in Player" << "\n";
         // TODO: show error
         boost::shared_ptr<MainMenuState> menuState (new MainMenuState(getSubSystems()));
         getSubSystems().stateManager.changeState(menuState);
         return;
     }
 
-    getSubSystems().sound.loadMusic( "data/Music/Aerospace.ogg", "music" );
+    // nach einem Neustart ist die Musik noch geladen (siehe cleanup())
+    if ( !getSubSystems().sound.isMusicLoaded( "music" ) )
+        getSubSystems().sound.loadMusic( "data/Music/Aerospace.ogg", "music" );
     getSubSystems().sound.playMusic( "music", true, 0 );
 
-    log(Info) << "[ Done loading world ]\n\n";
-
-    // Alle Entities und Komponenten in Text Datei anzeigen
-    Logger logger(true);
-    boost::shared_ptr<FileHandler> fileHandler = boost::make_shared<FileHandler>(cWordLogFileName);
-    logger.addHandler(fileHandler);
-    logger << "World Entities:\n\n";
-    m_compMgr.writeEntitiesToLogger(logger, Info);
+    AA_LOG(Info) << "[ Done loading world ]\n\n";
 
     getSubSystems().input.warpMouseToCenter();
 
@@ -104,13 +149,20 @@ void PlayingState::init()        // State starten
 
     m_eventConnection1 = getSubSystems().events.wantToDeleteEntity.registerListener( boost::bind( &PlayingState::onEntityDeleted, this, _1 ) );
     m_eventConnection2 = getSubSystems().events.levelEnd.registerListener( boost::bind( &PlayingState::onLevelEnd, this, _1, _2 ) );
+
+    getSubSystems().isLoading = true; // Zeitakkumulator neu starten
 }
 
 void PlayingState::cleanup()     // State abbrechen
 {
+    m_levelLoader.reset();
+    getSubSystems().renderer.releaseResources(m_resources);
+    m_resources = ResourceIds();
 
     getSubSystems().sound.stopMusic( 500 );
-    getSubSystems().sound.freeMusic( "music" );
+    // GameOverState kann das Level vom Snapshot neu starten, dann wird die Musik gleich wieder gebraucht
+    if ( !m_keepMusic )
+        getSubSystems().sound.freeMusic( "music" );
 }
 
 void PlayingState::pause()       // State anhalten
@@ -124,16 +176,25 @@ void PlayingState::resume()      // State wiederaufnehmen
 void PlayingState::frame( float deltaTime )
 {
     getSubSystems().input.update();   // neue Eingaben lesen
+    if ( m_levelLoader )
+    {
+        updateLoading();
+        return;
+    }
     m_cameraController.update( deltaTime ); // Kamera updaten
 }
 
 void PlayingState::update()      // Spiel aktualisieren
 {
+    if ( m_levelLoader )
+        return;
+
     if ( m_wantToEndGame )
     {
         if ( m_alphaOverlay > 1.0f )
         {
-            boost::shared_ptr<GameOverState> gameOverStateState( new GameOverState(getSubSystems(), m_gameOverMessage, m_levelFileName) );
+            boost::shared_ptr<GameOverState> gameOverStateState( new GameOverState(getSubSystems(), m_gameOverMessage, m_levelFileName, m_levelSnapshot) );
+            m_keepMusic = m_levelSnapshot.get() != NULL; // GameOverState gibt sie frei, falls nicht neu gestartet wird
             getSubSystems().stateManager.changeState( gameOverStateState );
             return;
         }
@@ -168,6 +229,12 @@ void PlayingState::update()      // Spiel aktualisieren
 
 void PlayingState::draw( float accumulator )        // Spiel zeichnen
 {
+    if ( m_levelLoader )
+    {
+        drawLoadingScreen();
+        return;
+    }
+
     // maybe put this in PhysicsSubSystem::Update
     // (then the physics subsystem would need an accumulator for itself)
     getSubSystems().physics.calculateSmoothPositions(accumulator);
@@ -228,6 +295,16 @@ void PlayingState::draw( float accumulator )        // Spiel zeichnen
     // Texte zeichnen
     renderer.drawVisualMessageComps();
 
+#ifdef DRAW_DEBUG
+    {
+        // Culling: sichtbare / alle Komponenten
+        std::ostringstream oss;
+        oss << "tex " << renderer.getNumVisibleTextureComps() << "/" << renderer.getNumTextureComps()
+            << "  anim " << renderer.getNumVisibleAnimationComps() << "/" << renderer.getNumAnimationComps();
+        renderer.drawString( oss.str(), "FontW_s", 3.95f, 0.1f, AlignRight, AlignTop );
+    }
+#endif
+
     // Jetpack %-display
     {
         float x = 0.11f, y = 0.04f;
@@ -275,6 +352,36 @@ void PlayingState::draw( float accumulator )        // Spiel zeichnen
     //renderer.FlipBuffer(); // (vom Backbuffer zum Frontbuffer wechseln)
 }
 
+void PlayingState::drawLoadingScreen()
+{
+    RenderSystem& renderer = getSubSystems().renderer;
+    renderer.setMatrix(RenderSystem::GUI);
+    {
+        float texCoord[8] = { 0.0f, 0.0f,
+                              0.0f, 1.0f,
+                              1.0f, 1.0f,
+                              1.0f, 0.0f };
+        float* const & vertexCoord = texCoord;
+        renderer.drawTexturedQuad( texCoord, vertexCoord, "_starfield" ); // sky
+    }
+
+    renderer.drawString( "Loading...", "FontW_m", 0.5f, 0.45f, AlignCenter, AlignCenter, 1.0f, 1.0f, 1.0f, 1.0f );
+
+    // Ladebalken
+    float x = 0.3f, y = 0.52f, w = 0.4f, h = 0.02f;
+    float progress = m_levelLoader->getProgress();
+    float frameCoord[8] = { x, y-h,
+                            x, y+h,
+                            x+w, y+h,
+                            x+w, y-h };
+    renderer.drawColorQuad( frameCoord, 0.2f, 0.2f, 0.2f, 0.6f, true );
+    float barCoord[8] = { x, y-h,
+                          x, y+h,
+                          x + progress * w, y+h,
+                          x + progress * w, y-h };
+    renderer.drawColorQuad( barCoord, 0.2f, 0.9f, 0.3f, 0.6f );
+}
+
 void PlayingState::onEntityDeleted( const EntityId& entityId )
 {
     if ( m_curentDeleteSet == 1 )
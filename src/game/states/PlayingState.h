@@ -16,11 +16,16 @@
 
 #include "common/GameEvents.h"
 #include "common/ComponentManager.h"
+#include "common/DataLoader.h"
 
 #include <set>
 #include <string>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 class EventConnection;
+class LevelLoader;
+class LevelSnapshot;
 
 //--------------------------------------------//
 //----------- PlayingState Klasse ------------//
@@ -28,7 +33,10 @@ class EventConnection;
 class PlayingState : public GameState
 {
 public:
-    PlayingState( SubSystems& subSystems, const std::string& levelFileName );
+    // with a levelSnapshot (of the same level) the files are not loaded again
+    PlayingState( SubSystems& subSystems, const std::string& levelFileName,
+                  const boost::shared_ptr<const LevelSnapshot>& levelSnapshot = boost::shared_ptr<const LevelSnapshot>() );
+    ~PlayingState();
 
     const GameStateId& getId() const { return STATE_ID; }
 
@@ -43,7 +51,12 @@ public:
     void draw( float accumulator );        // Spiel zeichnen
 private:
     static const GameStateId STATE_ID;
-    
+
+    // das Level wird im Hintergrund geladen (m_levelLoader), bis dahin wird ein Ladebalken gezeigt
+    void updateLoading();
+    void finishLoading();
+    void drawLoadingScreen();
+
     ComponentManager m_compMgr;
     InputCameraController m_cameraController;        // Kamera
 
@@ -57,9 +70,13 @@ private:
 
     bool m_wantToEndGame;
     float m_alphaOverlay;
+    bool m_keepMusic; // nur beim Wechsel zu GameOverState (mit Snapshot)
     std::string m_gameOverMessage;
 
     std::string m_levelFileName;
+    boost::scoped_ptr<LevelLoader> m_levelLoader; // NULL wenn fertig geladen
+    boost::shared_ptr<const LevelSnapshot> m_levelSnapshot; // Welt direkt nach dem Laden, für einen Neustart
+    ResourceIds m_resources;                      // Texturen und Animationen des Levels (vom RenderSystem)
 };
 
 #endif
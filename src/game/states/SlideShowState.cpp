@@ -16,6 +16,7 @@
 #include "common/Logger.h"
 #include "common/Vector2D.h"
 #include "common/Texture.h"
+#include "common/TextureDecoder.h"
 #include "common/Sound.h"
 #include "common/DataLoader.h"
 #include "common/Foreach.h"
@@ -55,7 +56,7 @@ SlideShowState::SlideShowState( SubSystems& subSystems, const std::string& slide
 
 void SlideShowState::init()        // State starten
 {
-    log(Info) << "Loading slide show...";
+    AA_LOG(Info) << "Loading slide show...";
     //GetSubSystems().renderer.displayLoadingScreen();
     //GetSubSystems().renderer.displayTextScreen("p l e a s e    w a i t");
 
@@ -68,7 +69,7 @@ void SlideShowState::init()        // State starten
     {
         // TODO is this a good thing to do?
         // TODO show error
-        log(Error) << "Error loading file : " << e.getMsg() << "\n";
+        AA_LOG(Error) << "Error loading file : " << e.getMsg() << "\n";
         boost::shared_ptr<MainMenuState> menuState (new MainMenuState(getSubSystems()));
         getSubSystems().stateManager.changeState(menuState);
         return;
@@ -80,11 +81,13 @@ void SlideShowState::init()        // State starten
     info.wrapModeX = WrapClamp;
     info.wrapModeY = WrapClamp;
     info.scale = 1.0;
-    info.quality = (TexQuality) gConfig.get<int>("TexQuality");
+    info.quality = (TexQuality) getConfig().texQuality;
+    std::vector<DecodedTexture> textures;
     for ( size_t i = 0; i < m_slideShow.slides.size(); ++i ) {
-        getSubSystems().renderer.getTextureManager().loadTexture( m_slideShow.slides[i].imageFileName, m_slideShow.slides[i].imageFileName, info );
+        textures.push_back(DecodedTexture(m_slideShow.slides[i].imageFileName, m_slideShow.slides[i].imageFileName, info));
         m_loadedTextures.push_back(m_slideShow.slides[i].imageFileName);
     }
+    getSubSystems().renderer.getTextureManager().loadTextures(textures); // dekodiert die Bilder parallel
     
     // GUI modus
     getSubSystems().renderer.setMatrix(RenderSystem::GUI);
@@ -98,7 +101,7 @@ void SlideShowState::init()        // State starten
 
     getSubSystems().sound.playMusic( "slideShowMusic", true, 0 );
 
-    log(Info) << "[ Done ]\n";
+    AA_LOG(Info) << "[ Done ]\n";
 }
 
 void SlideShowState::cleanup()
@@ -299,7 +302,7 @@ void SlideShowState::loadSlideShow()
         using boost::shared_ptr;
         using boost::make_shared;
 
-        log(Info) << "Loading slide show file \"" << m_slideDataFile << "\"...\n";
+        AA_LOG(Info) << "Loading slide show file \"" << m_slideDataFile << "\"...\n";
 
         ptree propTree;
         read_info(m_slideDataFile, propTree);
@@ -328,7 +331,7 @@ void SlideShowState::loadSlideShow()
             }
         }
 
-        log(Info) << "[ Done ]\n\n";
+        AA_LOG(Info) << "[ Done ]\n\n";
     }
     catch (boost::property_tree::ptree_error& e)
     {
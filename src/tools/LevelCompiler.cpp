@@ -0,0 +1,42 @@
+/*
+ * LevelCompiler.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Konvertiert .lvl Dateien in das binäre Format (.lvlb), welches schneller geladen wird.
+// Usage: AALevelCompiler data/Levels/*.lvl
+
+#include "common/BinaryLevel.h"
+#include "common/DataLoader.h"
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " LEVEL.lvl...\n"
+                  << "Writes LEVEL.lvlb next to each level file.\n";
+        return 1;
+    }
+
+    int numErrors = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string textFileName = argv[i];
+        std::string binaryFileName = BinaryLevel::getBinaryFileName(textFileName);
+        try
+        {
+            DataLoader::compileWorld(textFileName, binaryFileName);
+            std::cout << textFileName << " -> " << binaryFileName << "\n";
+        }
+        catch (DataLoadException& e)
+        {
+            std::cerr << e.getMsg() << "\n";
+            ++numErrors;
+        }
+    }
+    return numErrors == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/*
+ * TextureBaker.cpp
+ * This file is part of Astro Attack
+ * Copyright (c) 2014 Christian Zommerfelds
+ */
+
+// Bereitet alle Texturen und Animationen für jede Qualitätsstufe vor (skaliert, mit Mipmaps)
+// und speichert sie im TextureCache, damit das Spiel sie direkt hochladen kann.
+// Usage: AABake [-q QUALITY]... [GRAPHICS.info...]
+
+#include "common/DataLoader.h"
+#include "common/Foreach.h"
+#include "common/Texture.h"
+#include "common/TextureCache.h"
+#include "common/TextureDecoder.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include <IL/il.h>
+#include <IL/ilu.h>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/info_parser.hpp>
+
+using boost::property_tree::ptree;
+
+namespace {
+
+// grösser als GL_MAX_TEXTURE_SIZE, zu grosse Mipmap-Stufen lässt das Spiel beim Laden weg
+const int cBakeMaxSize = 16384;
+
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [-q QUALITY]... [GRAPHICS.info...]\n"
+              << "Bakes the textures and animations of data/graphics.info and data/graphicsMenu.info\n"
+              << "(or the given files) for all quality levels (or only the given ones, 0 = best) into\n"
+              << cTextureCacheFile << " and " << cTextureCacheManifest << ".\n";
+}
+
+// Bilddateien der Texturen und Animationen aus einer Grafik-Ressourcendatei (wie DataLoader::loadGraphics)
+void collectSourceFiles(const std::string& fileName, std::set<std::string>& textureFiles, std::set<std::string>& frameFiles)
+{
+    ptree propTree;
+    try
+    {
+        read_info(fileName, propTree);
+        foreach (const ptree::value_type& value, propTree)
+        {
+            if (value.first == "texture")
+                textureFiles.insert(value.second.get<std::string>("file"));
+            else if (value.first == "animation")
+            {
+                std::vector<std::string> frames = AnimationManager::getFrameFileNames(value.second.get<std::string>("file"));
+                frameFiles.insert(frames.begin(), frames.end());
+            }
+        }
+    }
+    catch (boost::property_tree::ptree_error& e)
+    {
+        throw DataLoadException(e.what());
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<TexQuality> qualities;
+    std::vector<std::string> graphicsFiles;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "-q" && i + 1 < argc)
+        {
+            int quality = std::atoi(argv[++i]);
+            if (quality < QualityBest || quality > QualityLowest)
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+            qualities.push_back((TexQuality)quality);
+        }
+        else if (arg[0] == '-')
+        {
+            printUsage(argv[0]);
+            return (arg == "-h" || arg == "--help") ? 0 : 1;
+        }
+        else
+            graphicsFiles.push_back(arg);
+    }
+    if (qualities.empty())
+        for (int q = QualityBest; q <= QualityLowest; ++q)
+            qualities.push_back((TexQuality)q);
+    if (graphicsFiles.empty())
+    {
+        graphicsFiles.push_back("data/graphics.info");
+        graphicsFiles.push_back("data/graphicsMenu.info");
+    }
+
+    ilInit();
+    iluInit();
+
+    int numErrors = 0;
+    try
+    {
+        std::set<std::string> textureFiles;
+        std::set<std::string> frameFiles;
+        foreach (const std::string& fileName, graphicsFiles)
+            collectSourceFiles(fileName, textureFiles, frameFiles);
+
+        TextureCacheWriter writer (cTextureCacheManifest, cTextureCacheFile);
+        foreach (TexQuality quality, qualities)
+        {
+            std::cout << "Quality " << (int)quality << ": " << textureFiles.size() << " textures, " << frameFiles.size() << " animation frames\n";
+
+            LoadTextureInfo info;
+            info.loadMipmaps = true; // ohne Mipmaps wird beim Laden nur die erste Stufe verwendet
+            info.wrapModeX = WrapClamp;
+            info.wrapModeY = WrapClamp;
+            info.quality = quality;
+            info.scale = 1.0f;
+
+            std::vector<DecodedTexture> textures;
+            foreach (const std::string& fileName, textureFiles)
+                textures.push_back(DecodedTexture(fileName, fileName, info));
+
+            TextureDecoder decoder (textures, cBakeMaxSize);
+            for (size_t i = 0; i < textures.size(); ++i)
+            {
+                DecodedTexture& texture = decoder.waitFor(i);
+                boost::uint64_t hash = 0;
+                if (!texture.success || !TextureCache::hashFile(texture.fileName, hash))
+                {
+                    std::cerr << "Could not load \"" << texture.fileName << "\": " << texture.errorMsg << "\n";
+                    ++numErrors;
+                    continue;
+                }
+                writer.add(texture.fileName, hash, TextureCache::KindTexture, quality, texture.levels, texture.originalWidth, texture.originalHeight);
+                texture.levels.clear();
+            }
+
+            foreach (const std::string& fileName, frameFiles)
+            {
+                std::vector<RgbaImage> levels (1);
+                std::string errorMsg;
+                boost::uint64_t hash = 0;
+                if (!decodeAnimFrame(fileName, quality, levels[0], errorMsg) || !TextureCache::hashFile(fileName, hash))
+                {
+                    std::cerr << "Could not load \"" << fileName << "\": " << errorMsg << "\n";
+                    ++numErrors;
+                    continue;
+                }
+                // die Originalgrösse wird für Animationen nicht gebraucht
+                writer.add(fileName, hash, TextureCache::KindAnimFrame, quality, levels, levels[0].width, levels[0].height);
+            }
+        }
+        writer.finish();
+        std::cout << "Wrote " << writer.getNumEntries() << " images (" << writer.getDataSize() / (1024 * 1024) << " MiB) to "
+                  << cTextureCacheFile << "\n";
+    }
+    catch (DataLoadException& e)
+    {
+        std::cerr << e.getMsg() << "\n";
+        return 1;
+    }
+    return numErrors == 0 ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "common/Aabb.h"
+
+TEST(AabbTest, EmptyBoxIntersectsNothing)
+{
+    Aabb empty;
+    Aabb box (Vector2D(-1, -1), Vector2D(1, 1));
+    EXPECT_TRUE(empty.isEmpty());
+    EXPECT_FALSE(empty.intersects(box));
+    EXPECT_FALSE(box.intersects(empty));
+
+    empty.extend(Vector2D(2, 3));
+    EXPECT_FALSE(empty.isEmpty());
+    EXPECT_TRUE(empty.contains(Vector2D(2, 3)));
+}
+
+TEST(AabbTest, Intersects)
+{
+    Aabb box (Vector2D(0, 0), Vector2D(2, 1));
+    EXPECT_TRUE(box.intersects(Aabb(Vector2D(1, 0.5f), Vector2D(5, 5))));
+    EXPECT_TRUE(box.intersects(Aabb(Vector2D(2, 1), Vector2D(3, 3)))); // touching
+    EXPECT_FALSE(box.intersects(Aabb(Vector2D(2.1f, 0), Vector2D(3, 1))));
+    EXPECT_FALSE(box.intersects(Aabb(Vector2D(0, -2), Vector2D(2, -0.1f))));
+}
+
+// the transformed box contains all transformed corners (like BatchTransform)
+TEST(AabbTest, TransformedContainsRotatedCorners)
+{
+    Aabb box (Vector2D(1, 0), Vector2D(3, 1));
+    Aabb rotated = box.transformed(Vector2D(10, 5), cPi / 2);
+
+    // (1,0) -> (0,1), (3,1) -> (-1,3)
+    EXPECT_NEAR(9.0f, rotated.lower.x, 1e-5f);
+    EXPECT_NEAR(6.0f, rotated.lower.y, 1e-5f);
+    EXPECT_NEAR(10.0f, rotated.upper.x, 1e-5f);
+    EXPECT_NEAR(8.0f, rotated.upper.y, 1e-5f);
+
+    Aabb diagonal = Aabb(Vector2D(-1, -1), Vector2D(1, 1)).transformed(Vector2D(), cPi / 4);
+    EXPECT_NEAR(std::sqrt(2.0f), diagonal.upper.x, 1e-5f);
+    EXPECT_NEAR(-std::sqrt(2.0f), diagonal.lower.y, 1e-5f);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+
+#include "common/Event.h"
+#include "common/GameEvents.h"
+
+namespace {
+
+void add(int* sum, int val) { *sum += val; }
+
+}
+
+TEST(EventTest, ListenerIsRemovedWithItsConnection)
+{
+    Event1<int> event;
+    int sum = 0;
+    {
+        EventConnection connection = event.registerListener(boost::bind(&add, &sum, _1));
+        event.fire(1);
+    }
+    event.fire(1);
+    EXPECT_EQ(1, sum);
+}
+
+TEST(EventTest, ConnectionIsInvalidAfterEventIsDeleted)
+{
+    EventConnection connection;
+    {
+        Event0 event;
+        connection = event.registerListener(boost::function<void ()>());
+        EXPECT_TRUE(connection.isValid());
+    }
+    EXPECT_FALSE(connection.isValid());
+}
+
+TEST(EventTest, KeyedEventOnlyCallsListenersOfTheKey)
+{
+    KeyedEvent<VariableKey, Event1<int> > event;
+    int sumHealth = 0, sumEnergy = 0;
+    EventConnection c1 = event.registerListener(VariableKey("Player", "Health"), boost::bind(&add, &sumHealth, _1));
+    EventConnection c2 = event.registerListener(VariableKey("Player", "JetpackEnergy"), boost::bind(&add, &sumEnergy, _1));
+
+    if (Event1<int>* channel = event.find(VariableKey("Player", "Health")))
+        channel->fire(5);
+    EXPECT_EQ(5, sumHealth);
+    EXPECT_EQ(0, sumEnergy);
+    EXPECT_TRUE(event.find(VariableKey("Enemy", "Health")) == NULL);
+}
+
+TEST(EventTest, EntityPairIsUnordered)
+{
+    EXPECT_TRUE(makeEntityPair("Player", "Goal") == makeEntityPair("Goal", "Player"));
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "common/Clock.h"
+#include "common/FramePacer.h"
+
+// 100 Hz: 10ms per frame
+TEST(FramePacerTest, CapsTheFrameRate)
+{
+    FramePacer pacer;
+    pacer.setMaxFps(100);
+    pacer.endFrame(false); // start on the grid
+
+    boost::uint64_t start = getMonotonicTimeNs();
+    for (int i = 0; i < 10; ++i)
+        pacer.endFrame(false);
+    boost::uint64_t elapsedNs = getMonotonicTimeNs() - start;
+    EXPECT_GE(elapsedNs, 95000000u);
+
+    FramePacer::Stats stats = pacer.takeStats();
+    EXPECT_EQ(11u, stats.numFrames);
+    EXPECT_GT(stats.sleepNs, stats.workNs); // nothing to do: most of the time is slept
+    EXPECT_EQ(0u, pacer.takeStats().numFrames);
+}
+
+TEST(FramePacerTest, NoLimitOnlyYields)
+{
+    FramePacer pacer;
+    pacer.setMaxFps(0);
+    boost::uint64_t start = getMonotonicTimeNs();
+    for (int i = 0; i < 100; ++i)
+        pacer.endFrame(false);
+    EXPECT_LT(getMonotonicTimeNs() - start, 100000000u); // no frame waits for a deadline
+    FramePacer::Stats stats = pacer.takeStats();
+    EXPECT_EQ(100u, stats.numFrames);
+    EXPECT_EQ(0u, stats.spinNs);
+}
+
+TEST(FramePacerTest, HasAFiniteDefaultCap)
+{
+    FramePacer pacer;
+    EXPECT_NE(0u, pacer.getMaxFps());
+}
+
+TEST(FramePacerTest, IdleUsesTheIdleRate)
+{
+    FramePacer pacer;
+    pacer.setMaxFps(0);
+    pacer.setIdleFps(50);
+    pacer.endFrame(true);
+    boost::uint64_t start = getMonotonicTimeNs();
+    pacer.endFrame(true);
+    pacer.endFrame(true);
+    EXPECT_GE(getMonotonicTimeNs() - start, 38000000u);
+}
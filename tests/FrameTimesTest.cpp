@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "common/FrameTimes.h"
+
+TEST(FrameTimesTest, Percentiles)
+{
+    FrameTimeHistogram histogram (100);
+    EXPECT_EQ(0u, histogram.getPercentile(50.0f));
+    EXPECT_EQ(0u, histogram.getMax());
+
+    for (boost::uint64_t i = 100; i >= 1; --i)
+        histogram.add(i);
+    EXPECT_EQ(100u, histogram.getNumSamples());
+    EXPECT_EQ(50u, histogram.getPercentile(50.0f));
+    EXPECT_EQ(95u, histogram.getPercentile(95.0f));
+    EXPECT_EQ(99u, histogram.getPercentile(99.0f));
+    EXPECT_EQ(100u, histogram.getMax());
+}
+
+// only the last samples count, so an old hitch disappears
+TEST(FrameTimesTest, OldSamplesAreOverwritten)
+{
+    FrameTimeHistogram histogram (10);
+    histogram.add(1000);
+    for (int i = 0; i < 10; ++i)
+        histogram.add(5);
+    EXPECT_EQ(10u, histogram.getNumSamples());
+    EXPECT_EQ(5u, histogram.getMax());
+}
+
+TEST(FrameTimesTest, Write)
+{
+    FrameTimes times;
+    times.frame.add(16000000);
+    times.update.add(2000000);
+    times.draw.add(5000000);
+    std::ostringstream out;
+    times.write(out);
+    EXPECT_NE(std::string::npos, out.str().find("16.000"));
+    EXPECT_NE(std::string::npos, out.str().find("p99"));
+}
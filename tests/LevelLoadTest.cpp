@@ -5,8 +5,14 @@
 #include <string>
 #include <set>
 #include <list>
+#include <fstream>
+#include <SDL.h>
+#include <boost/scoped_ptr.hpp>
 
+#include "common/BinaryLevel.h"
 #include "common/DataLoader.h"
+#include "common/LevelLoader.h"
+#include "common/LevelSnapshot.h"
 #include "common/ComponentManager.h"
 #include "common/GameEvents.h"
 
@@ -163,3 +169,212 @@ TEST(LevelLoadTest, LoadWriteTest)
 
     // could remove the file afterwards, but needs platform independent way...
 }
+
+namespace {
+const string cLevelFileNames[] = { "data/Levels/level1.lvl",
+                                   "data/Levels/level2.lvl",
+                                   "data/Levels/level3.lvl",
+                                   "data/Levels/level_grav.lvl",
+                                   "data/Levels/planet.lvl",
+                                   "data/Levels/platforms.lvl",
+                                   "data/Levels/cave.lvl",
+                                   "data/player.info" };
+}
+
+TEST(LevelLoadTest, BinaryCompileTest)
+{
+    string lvlFileNameOut = "tmp_test_compile_lvl.lvlb";
+
+    foreach(string lvlFileName, cLevelFileNames)
+    {
+        cout << "Testing with " << lvlFileName << endl;
+        DataLoader::compileWorld(lvlFileName, lvlFileNameOut);
+
+        ptree levelPropTree;
+        read_info(lvlFileName, levelPropTree);
+
+        BinaryLevel binaryLevel;
+        binaryLevel.open(lvlFileNameOut);
+        ptree binaryPropTree;
+        binaryLevel.toPropertyTree(binaryLevel.getRoot(), binaryPropTree);
+
+        EXPECT_TRUE(propTreeEquals(levelPropTree, binaryPropTree));
+    }
+}
+
+// text -> world -> binary -> world -> text
+TEST(LevelLoadTest, BinaryLoadWriteTest)
+{
+    GameEvents events;
+    string binFileNameOut = "tmp_test_write_lvl.lvlb";
+    string lvlFileNameOut = "tmp_test_write_binary_lvl.lvl";
+
+    foreach(string lvlFileName, cLevelFileNames)
+    {
+        cout << "Testing with " << lvlFileName << endl;
+        {
+            ComponentManager compMgr (events);
+            DataLoader::loadToWorld(lvlFileName, compMgr, events);
+            DataLoader::saveWorld(binFileNameOut, compMgr);
+        }
+        {
+            ComponentManager compMgr (events);
+            DataLoader::loadToWorld(binFileNameOut, compMgr, events);
+            DataLoader::saveWorld(lvlFileNameOut, compMgr);
+        }
+
+        ptree levelPropTreeBefore;
+        read_info(lvlFileName, levelPropTreeBefore);
+        ptree levelPropTreeAfter;
+        read_info(lvlFileNameOut, levelPropTreeAfter);
+
+        EXPECT_TRUE(propTreeEquals(levelPropTreeBefore, levelPropTreeAfter));
+    }
+}
+
+TEST(LevelLoadTest, InvalidBinaryFileTest)
+{
+    string fileName = "tmp_test_invalid_lvl.lvlb";
+    {
+        ofstream out (fileName.c_str(), ios::binary);
+        out << "AALB this is not a level";
+    }
+    BinaryLevel binaryLevel;
+    EXPECT_THROW(binaryLevel.open(fileName), DataLoadException);
+    EXPECT_FALSE(binaryLevel.isOpen());
+}
+
+// a crafted file with a very long chain of nodes must be rejected without recursing
+TEST(LevelLoadTest, DeeplyNestedBinaryFileTest)
+{
+    const boost::uint32_t numNodes = 1000000;
+    const boost::uint32_t header[5] = { 0, 1, numNodes, 1, 1 }; // magic, version, nodes, strings, string data size
+    string data (reinterpret_cast<const char*>(header), sizeof(header));
+    data.replace(0, 4, "AALB");
+    for (boost::uint32_t i = 0; i < numNodes; ++i)
+    {
+        BinaryLevel::Node node = { 0, 0, i + 1 < numNodes ? 1u : 0u, numNodes - i };
+        data.append(reinterpret_cast<const char*>(&node), sizeof(node));
+    }
+    BinaryLevel::StringEntry emptyString = { 0, 0 };
+    data.append(reinterpret_cast<const char*>(&emptyString), sizeof(emptyString));
+    data.push_back('\0');
+
+    BinaryLevel binaryLevel;
+    EXPECT_THROW(binaryLevel.open(data.data(), data.size(), "deep"), DataLoadException);
+    EXPECT_FALSE(binaryLevel.isOpen());
+}
+
+// world -> snapshot -> world gives the same level, without reading a file
+TEST(LevelLoadTest, LevelSnapshotTest)
+{
+    GameEvents events;
+    string lvlFileNameLoaded = "tmp_test_loaded_lvl.lvl";
+    string lvlFileNameRestored = "tmp_test_restored_lvl.lvl";
+
+    foreach(string lvlFileName, cLevelFileNames)
+    {
+        cout << "Testing with " << lvlFileName << endl;
+        boost::scoped_ptr<LevelSnapshot> snapshot;
+        {
+            ComponentManager compMgr (events);
+            DataLoader::loadToWorld(lvlFileName, compMgr, events);
+            DataLoader::saveWorld(lvlFileNameLoaded, compMgr);
+            snapshot.reset(new LevelSnapshot(compMgr));
+            EXPECT_EQ(compMgr.getAllEntities().size(), snapshot->getNumEntities());
+        }
+        {
+            ComponentManager compMgr (events);
+            snapshot->restore(compMgr, events);
+            DataLoader::saveWorld(lvlFileNameRestored, compMgr);
+        }
+
+        ptree levelPropTreeLoaded;
+        read_info(lvlFileNameLoaded, levelPropTreeLoaded);
+        ptree levelPropTreeRestored;
+        read_info(lvlFileNameRestored, levelPropTreeRestored);
+        EXPECT_TRUE(propTreeEquals(levelPropTreeLoaded, levelPropTreeRestored));
+    }
+}
+
+namespace {
+void waitUntilLoaded(const LevelLoader& loader)
+{
+    while (!loader.isLoaded())
+        SDL_Delay(1);
+}
+}
+
+// loading in a thread and committing one entity at a time gives the same world as loadToWorld
+TEST(LevelLoadTest, LevelLoaderTest)
+{
+    GameEvents events;
+    string lvlFileNameSync = "tmp_test_sync_lvl.lvl";
+    string lvlFileNameAsync = "tmp_test_async_lvl.lvl";
+
+    vector<string> fileNames;
+    fileNames.push_back("data/player.info");
+    fileNames.push_back("data/Levels/level1.lvl");
+    {
+        ComponentManager compMgr (events);
+        foreach(string fileName, fileNames)
+            DataLoader::loadToWorld(fileName, compMgr, events);
+        DataLoader::saveWorld(lvlFileNameSync, compMgr);
+    }
+    {
+        ComponentManager compMgr (events);
+        LevelLoader loader (fileNames, events);
+        waitUntilLoaded(loader);
+        ASSERT_FALSE(loader.hasFailed()) << loader.getErrorMsg();
+
+        size_t numCommits = 1;
+        while (!loader.commit(compMgr, 0))
+            ++numCommits;
+        EXPECT_EQ(compMgr.getAllEntities().size(), numCommits);
+        EXPECT_FLOAT_EQ(1.0f, loader.getProgress());
+        DataLoader::saveWorld(lvlFileNameAsync, compMgr);
+    }
+
+    ptree levelPropTreeSync;
+    read_info(lvlFileNameSync, levelPropTreeSync);
+    ptree levelPropTreeAsync;
+    read_info(lvlFileNameAsync, levelPropTreeAsync);
+    EXPECT_TRUE(propTreeEquals(levelPropTreeSync, levelPropTreeAsync));
+}
+
+TEST(LevelLoadTest, LevelLoaderErrorTest)
+{
+    GameEvents events;
+    ComponentManager compMgr (events);
+    LevelLoader loader (vector<string>(1, "data/Levels/does_not_exist.lvl"), events);
+    waitUntilLoaded(loader);
+    EXPECT_TRUE(loader.hasFailed());
+    EXPECT_FALSE(loader.commit(compMgr, 0));
+    EXPECT_TRUE(compMgr.getAllEntities().empty());
+}
+
+// every level only uses graphics that exist in graphics.info, and no level uses all of them
+TEST(LevelLoadTest, UsedGraphicsTest)
+{
+    ResourceIds allGraphics = DataLoader::getGraphicsIds("data/graphics.info");
+    EXPECT_FALSE(allGraphics.textures.empty());
+    EXPECT_FALSE(allGraphics.fonts.empty());
+
+    foreach(string lvlFileName, cLevelFileNames)
+    {
+        GameEvents events;
+        ComponentManager compMgr (events);
+        DataLoader::loadToWorld("data/player.info", compMgr, events);
+        DataLoader::loadToWorld(lvlFileName, compMgr, events);
+
+        ResourceIds used = DataLoader::getUsedGraphics(compMgr);
+        EXPECT_FALSE(used.textures.empty()) << lvlFileName;
+        EXPECT_FALSE(used.animations.empty()) << lvlFileName; // player
+        EXPECT_TRUE(used.fonts.empty());
+        foreach(const string& id, used.textures)
+            EXPECT_EQ(1u, allGraphics.textures.count(id)) << lvlFileName << ": " << id;
+        foreach(const string& id, used.animations)
+            EXPECT_EQ(1u, allGraphics.animations.count(id)) << lvlFileName << ": " << id;
+        EXPECT_LT(used.textures.size(), allGraphics.textures.size()) << lvlFileName;
+    }
+}
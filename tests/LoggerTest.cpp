@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include "common/Logger.h"
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <boost/make_shared.hpp>
+#include <SDL.h>
+
+namespace {
+
+class StringHandler : public LogHandler
+{
+public:
+    StringHandler() : lines () {}
+    std::vector<std::string> lines;
+protected:
+    void write(const std::string& str)
+    {
+        // a record can contain several lines
+        std::istringstream stream (str);
+        std::string line;
+        while (std::getline(stream, line))
+            lines.push_back(line);
+    }
+};
+
+// counts how often it is formatted
+class CountingValue
+{
+public:
+    CountingValue() : numFormatted (0) {}
+    mutable int numFormatted;
+};
+
+std::ostream& operator << (std::ostream& stream, const CountingValue& value)
+{
+    ++value.numFormatted;
+    return stream << "value";
+}
+
+const int cNumThreads = 4;
+const int cLinesPerThread = 1000;
+
+int logLines(void* data)
+{
+    LogThreadScope logScope;
+    int thread = *static_cast<int*>(data);
+    for (int i = 0; i < cLinesPerThread; ++i)
+        AA_LOG(Info) << "thread " << thread << " line " << i << "\n";
+    return 0;
+}
+
+}
+
+TEST(LoggerTest, FiltersLevels)
+{
+    boost::shared_ptr<StringHandler> handler = boost::make_shared<StringHandler>();
+    addLogHandler(handler, Info);
+
+    AA_LOG(Warning) << "warning " << 1 << "\n";
+    AA_LOG(Debug) << "debug\n";
+    AA_LOG(Info) << "info, ";
+    AA_LOG(Info) << "same line\n";
+    flushLog();
+
+    ASSERT_EQ(2u, handler->lines.size());
+    EXPECT_EQ("warning 1", handler->lines[0]);
+    EXPECT_EQ("info, same line", handler->lines[1]);
+
+    removeLogHandler(handler);
+    AA_LOG(Warning) << "not written\n";
+    flushLog();
+    EXPECT_EQ(2u, handler->lines.size());
+}
+
+TEST(LoggerTest, DisabledLevelIsNotFormatted)
+{
+    boost::shared_ptr<StringHandler> handler = boost::make_shared<StringHandler>();
+    addLogHandler(handler, Warning);
+
+    EXPECT_FALSE(LoggerDetail::isEnabled(Info));
+    EXPECT_TRUE(LoggerDetail::isEnabled(Warning));
+
+    CountingValue value;
+    AA_LOG(Info) << "info " << value << "\n";
+    EXPECT_EQ(0, value.numFormatted);
+    AA_LOG(Warning) << "warning " << value << "\n";
+    EXPECT_EQ(1, value.numFormatted);
+    flushLog();
+    ASSERT_EQ(1u, handler->lines.size());
+    EXPECT_EQ("warning value", handler->lines[0]);
+
+    removeLogHandler(handler);
+    EXPECT_FALSE(LoggerDetail::isEnabled(Fatal));
+}
+
+TEST(LoggerTest, DisabledLevelDoesNotEvaluateArguments)
+{
+    boost::shared_ptr<StringHandler> handler = boost::make_shared<StringHandler>();
+    addLogHandler(handler, Warning);
+
+    int numCalls = 0;
+    AA_LOG(Info) << "call " << ++numCalls << "\n";
+    EXPECT_EQ(0, numCalls);
+    AA_LOG(Warning) << "call " << ++numCalls << "\n";
+    EXPECT_EQ(1, numCalls);
+
+    // the macro must not take the else of an unbraced if
+    bool elseTaken = false;
+    if (numCalls == 0)
+        AA_LOG(Warning) << "not reached\n";
+    else
+        elseTaken = true;
+    EXPECT_TRUE(elseTaken);
+
+    flushLog();
+    ASSERT_EQ(1u, handler->lines.size());
+    EXPECT_EQ("call 1", handler->lines[0]);
+
+    removeLogHandler(handler);
+}
+
+TEST(LoggerTest, WholeLinesFromThreads)
+{
+    boost::shared_ptr<StringHandler> handler = boost::make_shared<StringHandler>();
+    addLogHandler(handler, Info);
+
+    int threadNumbers[cNumThreads];
+    SDL_Thread* threads[cNumThreads];
+    for (int t = 0; t < cNumThreads; ++t)
+    {
+        threadNumbers[t] = t;
+        threads[t] = SDL_CreateThread(&logLines, &threadNumbers[t]);
+    }
+    for (int t = 0; t < cNumThreads; ++t)
+        SDL_WaitThread(threads[t], NULL);
+    flushLog();
+
+    ASSERT_EQ((size_t)cNumThreads * cLinesPerThread, handler->lines.size());
+    // every line is complete and the lines of one thread keep their order
+    std::vector<int> nextLine (cNumThreads, 0);
+    for (size_t i = 0; i < handler->lines.size(); ++i)
+    {
+        std::istringstream line (handler->lines[i]);
+        std::string word1, word2;
+        int thread = -1, number = -1;
+        line >> word1 >> thread >> word2 >> number;
+        ASSERT_EQ("thread", word1);
+        ASSERT_TRUE(thread >= 0 && thread < cNumThreads);
+        ASSERT_EQ(nextLine[thread], number);
+        ++nextLine[thread];
+    }
+
+    removeLogHandler(handler);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+
+#include "common/RenderBatch.h"
+#include "common/Renderer.h"
+#include "common/ComponentManager.h"
+#include "common/GameEvents.h"
+#include "common/components/CompPosition.h"
+#include "common/components/CompShape.h"
+#include "common/components/CompVisualTexture.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+// The batch is built without OpenGL, so its contents can be checked headless.
+
+TEST(RenderBatchTest, PolygonIsTriangulatedAndTransformed)
+{
+    RenderBatch batch;
+    Vector2D square[4] = { Vector2D(0, 0), Vector2D(1, 0), Vector2D(1, 1), Vector2D(0, 1) };
+
+    batch.addPolygon("tex", square, NULL, 4, BatchTransform(Vector2D(10.0f, 5.0f), cPi / 2));
+
+    const std::vector<BatchVertex>* vertices = batch.getVertices("tex");
+    ASSERT_TRUE(vertices != NULL);
+    ASSERT_EQ(6u, vertices->size()); // 2 triangles
+
+    // (1,0) rotated by 90° is (0,1), then translated
+    const BatchVertex& v = (*vertices)[1];
+    EXPECT_NEAR(10.0f, v.x, 1e-5f);
+    EXPECT_NEAR(6.0f, v.y, 1e-5f);
+    // without a texture map the local coordinates are used (Y flipped)
+    EXPECT_FLOAT_EQ(1.0f, v.u);
+    EXPECT_FLOAT_EQ(0.0f, v.v);
+    EXPECT_EQ(255, v.a);
+}
+
+TEST(RenderBatchTest, GeometryIsGroupedByTextureAndLayer)
+{
+    RenderBatch batch;
+    Vector2D triangle[3] = { Vector2D(0, 0), Vector2D(1, 0), Vector2D(0, 1) };
+    float texCoord[8] = { 0, 0, 0, 1, 1, 1, 1, 0 };
+    float vertexCoord[8] = { 0, 1, 0, 0, 1, 0, 1, 1 };
+
+    batch.addPolygon("a", triangle, NULL, 3, BatchTransform());
+    batch.addPolygon("b", triangle, NULL, 3, BatchTransform());
+    batch.addPolygon("a", triangle, NULL, 3, BatchTransform());
+    batch.addQuad("a", texCoord, vertexCoord, BatchTransform(), 1);
+
+    EXPECT_EQ(3u, batch.getNumBatches());
+    EXPECT_EQ(6u, batch.getVertices("a", 0)->size());
+    EXPECT_EQ(3u, batch.getVertices("b", 0)->size());
+    EXPECT_EQ(6u, batch.getVertices("a", 1)->size());
+    EXPECT_TRUE(batch.getVertices("b", 1) == NULL);
+
+    batch.clear();
+    EXPECT_EQ(0u, batch.getNumBatches());
+    EXPECT_EQ(0u, batch.getNumVertices());
+}
+
+TEST(RenderBatchTest, CircleHasOneTrianglePerSlice)
+{
+    RenderBatch batch;
+    batch.addCircle("c", Vector2D(1.0f, 1.0f), 2.0f, 20, BatchTransform());
+
+    const std::vector<BatchVertex>* vertices = batch.getVertices("c");
+    ASSERT_TRUE(vertices != NULL);
+    ASSERT_EQ(60u, vertices->size());
+    for (size_t i = 0; i < vertices->size(); i += 3)
+    {
+        // the first vertex of each triangle is the center
+        EXPECT_FLOAT_EQ(1.0f, (*vertices)[i].x);
+        EXPECT_FLOAT_EQ(1.0f, (*vertices)[i].y);
+    }
+}
+
+namespace {
+boost::property_tree::ptree squareTree(float size)
+{
+    boost::property_tree::ptree propTree;
+    Vector2D corners[4] = { Vector2D(0, 0), Vector2D(size, 0), Vector2D(size, size), Vector2D(0, size) };
+    for (int i = 0; i < 4; ++i)
+    {
+        boost::property_tree::ptree vertex;
+        vertex.add("x", corners[i].x);
+        vertex.add("y", corners[i].y);
+        propTree.add_child("polygon.vertex", vertex);
+    }
+    return propTree;
+}
+}
+
+// a static block that is changed like in the editor (loadFromPropertyTree + componentChanged) is batched again
+TEST(RenderBatchTest, StaticGeometryIsRebuiltAfterEdit)
+{
+    GameEvents events;
+    RenderSystem renderer (events);
+    ComponentManager compMgr (events);
+
+    boost::shared_ptr<CompShapePolygon> shape = boost::make_shared<CompShapePolygon>("shape", boost::ref(events));
+    shape->loadFromPropertyTree(squareTree(1.0f));
+    ComponentList components;
+    components.push_back(boost::make_shared<CompPosition>("", boost::ref(events), Vector2D(2.0f, 2.0f)));
+    components.push_back(shape);
+    components.push_back(boost::make_shared<CompVisualTexture>("", boost::ref(events), "tex"));
+    compMgr.addEntity("block", components);
+
+    renderer.updateStaticGeometry();
+    EXPECT_EQ(1u, renderer.getNumStaticTextureComps());
+    const RenderBatch* batch = renderer.getStaticGeometry(Vector2D(2.5f, 2.5f));
+    ASSERT_TRUE(batch != NULL);
+    ASSERT_EQ(6u, batch->getVertices("tex")->size());
+    float maxX = 0.0f;
+    for (size_t i = 0; i < 6; ++i)
+        maxX = std::max(maxX, (*batch->getVertices("tex"))[i].x);
+    EXPECT_FLOAT_EQ(3.0f, maxX);
+
+    shape->loadFromPropertyTree(squareTree(2.0f));
+    events.componentChanged.fire(*shape);
+    renderer.updateStaticGeometry();
+
+    batch = renderer.getStaticGeometry(Vector2D(2.5f, 2.5f)); // the center moved to (3,3), still the same cell
+    ASSERT_TRUE(batch != NULL);
+    ASSERT_EQ(6u, batch->getVertices("tex")->size());
+    maxX = 0.0f;
+    for (size_t i = 0; i < 6; ++i)
+        maxX = std::max(maxX, (*batch->getVertices("tex"))[i].x);
+    EXPECT_FLOAT_EQ(4.0f, maxX);
+}
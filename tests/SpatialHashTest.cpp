@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include "common/ComponentManager.h"
+#include "common/GameEvents.h"
+#include "common/SpatialHash.h"
+#include "common/WorldIndex.h"
+#include "common/components/CompPosition.h"
+#include "common/components/CompShape.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace {
+
+std::vector<int> sorted(std::vector<int> items)
+{
+    std::sort(items.begin(), items.end());
+    return items;
+}
+
+}
+
+TEST(SpatialHashTest, QueriesReturnEachItemOnce)
+{
+    SpatialHash<int> hash (1.0f);
+    hash.update(1, Aabb(Vector2D(0.5f, 0.5f), Vector2D(3.5f, 2.5f))); // in several cells
+    hash.update(2, Aabb(Vector2D(-5, -5), Vector2D(-4, -4)));
+    hash.update(3, Aabb(Vector2D(2, 2), Vector2D(2.2f, 2.2f)));
+    EXPECT_EQ(3u, hash.size());
+
+    std::vector<int> result;
+    hash.queryAabb(Aabb(Vector2D(0, 0), Vector2D(10, 10)), result);
+    EXPECT_EQ(2u, result.size());
+    EXPECT_EQ(1, sorted(result)[0]);
+    EXPECT_EQ(3, sorted(result)[1]);
+
+    result.clear();
+    hash.queryPoint(Vector2D(-4.5f, -4.5f), result);
+    ASSERT_EQ(1u, result.size());
+    EXPECT_EQ(2, result[0]);
+
+    result.clear();
+    hash.queryPoint(Vector2D(3.7f, 0.6f), result); // in a cell of item 1, but outside its box
+    EXPECT_TRUE(result.empty());
+}
+
+TEST(SpatialHashTest, RadiusQueryTestsTheCircle)
+{
+    SpatialHash<int> hash (1.0f);
+    hash.update(1, Aabb(Vector2D(1, 1), Vector2D(2, 2)));
+
+    std::vector<int> result;
+    hash.queryRadius(Vector2D(0, 0), 1.3f, result); // the corner (1,1) is 1.41 away
+    EXPECT_TRUE(result.empty());
+    hash.queryRadius(Vector2D(0, 0), 1.5f, result);
+    EXPECT_EQ(1u, result.size());
+    result.clear();
+    hash.queryRadius(Vector2D(0, 1.5f), 1.0f, result);
+    EXPECT_EQ(1u, result.size());
+}
+
+TEST(SpatialHashTest, MoveAndRemove)
+{
+    SpatialHash<int> hash (2.0f);
+    hash.update(1, Aabb(Vector2D(0, 0), Vector2D(1, 1)));
+    hash.update(1, Aabb(Vector2D(0.5f, 0), Vector2D(1.5f, 1))); // same cell
+    hash.update(1, Aabb(Vector2D(10, 10), Vector2D(11, 11)));   // other cells
+    EXPECT_EQ(1u, hash.size());
+
+    std::vector<int> result;
+    hash.queryPoint(Vector2D(0.7f, 0.5f), result);
+    EXPECT_TRUE(result.empty());
+    hash.queryPoint(Vector2D(10.5f, 10.5f), result);
+    EXPECT_EQ(1u, result.size());
+
+    hash.remove(1);
+    EXPECT_FALSE(hash.contains(1));
+    result.clear();
+    hash.queryAabb(Aabb(Vector2D(-100, -100), Vector2D(100, 100)), result);
+    EXPECT_TRUE(result.empty());
+}
+
+// an item covering a lot of cells is found anywhere inside, also after it shrinks again
+TEST(SpatialHashTest, OversizedItems)
+{
+    SpatialHash<int> hash (1.0f);
+    hash.update(1, Aabb(Vector2D(-500, -500), Vector2D(500, 500)));
+    hash.update(2, Aabb(Vector2D(0, 0), Vector2D(1, 1)));
+
+    std::vector<int> result;
+    hash.queryPoint(Vector2D(499, -499), result);
+    ASSERT_EQ(1u, result.size());
+    EXPECT_EQ(1, result[0]);
+
+    result.clear();
+    hash.queryAabb(Aabb(Vector2D(-1000, -1000), Vector2D(1000, 1000)), result); // big query
+    EXPECT_EQ(2u, result.size());
+
+    hash.update(1, Aabb(Vector2D(5, 5), Vector2D(6, 6)));
+    result.clear();
+    hash.queryPoint(Vector2D(499, -499), result);
+    EXPECT_TRUE(result.empty());
+    hash.queryPoint(Vector2D(5.5f, 5.5f), result);
+    EXPECT_EQ(1u, result.size());
+}
+
+// shapes are indexed when their entity is added, the point query tests the shape itself
+TEST(SpatialHashTest, WorldIndexFindsEntities)
+{
+    GameEvents events;
+    WorldIndex index (events);
+    ComponentManager compMgr (events);
+
+    ComponentList components;
+    components.push_back(boost::make_shared<CompPosition>("", boost::ref(events), Vector2D(10.0f, 0.0f)));
+    components.push_back(boost::make_shared<CompShapeCircle>("shape", boost::ref(events), Vector2D(), 1.0f));
+    compMgr.addEntity("ball", components);
+    EXPECT_EQ(1u, index.getNumShapes());
+
+    std::vector<CompShape*> shapes;
+    index.queryPoint(Vector2D(10.9f, 0.9f), shapes); // inside the box, but not the circle
+    EXPECT_TRUE(shapes.empty());
+    index.queryPoint(Vector2D(10.5f, 0.5f), shapes);
+    ASSERT_EQ(1u, shapes.size());
+    EXPECT_EQ(EntityId("ball"), shapes[0]->getEntityId());
+
+    shapes.clear();
+    index.queryRadius(Vector2D(0.0f, 0.0f), 5.0f, shapes);
+    EXPECT_TRUE(shapes.empty());
+    index.queryAabb(Aabb(Vector2D(8.0f, -1.0f), Vector2D(9.5f, 1.0f)), shapes);
+    EXPECT_EQ(1u, WorldIndex::getEntities(shapes).size());
+
+    compMgr.removeEntity("ball");
+    EXPECT_EQ(0u, index.getNumShapes());
+}
+
+TEST(SpatialHashTest, WorldIndexFollowsEditedShapes)
+{
+    GameEvents events;
+    WorldIndex index (events);
+    ComponentManager compMgr (events);
+
+    boost::shared_ptr<CompPosition> position = boost::make_shared<CompPosition>("", boost::ref(events), Vector2D(10.0f, 0.0f));
+    boost::shared_ptr<CompShapeCircle> circle = boost::make_shared<CompShapeCircle>("shape", boost::ref(events), Vector2D(), 1.0f);
+    ComponentList components;
+    components.push_back(position);
+    components.push_back(circle);
+    compMgr.addEntity("ball", components);
+
+    std::vector<CompShape*> shapes;
+    index.queryPoint(Vector2D(12.5f, 0.0f), shapes);
+    EXPECT_TRUE(shapes.empty());
+
+    // the editor reloads the shape with a bigger radius, without calling update()
+    boost::property_tree::ptree propTree;
+    propTree.put("circle.r", 3.0f);
+    circle->loadFromPropertyTree(propTree);
+    events.componentChanged.fire(*circle);
+    index.queryPoint(Vector2D(12.5f, 0.0f), shapes);
+    ASSERT_EQ(1u, shapes.size());
+    EXPECT_EQ(EntityId("ball"), shapes[0]->getEntityId());
+
+    // the editor moves the entity
+    boost::property_tree::ptree posTree;
+    posTree.put("x", -10.0f);
+    posTree.put("y", 0.0f);
+    position->loadFromPropertyTree(posTree);
+    events.componentChanged.fire(*position);
+    shapes.clear();
+    index.queryPoint(Vector2D(12.5f, 0.0f), shapes);
+    EXPECT_TRUE(shapes.empty());
+    index.queryPoint(Vector2D(-7.5f, 0.0f), shapes);
+    EXPECT_EQ(1u, shapes.size());
+}
+
+TEST(SpatialHashTest, WorldIndexMovesOnlyUpdatedPositions)
+{
+    GameEvents events;
+    WorldIndex index (events);
+    ComponentManager compMgr (events);
+
+    boost::shared_ptr<CompPosition> position1 = boost::make_shared<CompPosition>("", boost::ref(events), Vector2D(0.0f, 0.0f));
+    boost::shared_ptr<CompPosition> position2 = boost::make_shared<CompPosition>("", boost::ref(events), Vector2D(0.0f, 10.0f));
+    ComponentList components1, components2;
+    components1.push_back(position1);
+    components1.push_back(boost::make_shared<CompShapeCircle>("", boost::ref(events), Vector2D(), 1.0f));
+    components2.push_back(position2);
+    components2.push_back(boost::make_shared<CompShapeCircle>("", boost::ref(events), Vector2D(), 1.0f));
+    compMgr.addEntity("moving", components1);
+    compMgr.addEntity("resting", components2);
+
+    // both positions change, but only the first is pushed (like the physics system does for moved bodies)
+    boost::property_tree::ptree posTree;
+    posTree.put("x", 20.0f);
+    posTree.put("y", 0.0f);
+    position1->loadFromPropertyTree(posTree);
+    position2->loadFromPropertyTree(posTree);
+    index.updatePosition(*position1);
+
+    std::vector<CompShape*> shapes;
+    index.queryPoint(Vector2D(20.0f, 0.0f), shapes);
+    ASSERT_EQ(1u, shapes.size());
+    EXPECT_EQ(EntityId("moving"), shapes[0]->getEntityId());
+    shapes.clear();
+    index.queryPoint(Vector2D(0.0f, 10.0f), shapes);
+    ASSERT_EQ(1u, shapes.size());
+    EXPECT_EQ(EntityId("resting"), shapes[0]->getEntityId());
+
+    compMgr.removeEntity("moving");
+    compMgr.removeEntity("resting");
+    EXPECT_EQ(0u, index.getNumShapes());
+}
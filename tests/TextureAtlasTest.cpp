@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "common/TextureAtlas.h"
+
+// Packing works on image sizes only, so no OpenGL or DevIL is needed.
+
+TEST(TextureAtlasTest, AnimationFramesArePackedWithoutOverlap)
+{
+    // like the frames of the astronaut animation
+    std::vector<AtlasImage> images (19, AtlasImage(303, 421));
+    AtlasPacker packer (2, 2048);
+    ASSERT_TRUE(packer.pack(images));
+
+    // power of two sizes
+    EXPECT_EQ(0, packer.getWidth() & (packer.getWidth() - 1));
+    EXPECT_EQ(0, packer.getHeight() & (packer.getHeight() - 1));
+
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        const AtlasImage& a = images[i];
+        EXPECT_GE(a.x, 2);
+        EXPECT_GE(a.y, 2);
+        EXPECT_LE(a.x + a.width + 2, packer.getWidth());
+        EXPECT_LE(a.y + a.height + 2, packer.getHeight());
+        for (size_t j = i + 1; j < images.size(); ++j)
+        {
+            const AtlasImage& b = images[j];
+            bool separated = a.x + a.width + 4 <= b.x || b.x + b.width + 4 <= a.x ||
+                             a.y + a.height + 4 <= b.y || b.y + b.height + 4 <= a.y;
+            EXPECT_TRUE(separated) << "images " << i << " and " << j << " overlap";
+        }
+    }
+}
+
+TEST(TextureAtlasTest, TexRectCoversImage)
+{
+    std::vector<AtlasImage> images;
+    images.push_back(AtlasImage(64, 32));
+    images.push_back(AtlasImage(32, 64));
+    AtlasPacker packer (0, 1024);
+    ASSERT_TRUE(packer.pack(images));
+
+    TexRect rect = packer.getTexRect(images[1]);
+    EXPECT_FLOAT_EQ((float)images[1].x / packer.getWidth(), rect.left);
+    EXPECT_FLOAT_EQ((float)images[1].y / packer.getHeight(), rect.top);
+    EXPECT_FLOAT_EQ(32.0f / packer.getWidth(), rect.right - rect.left);
+    EXPECT_FLOAT_EQ(64.0f / packer.getHeight(), rect.bottom - rect.top);
+}
+
+TEST(TextureAtlasTest, TooLargeImagesDoNotFit)
+{
+    std::vector<AtlasImage> images (5, AtlasImage(512, 512));
+    AtlasPacker packer (2, 1024);
+    EXPECT_FALSE(packer.pack(images));
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common/TextureCache.h"
+#include "common/TextureDecoder.h"
+
+// The cache does not decode the source files, it only hashes them, so any file works as a source.
+
+namespace {
+
+const std::string cSourceFileName = "tmp_test_cache_source.png";
+const std::string cManifestFileName = "tmp_test_cache.info";
+const std::string cCacheFileName = "tmp_test_cache.bin";
+
+void writeSource(const std::string& content)
+{
+    std::ofstream out (cSourceFileName.c_str(), std::ios::binary);
+    out << content;
+}
+
+std::vector<RgbaImage> makeLevels(int width, int height)
+{
+    std::vector<RgbaImage> levels (1, RgbaImage(width, height));
+    for (size_t i = 0; i < levels[0].data.size(); ++i)
+        levels[0].data[i] = (unsigned char)i;
+    buildMipmaps(levels);
+    return levels;
+}
+
+void writeCache(const std::vector<RgbaImage>& levels)
+{
+    boost::uint64_t hash = 0;
+    ASSERT_TRUE(TextureCache::hashFile(cSourceFileName, hash));
+    TextureCacheWriter writer (cManifestFileName, cCacheFileName);
+    writer.add(cSourceFileName, hash, TextureCache::KindTexture, QualityGood, levels, 30, 7);
+    writer.finish();
+}
+
+}
+
+TEST(TextureCacheTest, BakedLevelsAreLoaded)
+{
+    writeSource("image data");
+    std::vector<RgbaImage> levels = makeLevels(16, 8);
+    writeCache(levels);
+
+    TextureCache cache;
+    ASSERT_TRUE(cache.open(cManifestFileName));
+    std::vector<RgbaImage> loaded;
+    int originalWidth = 0, originalHeight = 0;
+    ASSERT_TRUE(cache.load(cSourceFileName, TextureCache::KindTexture, QualityGood, loaded, &originalWidth, &originalHeight));
+    EXPECT_EQ(30, originalWidth);
+    EXPECT_EQ(7, originalHeight);
+    ASSERT_EQ(levels.size(), loaded.size());
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        EXPECT_EQ(levels[i].width, loaded[i].width);
+        EXPECT_EQ(levels[i].height, loaded[i].height);
+        EXPECT_TRUE(levels[i].data == loaded[i].data);
+    }
+
+    // other quality or kind was not baked
+    EXPECT_FALSE(cache.load(cSourceFileName, TextureCache::KindTexture, QualityBest, loaded));
+    EXPECT_FALSE(cache.load(cSourceFileName, TextureCache::KindAnimFrame, QualityGood, loaded));
+}
+
+TEST(TextureCacheTest, ChangedSourceIsNotLoaded)
+{
+    writeSource("image data");
+    writeCache(makeLevels(4, 4));
+    writeSource("new image data");
+
+    TextureCache cache;
+    ASSERT_TRUE(cache.open(cManifestFileName));
+    std::vector<RgbaImage> loaded;
+    EXPECT_FALSE(cache.load(cSourceFileName, TextureCache::KindTexture, QualityGood, loaded));
+}
+
+TEST(TextureCacheTest, MissingManifestIsNotOpened)
+{
+    TextureCache cache;
+    EXPECT_FALSE(cache.open("tmp_test_cache_does_not_exist.info"));
+    EXPECT_FALSE(cache.isOpen());
+}
+
+// decodeTexture uses the cache and drops the mipmap levels that are larger than maxSize
+TEST(TextureCacheTest, DecodeTextureSkipsTooLargeLevels)
+{
+    writeSource("image data");
+    writeCache(makeLevels(16, 8));
+
+    TextureCache cache;
+    ASSERT_TRUE(cache.open(cManifestFileName));
+
+    LoadTextureInfo info;
+    info.loadMipmaps = true;
+    info.wrapModeX = WrapClamp;
+    info.wrapModeY = WrapClamp;
+    info.quality = QualityGood;
+    info.scale = 1.0f;
+    DecodedTexture texture (cSourceFileName, "tex", info);
+    decodeTexture(texture, 4, &cache);
+    ASSERT_TRUE(texture.success);
+    EXPECT_TRUE(texture.fromCache);
+    EXPECT_EQ(4, texture.levels[0].width);
+    EXPECT_EQ(2, texture.levels[0].height);
+    EXPECT_EQ(1, texture.levels.back().width);
+    EXPECT_EQ(1, texture.levels.back().height);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "common/TextureDecoder.h"
+
+// Scaling and mipmaps work on RGBA data only, so no OpenGL or DevIL is needed.
+
+TEST(TextureDecoderTest, MipmapsGoDownToOnePixel)
+{
+    std::vector<RgbaImage> levels (1, RgbaImage(8, 2));
+    buildMipmaps(levels);
+    ASSERT_EQ(4u, levels.size()); // 8x2, 4x1, 2x1, 1x1
+    EXPECT_EQ(4, levels[1].width);
+    EXPECT_EQ(1, levels[1].height);
+    EXPECT_EQ(1, levels[3].width);
+    EXPECT_EQ(1, levels[3].height);
+}
+
+TEST(TextureDecoderTest, HalvingAveragesPixels)
+{
+    RgbaImage image (2, 2);
+    for (size_t i = 0; i < image.data.size(); ++i)
+        image.data[i] = (unsigned char)(i * 10);
+    RgbaImage half = halveImage(image);
+    ASSERT_EQ(1, half.width);
+    ASSERT_EQ(1, half.height);
+    for (int c = 0; c < 4; ++c)
+        EXPECT_EQ((image.data[c] + image.data[4 + c] + image.data[8 + c] + image.data[12 + c] + 2) / 4, half.data[c]);
+}
+
+TEST(TextureDecoderTest, ScalingToPowerOfTwoKeepsUniformColor)
+{
+    RgbaImage image (300, 200);
+    for (size_t i = 0; i < image.data.size(); ++i)
+        image.data[i] = 77;
+    RgbaImage scaled = scaleImage(image, 256, 256);
+    ASSERT_EQ(256, scaled.width);
+    ASSERT_EQ(256, scaled.height);
+    for (size_t i = 0; i < scaled.data.size(); ++i)
+        ASSERT_EQ(77, scaled.data[i]);
+}
+
+// PNG and JPG are decoded with libpng and libjpeg, not DevIL (ilInit() is not even called here)
+TEST(TextureDecoderTest, LoadsPngAndJpgWithoutDevIl)
+{
+    RgbaImage image;
+    std::string errorMsg;
+    ASSERT_TRUE(loadImage("data/Textures/purple.png", image, errorMsg)) << errorMsg;
+    EXPECT_EQ(512, image.width);
+    EXPECT_EQ(512, image.height);
+    bool opaque = true;
+    for (size_t i = 3; i < image.data.size(); i += 4)
+        opaque = opaque && image.data[i] == 0xff;
+    EXPECT_TRUE(opaque); // RGB gets an opaque alpha channel
+
+    ASSERT_TRUE(loadImage("data/Textures/soccerball.png", image, errorMsg)) << errorMsg;
+    EXPECT_EQ(256, image.width);
+    EXPECT_EQ(256, image.height);
+    EXPECT_EQ(0, image.data[3]); // the corner outside the ball is transparent
+
+    ASSERT_TRUE(loadImage("data/Textures/GeneticaTextures/Lunar Target.jpg", image, errorMsg)) << errorMsg;
+    EXPECT_EQ(512, image.width);
+    EXPECT_EQ(512, image.height);
+    EXPECT_EQ(0xff, image.data[3]);
+}
+
+TEST(TextureDecoderTest, ThreadsDecodeTheSameAsOneThread)
+{
+    const char* fileNames[] = { "data/Textures/purple.png", "data/Textures/soccerball.png",
+                                "data/Textures/tree.png", "data/Textures/GeneticaTextures/Lunar Target.jpg" };
+    LoadTextureInfo info;
+    info.loadMipmaps = true;
+    info.wrapModeX = WrapClamp;
+    info.wrapModeY = WrapClamp;
+    info.quality = QualityBest;
+    info.scale = 1.0f;
+    std::vector<DecodedTexture> textures1, textures4;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        textures1.push_back(DecodedTexture(fileNames[i], fileNames[i], info));
+        textures4.push_back(DecodedTexture(fileNames[i], fileNames[i], info));
+    }
+    TextureDecoder decoder1 (textures1, 2048, 1);
+    TextureDecoder decoder4 (textures4, 2048, 4);
+    for (size_t i = 0; i < textures1.size(); ++i)
+    {
+        ASSERT_TRUE(decoder1.waitFor(i).success) << textures1[i].errorMsg;
+        ASSERT_TRUE(decoder4.waitFor(i).success) << textures4[i].errorMsg;
+        ASSERT_EQ(textures1[i].levels.size(), textures4[i].levels.size());
+        EXPECT_TRUE(textures1[i].levels[0].data == textures4[i].levels[0].data);
+    }
+}